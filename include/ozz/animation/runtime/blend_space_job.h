@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_BLEND_SPACE_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_BLEND_SPACE_JOB_H_
+
+#include "ozz/base/maths/vec_float.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+// ozz::animation::BlendSpaceJob computes the blending weight of a set of
+// clips (animations), laid out in a 1D or 2D parameter space, for a given
+// parameter value. This is typically used for locomotion, where clips are
+// positioned according to their speed and direction.
+// Weights are computed using gradient band interpolation in cartesian space
+// (Johansen 2009, "Automated semi-procedural animation for character
+// locomotion"). It doesn't require any triangulation of the space, can be used
+// with any number of clips, and degenerates to linear interpolation between
+// the 2 closest clips in the 1D case (all sample positions y set to 0).
+// Weights are normalized, so they can be used directly as BlendingJob layer
+// weights. Clips are expected to be sampled at the same time ratio, which
+// keeps them synchronized. The blended duration can be outputted so that
+// ratio can be advanced at a rate that matches blended clips.
+// Weights lower than the threshold are culled (set to 0) and the remaining ones
+// are re-normalized, so that negligible clips don't need to be sampled at
+// all. Note that BlendingJob already skips layers whose weight is 0.
+// The job does not owned any buffers (input/output) and will thus not delete
+// them during job's destruction.
+struct BlendSpaceJob {
+  // Default constructor, initializes default values.
+  BlendSpaceJob();
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // -if samples range is empty.
+  // -if weights range is smaller than samples range.
+  // -if durations range is not empty and is smaller than samples range.
+  // -if threshold isn't in range [0,1[.
+  bool Validate() const;
+
+  // Runs job's weights computation task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Blend space parameter, for which weights are computed. Parameter can be
+  // outside of the area covered by the samples, in which case the closest
+  // samples are used.
+  math::Float2 parameter;
+
+  // Positions of the clips in the blend space. There must be at least one
+  // clip. y components must be 0 for 1D blend spaces.
+  // Samples position should be unique. Samples at the same position are not
+  // constraining each other, meaning they will share the same weight.
+  span<const math::Float2> samples;
+
+  // Normalized weights lower than this threshold are set to 0 (culled), and
+  // the remaining weights are re-normalized. The clip with the highest weight
+  // is never culled. Must be in range [0,1[. Default value is 0.05.
+  float threshold;
+
+  // Optional durations of the clips, used to compute the blended duration.
+  span<const float> durations;
+
+  // Job output.
+  // Normalized weight of each clip, 0 for culled ones. Must be at least as big
+  // as the samples range.
+  span<float> weights;
+
+  // Optional output duration, computed as the weighted average of the clips
+  // duration (after culling). Ratio of all clips should be advanced by
+  // delta_time / duration in order to keep clips synchronized. Requires
+  // durations to be specified.
+  float* duration;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_BLEND_SPACE_JOB_H_
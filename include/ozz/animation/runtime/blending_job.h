@@ -65,6 +65,7 @@ struct BlendingJob {
   // -if any buffer (including layers' content : transform, joint weights...) is
   // smaller than the bind pose buffer.
   // -if the threshold value is less than or equal to 0.f.
+  // -if dirty range isn't empty and is too small.
   bool Validate() const;
 
   // Runs job's blending task.
@@ -132,6 +133,18 @@ struct BlendingJob {
   // Must be at least as big as the bind pose buffer, but only the number of
   // transforms defined by the bind pose buffer size will be processed.
   span<ozz::math::SoaTransform> output;
+
+  // Optional dirty bits output, one bit per SoaTransform of the bind pose range
+  // (bit i & 7 of byte i / 8), so it must contain at least
+  // (bind_pose.size() + 7) / 8 bytes.
+  // The bit of a SoaTransform is set if the newly blended value differs from
+  // the one that was in the output range. Other bits are left unchanged, so
+  // they can be accumulated with the ones set by other jobs, and cleared by the
+  // user once consumed. Note that the output must be initialized, or all dirty
+  // bits must be set, the first time the job is run.
+  // Transforms are blended by chunks when dirty bits are requested, so that
+  // previous values can be compared.
+  span<uint8_t> dirty;
 };
 }  // namespace animation
 }  // namespace ozz
@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_INERTIALIZATION_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_INERTIALIZATION_JOB_H_
+
+#include "ozz/base/maths/soa_float.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+
+// Forward declaration of math structures.
+namespace math {
+struct SoaTransform;
+}
+
+namespace animation {
+
+// Stores, for 4 joints (SoA), the offsets between the source and the target
+// poses of a transition, along with the speed at which they were changing when
+// the transition started. It is filled by the InertializationCaptureJob and
+// consumed by the InertializationJob.
+// Rotation offsets are stored as the vector part (x, y, z) of the quaternion
+// that rotates target to source, with a positive w. This representation can be
+// decayed and extrapolated linearly, without requiring any trigonometric
+// function.
+struct SoaInertializationOffset {
+  math::SoaFloat3 translation;
+  math::SoaFloat3 translation_velocity;
+  math::SoaFloat3 rotation;
+  math::SoaFloat3 rotation_velocity;
+  math::SoaFloat3 scale;
+  math::SoaFloat3 scale_velocity;
+};
+
+// ozz::animation::InertializationCaptureJob is the first stage of an
+// inertialized transition. Inertialization is an alternative to cross fading
+// (blending source and target animations for the whole transition time), where
+// only the target animation needs to be sampled. The difference between the
+// source and the target poses (and its velocity) is captured once when the
+// transition starts, and is then decayed onto the target pose by the
+// InertializationJob every frame, until it reaches zero.
+// This job computes the offsets from the last two poses of the source (as
+// outputted by the previous frames), and from the target pose at the
+// beginning of the transition. Target velocity can optionally be taken into
+// account by providing target pose of the previous frame too.
+// The job does not owned any buffers (input/output) and will thus not delete
+// them during job's destruction.
+struct InertializationCaptureJob {
+  // Default constructor, initializes default values.
+  InertializationCaptureJob();
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // -if delta_time is less than or equal to 0.
+  // -if target range is empty.
+  // -if any other range is smaller than target range, previous_target being
+  // optional.
+  bool Validate() const;
+
+  // Runs job's capture task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Time elapsed (in seconds) between previous_source and source poses. It's
+  // used to compute offsets velocity. Must be greater than 0.
+  float delta_time;
+
+  // Source pose, aka the last local-space pose of the animation the
+  // transition comes from.
+  span<const math::SoaTransform> source;
+
+  // Source pose of the previous frame, delta_time before source.
+  span<const math::SoaTransform> previous_source;
+
+  // Target pose, aka the first local-space pose of the animation the
+  // transition goes to. The size of this buffer defines the number of soa
+  // transforms to process. All other buffers should be at least as big.
+  span<const math::SoaTransform> target;
+
+  // Optional target pose delta_time before target. Target is considered
+  // static if this range is empty.
+  span<const math::SoaTransform> previous_target;
+
+  // Job output.
+  // The range of offsets to be filled during job execution.
+  span<SoaInertializationOffset> offsets;
+};
+
+// ozz::animation::InertializationJob applies to the target pose the offsets
+// captured by an InertializationCaptureJob at the beginning of a transition,
+// once decayed according to the time elapsed since then. Offsets are decayed
+// using a critically damped spring, which preserves source pose and velocity
+// continuity when the transition starts, and converges smoothly to the target
+// pose without overshooting (at least when offsets velocity doesn't drive the
+// motion away from the target).
+// Decay coefficients are computed once per job, and then applied to all joints
+// using SoA operations. The cost of this job is a fraction of the cost of
+// sampling and blending the source animation during a cross fade. Once time is
+// a few times greater than the halflife, offsets are negligible and the job
+// doesn't need to be executed anymore.
+// The job does not owned any buffers (input/output) and will thus not delete
+// them during job's destruction.
+struct InertializationJob {
+  // Default constructor, initializes default values.
+  InertializationJob();
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // -if halflife is less than or equal to 0.
+  // -if time is negative.
+  // -if target range is empty.
+  // -if offsets or output ranges are smaller than target range.
+  bool Validate() const;
+
+  // Runs job's inertialization task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Time (in seconds) elapsed since the beginning of the transition, aka since
+  // offsets were captured. Must be positive.
+  float time;
+
+  // Time (in seconds) it takes for an offset with no initial velocity to decay
+  // to half of its initial value. Must be greater than 0. Default value is .1.
+  float halflife;
+
+  // Offsets captured at the beginning of the transition.
+  span<const SoaInertializationOffset> offsets;
+
+  // Target pose, aka the current local-space pose of the animation the
+  // transition goes to. The size of this buffer defines the number of soa
+  // transforms to process.
+  span<const math::SoaTransform> target;
+
+  // Job output.
+  // The range of local-space transforms to be filled during job execution.
+  // Output can be the same range as the target.
+  span<math::SoaTransform> output;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_INERTIALIZATION_JOB_H_
@@ -38,7 +38,9 @@ namespace math {
 struct SoaTransform;
 }
 namespace math {
+struct Float3x4;
 struct Float4x4;
+struct SoaFloat4x4;
 }
 
 namespace animation {
@@ -55,6 +57,13 @@ class Skeleton;
 // ordered like skeleton's joints. Output are matrices, because the combination
 // of affine transformations can contain shearing or complex transformation
 // that cannot be represented as Transform object.
+// Output matrices can alternatively be written in SoA format (4 joints per
+// SoaFloat4x4), for consumers that process joints 4 at a time (bounds,
+// skinning palettes...). This skips the transposition of the whole pose to AoS
+// format, and back to SoA format in the consumer.
+// They can also be written as affine 3x4 matrices, which are 25% smaller than
+// 4x4 ones and cheaper to concatenate. This saves memory bandwidth for large
+// skeletons, and they can be used as is by the SkinningJob.
 struct LocalToModelJob {
   // Default constructor, initializes default values.
   LocalToModelJob();
@@ -64,7 +73,11 @@ struct LocalToModelJob {
   // -if the size of the input is smaller than the skeleton's number of joints.
   // Note that this input has a SoA format.
   // -if the size of of the output is smaller than the skeleton's number of
-  // joints.
+  // joints, or if soa_output is used and its size is smaller than the
+  // skeleton's number of SoA joints, or if affine_output is used and its size
+  // is smaller than the skeleton's number of joints.
+  // -if dirty range isn't empty and is smaller than one bit per SoA joint.
+  // -if specialization is used and wasn't generated for skeleton's hierarchy.
   bool Validate() const;
 
   // Runs job's local-to-model task.
@@ -107,13 +120,70 @@ struct LocalToModelJob {
   // Default value is false.
   bool from_excluded;
 
+  // Enables depth ordered evaluation, using skeleton's joints_by_depth()
+  // layout. Parents of a depth level being all computed by previous levels,
+  // joints of a level are processed 4 at a time in SoA. This can only benefit
+  // very wide hierarchies (many siblings per level, like facial rigs), deep
+  // hierarchies are faster with the default order. It should be profiled
+  // before being enabled.
+  // It's only used when the whole hierarchy is updated (default "from" and
+  // "to") to the default AoS output, otherwise joints are processed in order.
+  // Default value is false.
+  bool depth_ordered;
+
+  // Skeleton specialized hierarchy evaluation, as generated by skel2cpp tool
+  // for a fixed rig. The generated function is straight-line code with
+  // constant parent indices, which the compiler can schedule freely.
+  struct Specialization {
+    // The joint hierarchy the function was generated for, which must match
+    // job's skeleton one.
+    span<const int16_t> joint_parents;
+
+    // Computes model-space matrices of all joints from local transforms.
+    void (*function)(const ozz::math::SoaTransform* _input,
+                     const ozz::math::Float4x4& _root,
+                     ozz::math::Float4x4* _output);
+  };
+
+  // Optional specialization, default nullptr. It's only used when the whole
+  // hierarchy is updated to the default AoS output, without dirty bits.
+  // Results are the same as the generic evaluation.
+  const Specialization* specialization;
+
   // The input range that store local transforms.
   span<const ozz::math::SoaTransform> input;
 
+  // Optional dirty bits, one bit per SoaTransform of the input range (bit
+  // i & 7 of byte i / 8), as output by SamplingJob and BlendingJob. When not
+  // empty, only joints whose SoaTransform is dirty, and their children, are
+  // updated. The output range must then contain previously computed matrices,
+  // as other joints are left unchanged. Dirty bits aren't cleared by the job.
+  // Roots and "from" joint children are considered to have an unchanged parent
+  // matrix, so their bits must be set if the root matrix or "from" model-space
+  // matrix changed.
+  // It's only used with the default AoS output, and takes precedence over
+  // depth_ordered option.
+  span<const uint8_t> dirty;
+
   // Job output.
 
   // The output range to be filled with model-space matrices.
+  // Ignored if soa_output or affine_output isn't empty.
   span<ozz::math::Float4x4> output;
+
+  // Optional output range to be filled with model-space matrices in SoA
+  // format, 4 joints per SoaFloat4x4, ordered like skeleton's joints. It's used
+  // instead of output when not empty.
+  // SoA elements are computed at once when their 4 joints are updated and
+  // their parents belong to previous SoA elements, otherwise joints are
+  // updated one by one. Padding joints of the last SoA element are left
+  // unchanged.
+  span<ozz::math::SoaFloat4x4> soa_output;
+
+  // Optional output range to be filled with affine model-space matrices. It's
+  // used instead of output when not empty (and soa_output is empty). Note that
+  // the root matrix must be affine, as its last row is ignored.
+  span<ozz::math::Float3x4> affine_output;
 };
 }  // namespace animation
 }  // namespace ozz
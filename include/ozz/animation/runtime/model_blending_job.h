@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_MODEL_BLENDING_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_MODEL_BLENDING_JOB_H_
+
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+// ozz::animation::ModelBlendingJob blends (mixes) multiple model-space poses,
+// according to their respective weight, into one output model-space pose.
+// This is the model-space counterpart of BlendingJob, used for example to blend
+// physics (ragdoll) poses with animated poses, which are both expressed in
+// model-space. Blending is performed on the translation, rotation (quaternion)
+// and scale components of the matrices, which are decomposed 4 at a time using
+// SoA maths. Input matrices are thus expected to be affine and to have no
+// shearing, as LocalToModelJob outputs.
+// The number of matrices/joints blended by the job is defined by the number of
+// matrices of the bind pose. This means that all buffers must be at least as
+// big as the bind pose buffer.
+// Partial blending is supported through optional per joint weights, specified
+// in SoA format (one SimdFloat4 per group of 4 joints), like BlendingJob.
+// The job does not owned any buffers (input/output) and will thus not delete
+// them during job's destruction.
+struct ModelBlendingJob {
+  // Default constructor, initializes default values.
+  ModelBlendingJob();
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // -if bind pose range is empty.
+  // -if any buffer (including layers' content : transform, joint weights...) is
+  // smaller than the bind pose buffer. Note that joint weights are in SoA
+  // format, so they are compared to the number of SoA bind pose joints.
+  // -if the threshold value is less than or equal to 0.f.
+  bool Validate() const;
+
+  // Runs job's blending task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Defines a layer of blending input data (model-space matrices) and
+  // parameters (weights).
+  struct Layer {
+    // Default constructor, initializes default values.
+    Layer();
+
+    // Blending weight of this layer. Negative values are considered as 0.
+    // Normalization is performed during the blending stage so weight can be in
+    // any range, even though range [0:1] is optimal.
+    float weight;
+
+    // The range [begin,end[ of input layer model-space matrices, usually
+    // outputted from a LocalToModelJob. This range must be at least as big as
+    // the bind pose buffer.
+    span<const math::Float4x4> transform;
+
+    // Optional range [begin,end[ of blending weight for each joint in this
+    // layer, in SoA format.
+    // If empty (default case) then per joint weight blending is disabled. A
+    // valid range is defined as being at least as big as the number of SoA
+    // elements required to store the bind pose (aka (bind_pose.size() + 3) /
+    // 4). When a layer doesn't specifies per joint weights, then it is
+    // implicitly considered as being 1.f.
+    span<const math::SimdFloat4> joint_weights;
+  };
+
+  // The job blends the bind pose to the output when the accumulated weight of
+  // all layers is less than this threshold value.
+  // Must be greater than 0.f.
+  float threshold;
+
+  // Job input layers, can be empty or nullptr.
+  // The range of layers that must be blended.
+  span<const Layer> layers;
+
+  // The skeleton bind pose, in model-space. The size of this buffer defines the
+  // number of matrices to blend.
+  // It is used when the accumulated weight for a joint on all layers is less
+  // than the threshold value, in order to fall back on valid matrices.
+  span<const math::Float4x4> bind_pose;
+
+  // Job output.
+  // The range of output model-space matrices to be filled with blended layer
+  // matrices during job execution.
+  // Must be at least as big as the bind pose buffer, but only the number of
+  // matrices defined by the bind pose buffer size will be processed.
+  span<math::Float4x4> output;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_MODEL_BLENDING_JOB_H_
@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_MODEL_TO_LOCAL_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_MODEL_TO_LOCAL_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+
+// Forward declaration math structures.
+namespace math {
+struct SoaTransform;
+}
+namespace math {
+struct Float4x4;
+}
+
+namespace animation {
+
+// Forward declares the Skeleton object used to describe joint hierarchy.
+class Skeleton;
+
+// Computes local-space SoaTransform from model-space joint matrices. This is
+// the counterpart of LocalToModelJob, used to feed back model-space poses (IK,
+// physics, retargeting...) to local-space jobs like the BlendingJob.
+// This job uses the skeleton to define joints parent-child hierarchy. Each
+// joint local transform is computed from the inverse of its parent model-space
+// matrix, multiplied by its own model-space matrix. Joints are processed 4 at a
+// time, using SoA matrix inversion and decomposition. Since joints are
+// independent, the job doesn't need to traverse the hierarchy in order.
+// Job input is an array of matrices (in model-space), ordered like skeleton's
+// joints. Matrices are expected to be affine and to have no shearing, as
+// LocalToModelJob outputs when there's no non-uniform scale in the hierarchy.
+// Job output is an array of SoaTransform objects (in local-space), ordered like
+// skeleton's joints. Output SoA transforms that aren't mapped to a joint (the
+// last SoA element padding) are set to identity.
+struct ModelToLocalJob {
+  // Default constructor, initializes default values.
+  ModelToLocalJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any input pointer, including ranges, is nullptr.
+  // -if the size of the input is smaller than the skeleton's number of joints.
+  // -if the size of of the output is smaller than the skeleton's number of
+  // joints. Note that this output has a SoA format.
+  bool Validate() const;
+
+  // Runs job's model-to-local task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if job is not valid. See Validate() function.
+  bool Run() const;
+
+  // Job input.
+
+  // The Skeleton object describing the joint hierarchy used for model to
+  // local space conversion.
+  const Skeleton* skeleton;
+
+  // The root matrix that was multiplied to every model-space matrices, default
+  // nullptr means an identity matrix. This must be the same matrix as the one
+  // used by the LocalToModelJob, so that skeleton root joints local transforms
+  // are computed relatively to it.
+  const ozz::math::Float4x4* root;
+
+  // The input range that store model-space matrices.
+  span<const ozz::math::Float4x4> input;
+
+  // Job output.
+
+  // The output range to be filled with local-space transforms.
+  span<ozz::math::SoaTransform> output;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_MODEL_TO_LOCAL_JOB_H_
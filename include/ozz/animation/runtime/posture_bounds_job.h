@@ -0,0 +1,91 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_POSTURE_BOUNDS_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_POSTURE_BOUNDS_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+
+// Forward declaration math structures.
+namespace math {
+struct Box;
+struct Float4x4;
+struct SoaFloat4x4;
+}  // namespace math
+
+namespace animation {
+
+// Forward declares the Skeleton object used to define the number of joints.
+class Skeleton;
+
+// Computes the axis aligned bounding box of a posture, aka the box that
+// contains all joints model-space positions (matrices translation).
+// Model-space matrices can be provided in AoS (Float4x4) or SoA (SoaFloat4x4)
+// format, as output by LocalToModelJob output or soa_output. SoA input is
+// processed 4 joints at a time without any transposition.
+struct PostureBoundsJob {
+  // Default constructor, initializes default values.
+  PostureBoundsJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if skeleton or output pointer is nullptr.
+  // -if the size of the input is smaller than the skeleton's number of joints,
+  // or if soa_input is used and its size is smaller than the skeleton's number
+  // of SoA joints.
+  bool Validate() const;
+
+  // Runs job's bounds computation task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if job is not valid. See Validate() function.
+  bool Run() const;
+
+  // Job input.
+
+  // The Skeleton object that defines the number of joints to process.
+  const Skeleton* skeleton;
+
+  // The input range of model-space matrices.
+  // Ignored if soa_input isn't empty.
+  span<const ozz::math::Float4x4> input;
+
+  // Optional input range of model-space matrices in SoA format, 4 joints per
+  // SoaFloat4x4. It's used instead of input when not empty. Padding joints of
+  // the last SoA element are ignored.
+  span<const ozz::math::SoaFloat4x4> soa_input;
+
+  // Job output.
+
+  // The output box. It's set to an invalid box if the skeleton has no joint.
+  ozz::math::Box* output;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_POSTURE_BOUNDS_JOB_H_
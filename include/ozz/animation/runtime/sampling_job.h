@@ -62,6 +62,7 @@ struct SamplingJob {
   // Validates job parameters. Returns true for a valid job, or false otherwise:
   // -if any input pointer is nullptr
   // -if output range is invalid.
+  // -if dirty range isn't empty and is too small.
   bool Validate() const;
 
   // Runs job's sampling task.
@@ -90,6 +91,18 @@ struct SamplingJob {
   // If there are more joints in the animation, then the last joints are not
   // sampled.
   span<ozz::math::SoaTransform> output;
+
+  // Optional dirty bits output, one bit per SoaTransform of the output range
+  // (bit i & 7 of byte i / 8), so it must contain at least
+  // (num_soa_tracks + 7) / 8 bytes.
+  // The bit of a SoaTransform is set if the newly sampled value differs from
+  // the one that was in the output range. Other bits are left unchanged, so
+  // bits set by other jobs or by the user (for IK corrections...) are
+  // accumulated. They're meant to be cleared by the user once consumed, by the
+  // LocalToModelJob for example.
+  // Note that the output must be initialized, or all dirty bits must be set,
+  // the first time the job is run.
+  span<uint8_t> dirty;
 };
 
 namespace internal {
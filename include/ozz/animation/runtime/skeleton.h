@@ -104,6 +104,19 @@ class Skeleton {
     return span<const char* const>(joint_names_.begin(), joint_names_.end());
   }
 
+  // Returns joint indices sorted by depth in the hierarchy: roots first, then
+  // their children and so on. Joints of the same depth level are sorted by
+  // index. As parents of a level all belong to previous levels, all joints of a
+  // level can be processed at once (see LocalToModelJob::depth_ordered).
+  // This layout isn't serialized, it's derived from joint parents when the
+  // skeleton is built or loaded.
+  span<const int16_t> joints_by_depth() const { return joints_by_depth_; }
+
+  // Returns the offset of each depth level in joints_by_depth() range. Joints
+  // of level i are in range [depth_offsets()[i], depth_offsets()[i + 1]), so
+  // the number of levels is depth_offsets().size() - 1.
+  span<const int16_t> depth_offsets() const { return depth_offsets_; }
+
   // Serialization functions.
   // Should not be called directly but through io::Archive << and >> operators.
   void Save(ozz::io::OArchive& _archive) const;
@@ -119,6 +132,9 @@ class Skeleton {
   char* Allocate(size_t _char_count, size_t _num_joints);
   void Deallocate();
 
+  // Computes joints_by_depth_ and depth_offsets_ from joint parents.
+  void BuildDepthLayout();
+
   // SkeletonBuilder class is allowed to instantiate an Skeleton.
   friend class offline::SkeletonBuilder;
 
@@ -133,6 +149,10 @@ class Skeleton {
 
   // Stores the name of every joint in an array of c-strings.
   span<char*> joint_names_;
+
+  // Joint indices sorted by depth level, and offsets of each level.
+  span<int16_t> joints_by_depth_;
+  span<int16_t> depth_offsets_;
 };
 }  // namespace animation
 
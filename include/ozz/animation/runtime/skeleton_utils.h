@@ -29,6 +29,7 @@
 #define OZZ_OZZ_ANIMATION_RUNTIME_SKELETON_UTILS_H_
 
 #include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/transform.h"
 
 #include <cassert>
@@ -85,6 +86,43 @@ inline _Fct IterateJointsDFReverse(const Skeleton& _skeleton, _Fct _fct) {
   }
   return _fct;
 }
+
+// Describes a range of joints to update with a LocalToModelJob. "from" and "to"
+// are meant to be used as the job parameters of the same name, "from_excluded"
+// being false.
+struct JointRange {
+  int from;
+  int to;
+};
+
+// Partition of a skeleton hierarchy, allowing to update a large hierarchy with
+// multiple LocalToModelJob, run by multiple threads. See PartitionHierarchy().
+struct HierarchyPartition {
+  // Ranges of joints that are ancestors of the subtrees. They must be updated
+  // first, sequentially and in order.
+  ozz::vector<JointRange> ancestors;
+
+  // Ranges of independent subtrees, in depth-first order. Once ancestors are
+  // updated, subtrees can be updated in any order, by any thread.
+  ozz::vector<JointRange> subtrees;
+
+  // Groups consecutive subtrees in tasks with a similar number of joints, as
+  // subtrees can be very small in wide hierarchies. Task i is made of subtrees
+  // [tasks[i], tasks[i + 1][, so there's one more element than tasks.
+  ozz::vector<int> tasks;
+};
+
+// Partitions _skeleton hierarchy for a parallel update with LocalToModelJob.
+// Subtrees that contain at most num_joints / _num_tasks joints are split from
+// their ancestors. Ancestors are updated first, then every subtree can be
+// updated concurrently as its parent is an ancestor (or the root matrix).
+// Each joint is updated once, with the same computations as a single job, so
+// results are exactly the same as updating the whole hierarchy at once.
+// Note that LocalToModelJob dirty bits can't be used, as updated ancestors
+// aren't known when subtrees are updated.
+// Partition only depends on the skeleton, so it should be computed once.
+void PartitionHierarchy(const Skeleton& _skeleton, int _num_tasks,
+                        HierarchyPartition* _partition);
 }  // namespace animation
 }  // namespace ozz
 #endif  // OZZ_OZZ_ANIMATION_RUNTIME_SKELETON_UTILS_H_
@@ -0,0 +1,128 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_TRACK_BATCH_SAMPLING_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_TRACK_BATCH_SAMPLING_JOB_H_
+
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_sampling_job.h"
+
+namespace ozz {
+namespace animation {
+
+namespace internal {
+
+// TrackBatchSamplingJob internal implementation. See *TrackBatchSamplingJob
+// for more details.
+template <typename _Track>
+struct TrackBatchSamplingJob {
+  typedef typename _Track::ValueType ValueType;
+
+  TrackBatchSamplingJob();
+
+  // Validates all parameters:
+  // - all tracks must be valid (non nullptr).
+  // - results must be big enough to store a value for every track.
+  // - caches must be empty or big enough to store a cache for every track.
+  bool Validate() const;
+
+  // Validates and executes sampling.
+  bool Run() const;
+
+  // Ratio used to sample all tracks, clamped in range [0,1] before job
+  // execution.
+  float ratio;
+
+  // Tracks to sample.
+  span<const _Track* const> tracks;
+
+  // Optional caches, one per track. Can be empty (default). They speed up
+  // sampling tracks forward, see TrackSamplingCache.
+  span<TrackSamplingCache> caches;
+
+  // Job output, one value per track, in the same order as tracks.
+  span<ValueType> results;
+};
+
+// TrackMultiSamplingJob internal implementation. See *TrackMultiSamplingJob
+// for more details.
+template <typename _Track>
+struct TrackMultiSamplingJob {
+  typedef typename _Track::ValueType ValueType;
+
+  TrackMultiSamplingJob();
+
+  // Validates all parameters:
+  // - track must be valid (non nullptr).
+  // - results must be big enough to store a value for every ratio.
+  bool Validate() const;
+
+  // Validates and executes sampling.
+  bool Run() const;
+
+  // Ratios used to sample the track, each clamped in range [0,1] before job
+  // execution. Ratios don't need to be sorted.
+  span<const float> ratios;
+
+  // Track to sample.
+  const _Track* track;
+
+  // Job output, one value per ratio, in the same order as ratios.
+  span<ValueType> results;
+};
+}  // namespace internal
+
+// Track batch sampling jobs sample many tracks of the same type at a single
+// ratio, typically all user-channel tracks attached to an animation. Compared
+// to running a TrackSamplingJob per track, validation is done once per batch
+// and interpolation is processed with SIMD instructions, 4 tracks at a time.
+// Results are equivalent to TrackSamplingJob ones.
+struct FloatTrackBatchSamplingJob
+    : public internal::TrackBatchSamplingJob<FloatTrack> {};
+struct Float2TrackBatchSamplingJob
+    : public internal::TrackBatchSamplingJob<Float2Track> {};
+struct Float3TrackBatchSamplingJob
+    : public internal::TrackBatchSamplingJob<Float3Track> {};
+struct Float4TrackBatchSamplingJob
+    : public internal::TrackBatchSamplingJob<Float4Track> {};
+
+// Track multi sampling jobs sample a single track at many ratios, typically
+// for a crowd of characters playing the same animation at different times.
+// Interpolation is processed with SIMD instructions, 4 ratios at a time.
+// Results are equivalent to TrackSamplingJob ones.
+struct FloatTrackMultiSamplingJob
+    : public internal::TrackMultiSamplingJob<FloatTrack> {};
+struct Float2TrackMultiSamplingJob
+    : public internal::TrackMultiSamplingJob<Float2Track> {};
+struct Float3TrackMultiSamplingJob
+    : public internal::TrackMultiSamplingJob<Float3Track> {};
+struct Float4TrackMultiSamplingJob
+    : public internal::TrackMultiSamplingJob<Float4Track> {};
+
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_TRACK_BATCH_SAMPLING_JOB_H_
@@ -33,6 +33,47 @@
 namespace ozz {
 namespace animation {
 
+class TrackSamplingCache;
+
+namespace internal {
+// Finds the index of the first keyframe whose ratio is greater than _ratio,
+// so that _ratio is between this keyframe and the previous one. Returns
+// _ratios.size() if there's none. Optional _cache is used as a starting point
+// and updated with the new keyframe.
+size_t SearchTrackKey(span<const float> _ratios, float _ratio,
+                      const void* _track, TrackSamplingCache* _cache);
+}  // namespace internal
+
+// Declares the cache object used by TrackSamplingJob to take advantage of the
+// frame coherency of track sampling. It remembers the keyframe found by the
+// last sampling, so that sampling forward (from a frame to the next) steps a
+// few keyframes from there instead of searching the whole track. Backward
+// sampling and jumps fall back to a binary search.
+// A cache is bound to the track it last sampled, and is automatically reset
+// when used with another track. Like SamplingCache, this relies on the track
+// address, so it's recommended to Invalidate() a cache if its track is
+// destroyed.
+class TrackSamplingCache {
+ public:
+  // Constructs an invalid cache.
+  TrackSamplingCache();
+
+  // Invalidates the cache.
+  void Invalidate();
+
+ private:
+  friend size_t internal::SearchTrackKey(span<const float> _ratios,
+                                         float _ratio, const void* _track,
+                                         TrackSamplingCache* _cache);
+
+  // The track this cache refers to. nullptr means that the cache is invalid.
+  const void* track_;
+
+  // Index of the first keyframe whose ratio is greater than the last sampled
+  // ratio.
+  size_t key_;
+};
+
 namespace internal {
 
 // TrackSamplingJob internal implementation. See *TrackSamplingJob for more
@@ -57,6 +98,9 @@ struct TrackSamplingJob {
   // Track to sample.
   const _Track* track;
 
+  // Optional cache, default nullptr. It speeds up sampling a track forward.
+  TrackSamplingCache* cache;
+
   // Job output.
   typename _Track::ValueType* result;
 };
@@ -262,6 +262,19 @@ inline void ExpectTrue(bool _b) { EXPECT_TRUE(_b); }
                                                                               \
   } while (void(0), 0)
 
+// Macro for testing ozz::math::Float3x4 rows with x, y, z, w float values.
+#define EXPECT_FLOAT3x4_EQ(_expected, _x0, _x1, _x2, _x3, _y0, _y1, _y2, _y3, \
+                           _z0, _z1, _z2, _z3)                                \
+                                                                              \
+  do {                                                                        \
+    SCOPED_TRACE("");                                                         \
+    const ozz::math::Float3x4 expected(_expected);                            \
+    _IMPL_EXPECT_SIMDFLOAT_EQ(expected.rows[0], _x0, _x1, _x2, _x3);          \
+    _IMPL_EXPECT_SIMDFLOAT_EQ(expected.rows[1], _y0, _y1, _y2, _y3);          \
+    _IMPL_EXPECT_SIMDFLOAT_EQ(expected.rows[2], _z0, _z1, _z2, _z3);          \
+                                                                              \
+  } while (void(0), 0)
+
 // Macro for testing ozz::math::simd::SimdQuaternion members with x, y, z, w
 // values.
 #define EXPECT_SIMDQUATERNION_EQ(_expected, _x, _y, _z, _w)    \
@@ -1978,6 +1978,100 @@ OZZ_INLINE ozz::math::Float4x4 operator-(const ozz::math::Float4x4& _a,
         _a.cols[3].z - _b.cols[3].z, _a.cols[3].w - _b.cols[3].w}}};
   return ret;
 }
+
+OZZ_INLINE Float3x4 Float3x4::identity() {
+  const Float3x4 ret = {
+      {{1.f, 0.f, 0.f, 0.f}, {0.f, 1.f, 0.f, 0.f}, {0.f, 0.f, 1.f, 0.f}}};
+  return ret;
+}
+
+OZZ_INLINE Float3x4 Float3x4::FromFloat4x4(const Float4x4& _m) {
+  const Float3x4 ret = {
+      {{_m.cols[0].x, _m.cols[1].x, _m.cols[2].x, _m.cols[3].x},
+       {_m.cols[0].y, _m.cols[1].y, _m.cols[2].y, _m.cols[3].y},
+       {_m.cols[0].z, _m.cols[1].z, _m.cols[2].z, _m.cols[3].z}}};
+  return ret;
+}
+
+OZZ_INLINE Float4x4 ToFloat4x4(const Float3x4& _m) {
+  const Float4x4 ret = {
+      {{_m.rows[0].x, _m.rows[1].x, _m.rows[2].x, 0.f},
+       {_m.rows[0].y, _m.rows[1].y, _m.rows[2].y, 0.f},
+       {_m.rows[0].z, _m.rows[1].z, _m.rows[2].z, 0.f},
+       {_m.rows[0].w, _m.rows[1].w, _m.rows[2].w, 1.f}}};
+  return ret;
+}
+
+OZZ_INLINE Float3x4 RowMultiply(const Float3x4& _m, _SimdFloat4 _v) {
+  const Float3x4 ret = {{{_m.rows[0].x * _v.x, _m.rows[0].y * _v.y,
+                          _m.rows[0].z * _v.z, _m.rows[0].w * _v.w},
+                         {_m.rows[1].x * _v.x, _m.rows[1].y * _v.y,
+                          _m.rows[1].z * _v.z, _m.rows[1].w * _v.w},
+                         {_m.rows[2].x * _v.x, _m.rows[2].y * _v.y,
+                          _m.rows[2].z * _v.z, _m.rows[2].w * _v.w}}};
+  return ret;
+}
+
+OZZ_INLINE ozz::math::SimdFloat4 TransformPoint(const ozz::math::Float3x4& _m,
+                                                ozz::math::_SimdFloat4 _v) {
+  const ozz::math::SimdFloat4 ret = {
+      _m.rows[0].x * _v.x + _m.rows[0].y * _v.y + _m.rows[0].z * _v.z +
+          _m.rows[0].w,
+      _m.rows[1].x * _v.x + _m.rows[1].y * _v.y + _m.rows[1].z * _v.z +
+          _m.rows[1].w,
+      _m.rows[2].x * _v.x + _m.rows[2].y * _v.y + _m.rows[2].z * _v.z +
+          _m.rows[2].w,
+      1.f};
+  return ret;
+}
+
+OZZ_INLINE ozz::math::SimdFloat4 TransformVector(const ozz::math::Float3x4& _m,
+                                                 ozz::math::_SimdFloat4 _v) {
+  const ozz::math::SimdFloat4 ret = {
+      _m.rows[0].x * _v.x + _m.rows[0].y * _v.y + _m.rows[0].z * _v.z,
+      _m.rows[1].x * _v.x + _m.rows[1].y * _v.y + _m.rows[1].z * _v.z,
+      _m.rows[2].x * _v.x + _m.rows[2].y * _v.y + _m.rows[2].z * _v.z, 0.f};
+  return ret;
+}
+
+OZZ_INLINE ozz::math::Float3x4 operator*(const ozz::math::Float3x4& _a,
+                                         const ozz::math::Float3x4& _b) {
+  ozz::math::Float3x4 ret;
+  for (int i = 0; i < 3; ++i) {
+    const ozz::math::SimdFloat4& a = _a.rows[i];
+    const ozz::math::SimdFloat4 row = {
+        a.x * _b.rows[0].x + a.y * _b.rows[1].x + a.z * _b.rows[2].x,
+        a.x * _b.rows[0].y + a.y * _b.rows[1].y + a.z * _b.rows[2].y,
+        a.x * _b.rows[0].z + a.y * _b.rows[1].z + a.z * _b.rows[2].z,
+        a.x * _b.rows[0].w + a.y * _b.rows[1].w + a.z * _b.rows[2].w + a.w};
+    ret.rows[i] = row;
+  }
+  return ret;
+}
+
+OZZ_INLINE ozz::math::Float3x4 operator+(const ozz::math::Float3x4& _a,
+                                         const ozz::math::Float3x4& _b) {
+  const ozz::math::Float3x4 ret = {
+      {{_a.rows[0].x + _b.rows[0].x, _a.rows[0].y + _b.rows[0].y,
+        _a.rows[0].z + _b.rows[0].z, _a.rows[0].w + _b.rows[0].w},
+       {_a.rows[1].x + _b.rows[1].x, _a.rows[1].y + _b.rows[1].y,
+        _a.rows[1].z + _b.rows[1].z, _a.rows[1].w + _b.rows[1].w},
+       {_a.rows[2].x + _b.rows[2].x, _a.rows[2].y + _b.rows[2].y,
+        _a.rows[2].z + _b.rows[2].z, _a.rows[2].w + _b.rows[2].w}}};
+  return ret;
+}
+
+OZZ_INLINE ozz::math::Float3x4 operator-(const ozz::math::Float3x4& _a,
+                                         const ozz::math::Float3x4& _b) {
+  const ozz::math::Float3x4 ret = {
+      {{_a.rows[0].x - _b.rows[0].x, _a.rows[0].y - _b.rows[0].y,
+        _a.rows[0].z - _b.rows[0].z, _a.rows[0].w - _b.rows[0].w},
+       {_a.rows[1].x - _b.rows[1].x, _a.rows[1].y - _b.rows[1].y,
+        _a.rows[1].z - _b.rows[1].z, _a.rows[1].w - _b.rows[1].w},
+       {_a.rows[2].x - _b.rows[2].x, _a.rows[2].y - _b.rows[2].y,
+        _a.rows[2].z - _b.rows[2].z, _a.rows[2].w - _b.rows[2].w}}};
+  return ret;
+}
 }  // namespace math
 }  // namespace ozz
 
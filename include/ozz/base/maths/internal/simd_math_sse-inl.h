@@ -2006,6 +2006,106 @@ OZZ_INLINE ozz::math::Float4x4 operator-(const ozz::math::Float4x4& _a,
        _mm_sub_ps(_a.cols[2], _b.cols[2]), _mm_sub_ps(_a.cols[3], _b.cols[3])}};
   return ret;
 }
+
+OZZ_INLINE Float3x4 Float3x4::identity() {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ffff = _mm_cmpeq_epi32(zero, zero);
+  const __m128i one = _mm_srli_epi32(_mm_slli_epi32(ffff, 25), 2);
+  const __m128i x = _mm_srli_si128(one, 12);
+  const Float3x4 ret = {{_mm_castsi128_ps(x),
+                         _mm_castsi128_ps(_mm_slli_si128(x, 4)),
+                         _mm_castsi128_ps(_mm_slli_si128(x, 8))}};
+  return ret;
+}
+
+OZZ_INLINE Float3x4 Float3x4::FromFloat4x4(const Float4x4& _m) {
+  const __m128 tmp0 = _mm_unpacklo_ps(_m.cols[0], _m.cols[1]);
+  const __m128 tmp1 = _mm_unpacklo_ps(_m.cols[2], _m.cols[3]);
+  const __m128 tmp2 = _mm_unpackhi_ps(_m.cols[0], _m.cols[1]);
+  const __m128 tmp3 = _mm_unpackhi_ps(_m.cols[2], _m.cols[3]);
+  const Float3x4 ret = {{_mm_movelh_ps(tmp0, tmp1), _mm_movehl_ps(tmp1, tmp0),
+                         _mm_movelh_ps(tmp2, tmp3)}};
+  return ret;
+}
+
+OZZ_INLINE Float4x4 ToFloat4x4(const Float3x4& _m) {
+  const __m128 row3 = _mm_set_ps(1.f, 0.f, 0.f, 0.f);
+  const __m128 tmp0 = _mm_unpacklo_ps(_m.rows[0], _m.rows[1]);
+  const __m128 tmp1 = _mm_unpacklo_ps(_m.rows[2], row3);
+  const __m128 tmp2 = _mm_unpackhi_ps(_m.rows[0], _m.rows[1]);
+  const __m128 tmp3 = _mm_unpackhi_ps(_m.rows[2], row3);
+  const Float4x4 ret = {{_mm_movelh_ps(tmp0, tmp1), _mm_movehl_ps(tmp1, tmp0),
+                         _mm_movelh_ps(tmp2, tmp3), _mm_movehl_ps(tmp3, tmp2)}};
+  return ret;
+}
+
+OZZ_INLINE Float3x4 RowMultiply(const Float3x4& _m, _SimdFloat4 _v) {
+  const Float3x4 ret = {{_mm_mul_ps(_m.rows[0], _v), _mm_mul_ps(_m.rows[1], _v),
+                         _mm_mul_ps(_m.rows[2], _v)}};
+  return ret;
+}
+
+namespace internal {
+// Computes the dot products of _v with each row of _m, and returns them in x,
+// y and z components. w component is set to _w.z.
+OZZ_INLINE __m128 Float3x4RowDot(const Float3x4& _m, __m128 _v, __m128 _w) {
+  const __m128 a = _mm_mul_ps(_m.rows[0], _v);
+  const __m128 b = _mm_mul_ps(_m.rows[1], _v);
+  const __m128 c = _mm_mul_ps(_m.rows[2], _v);
+  const __m128 ab = _mm_add_ps(_mm_unpacklo_ps(a, b), _mm_unpackhi_ps(a, b));
+  const __m128 cc = _mm_add_ps(c, OZZ_SHUFFLE_PS1(c, _MM_SHUFFLE(1, 0, 3, 2)));
+  const __m128 abc =
+      _mm_add_ps(_mm_shuffle_ps(ab, cc, _MM_SHUFFLE(1, 0, 1, 0)),
+                 _mm_shuffle_ps(ab, cc, _MM_SHUFFLE(0, 1, 3, 2)));
+  return _mm_movelh_ps(abc, _mm_unpackhi_ps(abc, _w));
+}
+}  // namespace internal
+
+OZZ_INLINE ozz::math::SimdFloat4 TransformPoint(const ozz::math::Float3x4& _m,
+                                                ozz::math::_SimdFloat4 _v) {
+  const __m128 one = _mm_set_ps1(1.f);
+  const __m128 v1 = _mm_movelh_ps(_v, _mm_unpackhi_ps(_v, one));
+  return internal::Float3x4RowDot(_m, v1, one);
+}
+
+OZZ_INLINE ozz::math::SimdFloat4 TransformVector(const ozz::math::Float3x4& _m,
+                                                 ozz::math::_SimdFloat4 _v) {
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 v0 = _mm_movelh_ps(_v, _mm_unpackhi_ps(_v, zero));
+  return internal::Float3x4RowDot(_m, v0, zero);
+}
+
+OZZ_INLINE ozz::math::Float3x4 operator*(const ozz::math::Float3x4& _a,
+                                         const ozz::math::Float3x4& _b) {
+  // Last row of _b being [0 0 0 1], translation (w) of _a rows is only added.
+  const __m128 mask_w = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+  ozz::math::Float3x4 ret;
+  for (int i = 0; i < 3; ++i) {
+    const __m128 a = _a.rows[i];
+    const __m128 xxxx =
+        OZZ_MADD(OZZ_SSE_SPLAT_F(a, 0), _b.rows[0], _mm_and_ps(a, mask_w));
+    const __m128 yyyy = _mm_mul_ps(OZZ_SSE_SPLAT_F(a, 1), _b.rows[1]);
+    const __m128 a12 = OZZ_MADD(OZZ_SSE_SPLAT_F(a, 2), _b.rows[2], yyyy);
+    ret.rows[i] = _mm_add_ps(xxxx, a12);
+  }
+  return ret;
+}
+
+OZZ_INLINE ozz::math::Float3x4 operator+(const ozz::math::Float3x4& _a,
+                                         const ozz::math::Float3x4& _b) {
+  const ozz::math::Float3x4 ret = {
+      {_mm_add_ps(_a.rows[0], _b.rows[0]), _mm_add_ps(_a.rows[1], _b.rows[1]),
+       _mm_add_ps(_a.rows[2], _b.rows[2])}};
+  return ret;
+}
+
+OZZ_INLINE ozz::math::Float3x4 operator-(const ozz::math::Float3x4& _a,
+                                         const ozz::math::Float3x4& _b) {
+  const ozz::math::Float3x4 ret = {
+      {_mm_sub_ps(_a.rows[0], _b.rows[0]), _mm_sub_ps(_a.rows[1], _b.rows[1]),
+       _mm_sub_ps(_a.rows[2], _b.rows[2])}};
+  return ret;
+}
 }  // namespace math
 }  // namespace ozz
 
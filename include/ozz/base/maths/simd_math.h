@@ -1179,6 +1179,54 @@ OZZ_INLINE ozz::math::Float4x4 operator+(const ozz::math::Float4x4& _a,
 // Computes the per element subtraction of two matrices _a and _b.
 OZZ_INLINE ozz::math::Float4x4 operator-(const ozz::math::Float4x4& _a,
                                          const ozz::math::Float4x4& _b);
+
+// Declare the 3x4 affine matrix type. It stores the 3 first rows of an affine
+// Float4x4, whose last row is implicitly [0 0 0 1]. It's 48 bytes instead of
+// 64, which saves memory bandwidth when large arrays of matrices are written
+// and read back (model-space matrices, skinning palettes...).
+// [ m.rows[0].x m.rows[0].y m.rows[0].z m.rows[0].w ]   {v.x}
+// | m.rows[1].x m.rows[1].y m.rows[1].z m.rows[1].w | * {v.y}
+// | m.rows[2].x m.rows[2].y m.rows[2].z m.rows[2].w |   {v.z}
+// [ 0           0           0           1           ]   {v.1}
+struct Float3x4 {
+  // Matrix rows.
+  SimdFloat4 rows[3];
+
+  // Returns the identity matrix.
+  static OZZ_INLINE Float3x4 identity();
+
+  // Returns the 3x4 affine matrix built from the 3 first rows of _m. The last
+  // row of _m is ignored.
+  static OZZ_INLINE Float3x4 FromFloat4x4(const Float4x4& _m);
+};
+
+// Returns the 4x4 matrix equivalent to the affine matrix _m.
+OZZ_INLINE Float4x4 ToFloat4x4(const Float3x4& _m);
+
+// Multiply each row of matrix _m with vector _v.
+OZZ_INLINE Float3x4 RowMultiply(const Float3x4& _m, _SimdFloat4 _v);
+
+// Computes the transformation of a Float3x4 matrix and a point _p.
+// The w component of the returned vector is set to 1.
+OZZ_INLINE ozz::math::SimdFloat4 TransformPoint(const ozz::math::Float3x4& _m,
+                                                ozz::math::_SimdFloat4 _v);
+
+// Computes the transformation of a Float3x4 matrix and a vector _v.
+// The w component of the returned vector is set to 0.
+OZZ_INLINE ozz::math::SimdFloat4 TransformVector(const ozz::math::Float3x4& _m,
+                                                 ozz::math::_SimdFloat4 _v);
+
+// Computes the multiplication of two affine matrices _a and _b.
+OZZ_INLINE ozz::math::Float3x4 operator*(const ozz::math::Float3x4& _a,
+                                         const ozz::math::Float3x4& _b);
+
+// Computes the per element addition of two matrices _a and _b.
+OZZ_INLINE ozz::math::Float3x4 operator+(const ozz::math::Float3x4& _a,
+                                         const ozz::math::Float3x4& _b);
+
+// Computes the per element subtraction of two matrices _a and _b.
+OZZ_INLINE ozz::math::Float3x4 operator-(const ozz::math::Float3x4& _a,
+                                         const ozz::math::Float3x4& _b);
 }  // namespace math
 }  // namespace ozz
 
@@ -269,6 +269,80 @@ OZZ_INLINE SimdFloat4 TransformVector(const SimdQuaternion& _q,
   const SimdFloat4 cross2 = Cross3(_q.xyzw, cross1);
   return _v + cross2 + cross2;
 }
+
+// Declares the dual quaternion type, representing a rigid transformation
+// without scale. The real part is the rotation, and the dual part is half the
+// translation (as a pure quaternion) multiplied by the rotation.
+// Unlike matrices, dual quaternions can be linearly blended without shearing or
+// collapsing the transformation, which is used by dual quaternion skinning.
+struct SimdDualQuaternion {
+  SimdQuaternion real;
+  SimdQuaternion dual;
+
+  // Returns the identity dual quaternion.
+  static OZZ_INLINE SimdDualQuaternion identity() {
+    const SimdDualQuaternion dq = {{simd_float4::w_axis()},
+                                   {simd_float4::zero()}};
+    return dq;
+  }
+
+  // Returns the dual quaternion of the rotation _rotation followed by the
+  // translation _translation. _rotation must be normalized, w component of
+  // _translation is ignored.
+  static OZZ_INLINE SimdDualQuaternion FromAffine(
+      _SimdFloat4 _translation, const SimdQuaternion& _rotation) {
+    const SimdQuaternion translation = {
+        And(_translation, simd_int4::mask_fff0())};
+    const SimdDualQuaternion dq = {
+        _rotation,
+        {(translation * _rotation).xyzw * simd_float4::Load1(.5f)}};
+    return dq;
+  }
+};
+
+// Returns the per element addition of _a and _b, as used to linearly blend
+// dual quaternions.
+OZZ_INLINE SimdDualQuaternion operator+(const SimdDualQuaternion& _a,
+                                        const SimdDualQuaternion& _b) {
+  const SimdDualQuaternion dq = {{_a.real.xyzw + _b.real.xyzw},
+                                 {_a.dual.xyzw + _b.dual.xyzw}};
+  return dq;
+}
+
+// Computes the transformation of a dual quaternion and a vector _v, which is
+// only affected by the rotation part.
+// _dq doesn't need to be normalized, so it can be the result of a linear blend
+// of dual quaternions: the transformation is divided by the squared norm of
+// the real part.
+// w component of the returned vector is undefined.
+OZZ_INLINE SimdFloat4 TransformVector(const SimdDualQuaternion& _dq,
+                                      _SimdFloat4 _v) {
+  const SimdFloat4 r = _dq.real.xyzw;
+  const SimdFloat4 rcp_norm2 = simd_float4::one() / SplatX(Dot4(r, r));
+  const SimdFloat4 cross1 = MAdd(SplatW(r), _v, Cross3(r, _v));
+  const SimdFloat4 cross2 = Cross3(r, cross1);
+  return MAdd(cross2 + cross2, rcp_norm2, _v);
+}
+
+// Computes the transformation of a dual quaternion and a point _p.
+// _dq doesn't need to be normalized, see TransformVector.
+// w component of the returned vector is undefined.
+OZZ_INLINE SimdFloat4 TransformPoint(const SimdDualQuaternion& _dq,
+                                     _SimdFloat4 _p) {
+  // Rotation:    _p + 2 * cross(r.xyz, cross(r.xyz, _p) + r.w * _p)
+  // Translation: 2 * (r.w * d.xyz - d.w * r.xyz + cross(r.xyz, d.xyz))
+  // Both scaled by 1 / |r|^2.
+  const SimdFloat4 r = _dq.real.xyzw;
+  const SimdFloat4 d = _dq.dual.xyzw;
+  const SimdFloat4 rcp_norm2 = simd_float4::one() / SplatX(Dot4(r, r));
+  const SimdFloat4 rw = SplatW(r);
+  const SimdFloat4 cross1 = MAdd(rw, _p, Cross3(r, _p));
+  const SimdFloat4 cross2 = Cross3(r, cross1);
+  const SimdFloat4 translation =
+      NMAdd(SplatW(d), r, MAdd(rw, d, Cross3(r, d)));
+  const SimdFloat4 sum = cross2 + translation;
+  return MAdd(sum + sum, rcp_norm2, _p);
+}
 }  // namespace math
 }  // namespace ozz
 #endif  // OZZ_OZZ_BASE_MATHS_SIMD_QUATERNION_H_
@@ -30,6 +30,7 @@
 
 #include <cassert>
 
+#include "ozz/base/maths/math_constant.h"
 #include "ozz/base/maths/soa_float.h"
 #include "ozz/base/maths/soa_quaternion.h"
 #include "ozz/base/platform.h"
@@ -128,6 +129,35 @@ struct SoaFloat4x4 {
          {_translation.x, _translation.y, _translation.z, one}}};
     return ret;
   }
+
+  // Returns the rigid transformation matrix built from split translation and
+  // rotation (quaternion). This is the unit scale version of FromAffine, which
+  // saves the scale multiplications.
+  static OZZ_INLINE SoaFloat4x4 FromAffine(const SoaFloat3& _translation,
+                                           const SoaQuaternion& _quaternion) {
+    assert(AreAllTrue(IsNormalizedEst(_quaternion)));
+
+    const SimdFloat4 zero = simd_float4::zero();
+    const SimdFloat4 one = simd_float4::one();
+    const SimdFloat4 two = one + one;
+
+    const SimdFloat4 xx = _quaternion.x * _quaternion.x;
+    const SimdFloat4 xy = _quaternion.x * _quaternion.y;
+    const SimdFloat4 xz = _quaternion.x * _quaternion.z;
+    const SimdFloat4 xw = _quaternion.x * _quaternion.w;
+    const SimdFloat4 yy = _quaternion.y * _quaternion.y;
+    const SimdFloat4 yz = _quaternion.y * _quaternion.z;
+    const SimdFloat4 yw = _quaternion.y * _quaternion.w;
+    const SimdFloat4 zz = _quaternion.z * _quaternion.z;
+    const SimdFloat4 zw = _quaternion.z * _quaternion.w;
+
+    const SoaFloat4x4 ret = {
+        {{one - two * (yy + zz), two * (xy + zw), two * (xz - yw), zero},
+         {two * (xy - zw), one - two * (xx + zz), two * (yz + xw), zero},
+         {two * (xz + yw), two * (yz - xw), one - two * (xx + yy), zero},
+         {_translation.x, _translation.y, _translation.z, one}}};
+    return ret;
+  }
 };
 
 // Returns the transpose of matrix _m.
@@ -218,6 +248,100 @@ OZZ_INLINE SoaFloat4x4 Scale(const SoaFloat4x4& _m, const SoaFloat4& _v) {
                             _m.cols[3]}};
   return ret;
 }
+
+// Returns the quaternions that represent the rotations of the 4 orthonormal
+// matrices _m. Translation (4th column) and 4th row are ignored.
+// The quaternion extraction case is selected per matrix, such that the
+// computation is branch free.
+OZZ_INLINE SoaQuaternion ToQuaternion(const SoaFloat4x4& _m) {
+  // Cf From Quaternion to Matrix and Back, J.M.P. van Waveren 2005.
+  const SoaFloat4* cols = _m.cols;
+  const SimdFloat4 one = simd_float4::one();
+  const SimdFloat4 trace = cols[0].x + cols[1].y + cols[2].z;
+
+  // Selects the most stable case for each matrix.
+  const SimdInt4 case_w = CmpGt(trace, simd_float4::zero());
+  const SimdInt4 case_x =
+      And(CmpGt(cols[0].x, cols[1].y), CmpGt(cols[0].x, cols[2].z));
+  const SimdInt4 case_y = CmpGt(cols[1].y, cols[2].z);
+
+  const SimdFloat4 t = Select(
+      case_w, trace + one,
+      Select(case_x, cols[0].x - cols[1].y - cols[2].z + one,
+             Select(case_y, cols[1].y - cols[0].x - cols[2].z + one,
+                    cols[2].z - cols[0].x - cols[1].y + one)));
+  const SimdFloat4 s = RSqrtEstNR(t) * simd_float4::Load1(.5f);
+
+  const SimdFloat4 dx = cols[1].z - cols[2].y;
+  const SimdFloat4 dy = cols[2].x - cols[0].z;
+  const SimdFloat4 dz = cols[0].y - cols[1].x;
+  const SimdFloat4 sxy = cols[0].y + cols[1].x;
+  const SimdFloat4 sxz = cols[2].x + cols[0].z;
+  const SimdFloat4 syz = cols[1].z + cols[2].y;
+
+  const SoaQuaternion ret = {
+      s * Select(case_w, dx, Select(case_x, t, Select(case_y, sxy, sxz))),
+      s * Select(case_w, dy, Select(case_x, sxy, Select(case_y, t, syz))),
+      s * Select(case_w, dz, Select(case_x, sxz, Select(case_y, syz, t))),
+      s * Select(case_w, t, Select(case_x, dx, Select(case_y, dy, dz)))};
+  return ret;
+}
+
+// Decomposes the 4 affine matrices _m into their translation, rotation
+// (quaternion) and scale components. Matrices are expected to have no shearing.
+// Returns a mask where each component is true if its respective matrix could
+// be decomposed, aka has no null scale along any axis. Rotations of the
+// matrices that can't be decomposed are set to identity.
+OZZ_INLINE SimdInt4 ToAffine(const SoaFloat4x4& _m, SoaFloat3* _translation,
+                             SoaQuaternion* _quaternion, SoaFloat3* _scale) {
+  const SimdFloat4 zero = simd_float4::zero();
+  const SimdFloat4 one = simd_float4::one();
+  const SoaFloat4* cols = _m.cols;
+
+  _translation->x = cols[3].x;
+  _translation->y = cols[3].y;
+  _translation->z = cols[3].z;
+
+  // Extracts scale.
+  const SoaFloat3 axes[3] = {{cols[0].x, cols[0].y, cols[0].z},
+                             {cols[1].x, cols[1].y, cols[1].z},
+                             {cols[2].x, cols[2].y, cols[2].z}};
+  const SimdFloat4 sq_scale_x = LengthSqr(axes[0]);
+  const SimdFloat4 sq_scale_y = LengthSqr(axes[1]);
+  const SimdFloat4 sq_scale_z = LengthSqr(axes[2]);
+
+  const SimdFloat4 tolerance =
+      simd_float4::Load1(kOrthogonalisationToleranceSq);
+  const SimdInt4 valid = And(And(CmpGe(sq_scale_x, tolerance),
+                                 CmpGe(sq_scale_y, tolerance)),
+                             CmpGe(sq_scale_z, tolerance));
+
+  // Builds an orthonormal matrix in order to support quaternion extraction,
+  // favoring z axis. Matrices that can't be decomposed use identity axes.
+  const SoaFloat3 x = {Select(valid, axes[0].x, one),
+                       Select(valid, axes[0].y, zero),
+                       Select(valid, axes[0].z, zero)};
+  const SoaFloat3 z = {Select(valid, axes[2].x, zero),
+                       Select(valid, axes[2].y, zero),
+                       Select(valid, axes[2].z, one)};
+  const SoaFloat3 ortho_z = Normalize(z);
+  const SoaFloat3 ortho_y = Normalize(Cross(ortho_z, x));
+  const SoaFloat3 ortho_x = Cross(ortho_y, ortho_z);
+
+  // Get back scale signs in case of reflexions.
+  _scale->x = Xor(Sqrt(sq_scale_x), And(valid, Sign(Dot(ortho_x, axes[0]))));
+  _scale->y = Xor(Sqrt(sq_scale_y), And(valid, Sign(Dot(ortho_y, axes[1]))));
+  _scale->z = Sqrt(sq_scale_z);
+
+  // Extracts quaternion.
+  const SoaFloat4x4 orthonormal = {{{ortho_x.x, ortho_x.y, ortho_x.z, zero},
+                                    {ortho_y.x, ortho_y.y, ortho_y.z, zero},
+                                    {ortho_z.x, ortho_z.y, ortho_z.z, zero},
+                                    {zero, zero, zero, one}}};
+  *_quaternion = ToQuaternion(orthonormal);
+
+  return valid;
+}
 }  // namespace math
 }  // namespace ozz
 
@@ -186,4 +186,15 @@ OZZ_INLINE ozz::math::SimdInt4 operator==(const ozz::math::SoaQuaternion& _a,
   const ozz::math::SimdInt4 w = ozz::math::CmpEq(_a.w, _b.w);
   return ozz::math::And(ozz::math::And(ozz::math::And(x, y), z), w);
 }
+
+// Returns true if each element of _a is different from each element of _b.
+// Uses a bitwise comparison of _a and _b, no tolerance is applied.
+OZZ_INLINE ozz::math::SimdInt4 operator!=(const ozz::math::SoaQuaternion& _a,
+                                          const ozz::math::SoaQuaternion& _b) {
+  const ozz::math::SimdInt4 x = ozz::math::CmpNe(_a.x, _b.x);
+  const ozz::math::SimdInt4 y = ozz::math::CmpNe(_a.y, _b.y);
+  const ozz::math::SimdInt4 z = ozz::math::CmpNe(_a.z, _b.z);
+  const ozz::math::SimdInt4 w = ozz::math::CmpNe(_a.w, _b.w);
+  return ozz::math::Or(ozz::math::Or(ozz::math::Or(x, y), z), w);
+}
 #endif  // OZZ_OZZ_BASE_MATHS_SOA_QUATERNION_H_
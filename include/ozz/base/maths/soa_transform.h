@@ -50,4 +50,22 @@ struct SoaTransform {
 };
 }  // namespace math
 }  // namespace ozz
+
+// Returns true if each element of _a is equal to each element of _b.
+// Uses a bitwise comparison of _a and _b, no tolerance is applied.
+OZZ_INLINE ozz::math::SimdInt4 operator==(const ozz::math::SoaTransform& _a,
+                                          const ozz::math::SoaTransform& _b) {
+  return ozz::math::And(ozz::math::And(_a.translation == _b.translation,
+                                       _a.rotation == _b.rotation),
+                        _a.scale == _b.scale);
+}
+
+// Returns true if each element of _a is different from each element of _b.
+// Uses a bitwise comparison of _a and _b, no tolerance is applied.
+OZZ_INLINE ozz::math::SimdInt4 operator!=(const ozz::math::SoaTransform& _a,
+                                          const ozz::math::SoaTransform& _b) {
+  return ozz::math::Or(ozz::math::Or(_a.translation != _b.translation,
+                                     _a.rotation != _b.rotation),
+                       _a.scale != _b.scale);
+}
 #endif  // OZZ_OZZ_BASE_MATHS_SOA_TRANSFORM_H_
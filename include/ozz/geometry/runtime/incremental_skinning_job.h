@@ -0,0 +1,147 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_GEOMETRY_RUNTIME_INCREMENTAL_SKINNING_JOB_H_
+#define OZZ_OZZ_GEOMETRY_RUNTIME_INCREMENTAL_SKINNING_JOB_H_
+
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/archive_traits.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+
+namespace ozz {
+namespace geometry {
+
+// Describes a range of vertices [begin,end[ of a mesh.
+struct VertexRange {
+  int begin;
+  int end;
+};
+
+// Index of the vertices influenced by each joint of a mesh, as ranges of
+// vertices. It's used by the IncrementalSkinningJob to find the vertices that
+// need to be skinned again when some joints changed. See BuildSkinningIndex().
+// Index only depends on the mesh, so it's meant to be built offline and
+// serialized along with the mesh.
+struct SkinningIndex {
+  SkinningIndex() : vertex_count(0) {}
+
+  // Number of vertices of the indexed mesh.
+  int vertex_count;
+
+  // Ranges of joint i are ranges[joints[i]] to ranges[joints[i + 1]][, so
+  // there's one more element than the number of joints.
+  ozz::vector<int> joints;
+
+  // Sorted and disjoint vertex ranges of each joint.
+  ozz::vector<VertexRange> ranges;
+};
+
+// Builds _index from a mesh joint indices, as provided to the SkinningJob
+// (joint_indices, joint_indices_stride and influences_count). Every vertex
+// that refers to a joint belongs to one of the joint ranges, whatever its
+// weight. Ranges of a joint separated by at most _max_gap vertices are merged,
+// trading a few unnecessarily skinned vertices for fewer ranges. Ranges start
+// and end at even vertices (unless it's the last one), so that they're skinned
+// with bitwise identical results to the whole mesh.
+// Returns false if any index isn't in range [0,_num_joints[, or if arguments
+// are invalid.
+bool BuildSkinningIndex(span<const uint16_t> _joint_indices, size_t _stride,
+                        int _influences_count, int _vertex_count,
+                        int _num_joints, int _max_gap, SkinningIndex* _index);
+
+// Builds _index from a mesh 8 bits joint indices, as provided to the
+// SkinningJob joint_compact_indices. See the 16 bits version above for more
+// details.
+bool BuildSkinningIndex(span<const uint8_t> _joint_indices, size_t _stride,
+                        int _influences_count, int _vertex_count,
+                        int _num_joints, int _max_gap, SkinningIndex* _index);
+
+// Skins only the vertices influenced by changed joints, leaving other vertices
+// output unchanged. It's meant for mostly static characters, where only a few
+// joints move every frame (facial animation of a sitting character...).
+// Changed joints ranges are gathered from the SkinningIndex, sorted and merged,
+// and each merged range is skinned with a SkinningJob::Range() of the job. The
+// output buffers must thus contain the result of a previous skinning of the
+// whole mesh.
+// The job does not owned the buffers (in/output) and will thus not delete them
+// during job's destruction.
+struct IncrementalSkinningJob {
+  // Default constructor, initializes default values.
+  IncrementalSkinningJob();
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // - if skinning job is invalid, see SkinningJob::Validate().
+  // - if job.out_bounds is provided, as bounds of the whole mesh can't be
+  // computed from a subset of its vertices.
+  // - if index is nullptr or wasn't built for job.vertex_count vertices.
+  // - if changed is smaller than one bit per index joint.
+  // - if scratch is smaller than index ranges.
+  bool Validate() const;
+
+  // Runs job's incremental skinning task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // The skinning job, for all mesh vertices.
+  SkinningJob job;
+
+  // Joint to vertex ranges index of the mesh.
+  const SkinningIndex* index;
+
+  // Changed joints bits, one bit per palette joint, ie per joint index of the
+  // SkinningJob (bit i & 7 of byte i / 8). Note that palette joints are not
+  // necessarily skeleton joints, see SkinningPaletteJob::joint_remaps.
+  span<const uint8_t> changed;
+
+  // Scratch buffer used to gather and sort changed ranges. It must be at least
+  // as big as index ranges.
+  span<VertexRange> scratch;
+
+  // Optional output, number of skinned vertices.
+  int* out_skinned_count;
+};
+}  // namespace geometry
+
+namespace io {
+OZZ_IO_TYPE_TAG("ozz-skinning_index", geometry::SkinningIndex)
+OZZ_IO_TYPE_VERSION(1, geometry::SkinningIndex)
+
+template <>
+struct Extern<geometry::SkinningIndex> {
+  static void Save(OArchive& _archive, const geometry::SkinningIndex* _indices,
+                   size_t _count);
+  static void Load(IArchive& _archive, geometry::SkinningIndex* _indices,
+                   size_t _count, uint32_t _version);
+};
+}  // namespace io
+}  // namespace ozz
+#endif  // OZZ_OZZ_GEOMETRY_RUNTIME_INCREMENTAL_SKINNING_JOB_H_
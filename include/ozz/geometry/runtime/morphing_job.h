@@ -0,0 +1,139 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_GEOMETRY_RUNTIME_MORPHING_JOB_H_
+#define OZZ_OZZ_GEOMETRY_RUNTIME_MORPHING_JOB_H_
+
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace geometry {
+
+// Forward declares the skinning job that can be fused with morphing.
+struct SkinningJob;
+
+// Sparse morph target (aka blend shape), storing deltas of the subset of mesh
+// vertices that the target moves. Deltas are quantized to signed normalized
+// int16, with a scale per target. See BuildMorphTarget().
+struct MorphTarget {
+  MorphTarget() : position_scale(0.f), normal_scale(0.f) {}
+
+  // Indices of the vertices moved by the target, sorted in increasing order.
+  ozz::vector<int> vertices;
+
+  // Quantized position deltas, 3 per vertex. Delta is q * position_scale.
+  ozz::vector<int16_t> position_deltas;
+  float position_scale;
+
+  // Optional quantized normal deltas, 3 per vertex if not empty. Delta is
+  // q * normal_scale.
+  ozz::vector<int16_t> normal_deltas;
+  float normal_scale;
+};
+
+// Builds sparse morph target _target from dense position and normal deltas,
+// tightly packed as 3 floats per vertex. _normal_deltas is optional. Vertices
+// whose deltas components are all smaller than _threshold (in absolute value)
+// are discarded.
+// Returns false if deltas are smaller than _vertex_count vertices, or if
+// arguments are invalid.
+bool BuildMorphTarget(span<const float> _position_deltas,
+                      span<const float> _normal_deltas, int _vertex_count,
+                      float _threshold, MorphTarget* _target);
+
+// Applies weighted morph targets deltas to mesh positions and normals:
+// out = in + sum(weights[i] * targets[i] deltas).
+// Targets are sparse, so only the vertices they move are accumulated, and
+// targets whose weight is zero are skipped. Weights are usually the output of
+// TrackSamplingJob applied to FloatTrack.
+// Morphing can be run fused with a SkinningJob (see skinning member). Vertices
+// are then morphed by chunks to local buffers, which are used as skinning job
+// input. This saves writing and reading back morphed vertices memory.
+// Note that morphed normals aren't normalized.
+// The job does not owned the buffers (in/output) and will thus not delete them
+// during job's destruction.
+struct MorphingJob {
+  // Default constructor, initializes default values.
+  MorphingJob();
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // - if vertex_count is negative.
+  // - if weights is smaller than targets.
+  // - if any target has inconsistent deltas, or a vertex out of range.
+  // - if any input or output stream is too small.
+  // - if skinning job is provided and invalid, has a different vertex_count,
+  // if it doesn't have normals while in_normals is provided, or if
+  // out_positions or out_normals aren't empty.
+  bool Validate() const;
+
+  // Runs job's morphing task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Number of vertices to morph.
+  int vertex_count;
+
+  // Morph targets to apply.
+  span<const MorphTarget> targets;
+
+  // Weight of each target.
+  span<const float> weights;
+
+  // Input vertex positions, 3 floats per vertex, separated by
+  // in_positions_stride bytes.
+  span<const float> in_positions;
+  size_t in_positions_stride;
+
+  // Optional input vertex normals. Targets normal deltas are ignored if
+  // in_normals is empty.
+  span<const float> in_normals;
+  size_t in_normals_stride;
+
+  // Job output, morphed positions. Can be the same as in_positions (with the
+  // same stride) to morph in place. Must be empty if skinning is provided.
+  span<float> out_positions;
+  size_t out_positions_stride;
+
+  // Job output, morphed normals, required if in_normals is provided. Can be
+  // the same as in_normals to morph in place. Must be empty if skinning is
+  // provided.
+  span<float> out_normals;
+  size_t out_normals_stride;
+
+  // Optional skinning job to run fused with morphing, default nullptr. Its
+  // input positions (and normals if in_normals is provided) are replaced with
+  // the morphed ones, and it outputs the morphed and skinned vertices.
+  const SkinningJob* skinning;
+};
+}  // namespace geometry
+}  // namespace ozz
+#endif  // OZZ_OZZ_GEOMETRY_RUNTIME_MORPHING_JOB_H_
@@ -0,0 +1,106 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_GEOMETRY_RUNTIME_PARALLEL_SKINNING_JOB_H_
+#define OZZ_OZZ_GEOMETRY_RUNTIME_PARALLEL_SKINNING_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+
+namespace ozz {
+namespace math {
+struct Box;
+}
+namespace geometry {
+
+// Splits a SkinningJob in chunks of vertices, and runs them concurrently using
+// a parallel-for function provided by the application.
+// ozz doesn't implement any threading layer, so the job delegates scheduling
+// to the application's worker pool (or job system) through the parallel_for
+// callback. Each chunk is a SkinningJob::Range() of the whole job, small enough
+// so that its vertices stay in cache while being skinned. Chunks are
+// independent, as they read and write disjoint vertices, so they can be run in
+// any order by any thread.
+// Results are bitwise identical to running the whole SkinningJob on a single
+// thread. If SkinningJob::out_bounds is provided, each chunk outputs its
+// bounds to chunk_bounds, and they're merged once all chunks are completed.
+// The job does not owned the buffers (in/output) and will thus not delete them
+// during job's destruction.
+struct ParallelSkinningJob {
+  // Default constructor, initializes default values.
+  ParallelSkinningJob();
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // - if skinning job is invalid, see SkinningJob::Validate().
+  // - if chunk_size is not greater than 0.
+  // - if job.out_bounds is provided and chunk_bounds is smaller than
+  // num_chunks().
+  bool Validate() const;
+
+  // Runs all skinning chunks, through parallel_for if provided, or serially on
+  // the calling thread otherwise. Returns once all chunks are completed.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Returns the number of chunks that Run() splits the job in.
+  int num_chunks() const;
+
+  // Type of the task function called by parallel_for.
+  typedef void (*TaskFn)(const void* _context, int _index);
+
+  // Type of the function that calls _task(_context, i) for all i in range
+  // [0,_count[, potentially concurrently, and returns once they're all
+  // completed. _user_data is ParallelSkinningJob::user_data.
+  typedef void (*ParallelForFn)(TaskFn _task, const void* _context, int _count,
+                                void* _user_data);
+
+  // The skinning job to split.
+  SkinningJob job;
+
+  // Maximum number of vertices per chunk. It's rounded up to an even number,
+  // which is required to guarantee bitwise identical results. Default value
+  // targets vertex data to fit in L2 cache.
+  int chunk_size;
+
+  // Optional function that runs chunks concurrently. Chunks are run serially
+  // on the calling thread if nullptr.
+  ParallelForFn parallel_for;
+
+  // User data forwarded to parallel_for.
+  void* user_data;
+
+  // Bounds of each chunk, required if job.out_bounds is provided. It must
+  // store at least num_chunks() boxes.
+  span<math::Box> chunk_bounds;
+};
+}  // namespace geometry
+}  // namespace ozz
+#endif  // OZZ_OZZ_GEOMETRY_RUNTIME_PARALLEL_SKINNING_JOB_H_
@@ -0,0 +1,84 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_INFLUENCES_H_
+#define OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_INFLUENCES_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace geometry {
+
+// Utilities to skin a mesh with less influences than it's authored with, as a
+// level of detail for distant characters.
+// Once vertex influences are sorted by decreasing weight (see
+// SortInfluences()), a SkinningJob can use the same indices and weights
+// buffers with a lower influences_count, as strides are unchanged. Only the
+// most influencing joints of each vertex are then used, and the weight of
+// dropped influences implicitly goes to the last kept one (the job restores
+// the last weight so that weights sum to 1). Alternatively, kept weights can
+// be renormalized proportionally with a weights buffer precomputed for each
+// influences count (see BuildLODWeights()), which is much smaller than
+// duplicating the mesh.
+
+// A joint influencing a vertex.
+struct Influence {
+  uint16_t joint;
+  float weight;
+};
+
+// Sorts _influences of a vertex by decreasing weight, in place. Influences
+// with equal weights keep their relative order.
+void SortInfluences(span<Influence> _influences);
+
+// Sorts each vertex joint indices and weights by decreasing weight, in place.
+// Indices and weights are laid out as SkinningJob expects them, with
+// _influences_count indices and _influences_count - 1 weights per vertex, the
+// last weight being 1 minus the sum of the others. Influences with equal
+// weights keep their relative order.
+// Returns false if buffers are too small, or if arguments are invalid.
+bool SortInfluences(span<uint16_t> _joint_indices, size_t _indices_stride,
+                    span<float> _joint_weights, size_t _weights_stride,
+                    int _influences_count, int _vertex_count);
+
+// Builds the weights of a level of detail using the _lod_influences_count
+// first influences of each vertex, out of _influences_count. Kept weights are
+// renormalized so that they sum to 1, and _lod_influences_count - 1 weights
+// per vertex are written to _lod_weights, tightly packed, so it's meant to be
+// used as SkinningJob::joint_weights with a stride of
+// (_lod_influences_count - 1) * sizeof(float). Influences are expected to be
+// sorted, see SortInfluences().
+// Returns false if _lod_influences_count isn't in range
+// [2,_influences_count], if buffers are too small, or if arguments are
+// invalid.
+bool BuildLODWeights(span<const float> _joint_weights, size_t _weights_stride,
+                     int _influences_count, int _lod_influences_count,
+                     int _vertex_count, span<float> _lod_weights);
+}  // namespace geometry
+}  // namespace ozz
+#endif  // OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_INFLUENCES_H_
@@ -28,12 +28,17 @@
 #ifndef OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_JOB_H_
 #define OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_JOB_H_
 
+#include "ozz/base/maths/vec_float.h"
 #include "ozz/base/platform.h"
 #include "ozz/base/span.h"
 
 namespace ozz {
 namespace math {
+struct Box;
+struct Float3x4;
 struct Float4x4;
+struct SimdDualQuaternion;
+struct SimdQuaternion;
 }
 namespace geometry {
 
@@ -71,6 +76,38 @@ namespace geometry {
 // joints matrices (see http://www.glprogramming.com/red/appendixf.html). This
 // code path is less efficient than the one without this matrices set, and
 // should only be used when input matrices have non uniform scaling or shearing.
+// Joint matrices can alternatively be provided as affine 3x4 matrices (see
+// joint_affine_matrices), which are 25% smaller. This reduces memory bandwidth
+// when fetching palette matrices, and weighting matrices costs one multiply
+// less per influence. 4x4 and 3x4 matrices cannot be mixed in the same job.
+// Finally, joints can be provided as dual quaternions (see
+// joint_dual_quaternions), which selects dual quaternion skinning instead of
+// linear blend skinning. Blending dual quaternions preserves volume around
+// twisting and bending joints, avoiding the "candy wrapper" artifacts that
+// usually require helper joints. Dual quaternions don't support scaling, so
+// normals and tangents are transformed by the blended rotation, and no inverse
+// transpose array shall be provided.
+// Vertex streams can also be provided in compressed formats, which reduce
+// memory footprint and bandwidth of skinning, which is usually memory bound:
+// 8 bits joint indices and normalized weights, half float or normalized int16
+// positions, and octahedral encoded normals and tangents. Outputs can be
+// written as half float positions and octahedral normals and tangents.
+// Compressed streams are decoded (and encoded) by chunks of vertices that stay
+// in cache, so the bandwidth savings aren't lost to temporary buffers. Each
+// compressed stream is an alternative to its float counterpart, formats can be
+// mixed freely otherwise.
+// Positions can also be skinned with a second palette, usually the previous
+// frame one, to output previous positions needed for motion vectors or
+// velocity based effects. Indices, weights and positions are read once for
+// both palettes, which is cheaper than running a second job.
+// Tangent frames can alternatively be provided as QTangents, a quaternion per
+// vertex stored as 4 signed normalized int16 (see in_qtangents). QTangents
+// are 8 bytes instead of the 24 bytes of a float normal and tangent, and are
+// skinned by the blended rotations of a quaternion palette (see
+// joint_rotations).
+// The job can also output the bounding box of skinned positions (see
+// out_bounds), computed in the same pass as skinning. This avoids reading
+// skinned positions back from memory to compute culling or physics bounds.
 // The job does not owned the buffers (in/output) and will thus not delete them
 // during job's destruction.
 struct SkinningJob {
@@ -82,8 +119,19 @@ struct SkinningJob {
   // - if any range is invalid. See each range description.
   // - if normals are provided but positions aren't.
   // - if tangents are provided but normals aren't.
+  // - if none or more than one of joint_matrices, joint_affine_matrices and
+  // joint_dual_quaternions are provided, or if inverse transpose matrices
+  // don't match joint matrices type.
   // - if no output is provided while an input is. For example, if input normals
   // are provided, then output normals must also.
+  // - if a stream is provided in more than one format, for example both
+  // in_positions and in_half_positions.
+  // - if compact joint indices or weights are used with more than 256
+  // influences.
+  // - if a previous frame palette is provided without out_previous_positions
+  // (or the opposite), or if its type doesn't match joint matrices type.
+  // - if QTangents are provided with normals or tangents, or without a
+  // rotation palette (joint_rotations or joint_dual_quaternions).
   bool Validate() const;
 
   // Runs job's skinning task.
@@ -92,6 +140,15 @@ struct SkinningJob {
   // Returns false if *this job is not valid.
   bool Run() const;
 
+  // Returns a job that skins _count vertices of *this job, starting from vertex
+  // _begin. All input and output spans are offset according to their stride,
+  // and other parameters are copied. It allows to split a job in chunks, to be
+  // run by multiple threads for example, see ParallelSkinningJob.
+  // Ranges starting at an even vertex are skinned with bitwise identical
+  // results to the whole job.
+  // _begin and _count must describe a range within [0,vertex_count].
+  SkinningJob Range(int _begin, int _count) const;
+
   // Number of vertices to transform. All input and output arrays must store at
   // least this number of vertices.
   int vertex_count;
@@ -103,9 +160,14 @@ struct SkinningJob {
   // vertex.
   // - influences_count - 1 joint weights are red from joint_weightrs for each
   // vertex. The weight of the last joint is restored (weights are normalized).
+  // It can be lower than the number of influences stored per vertex in the
+  // indices and weights buffers, to skin with less influences as a level of
+  // detail, see SortInfluences() and BuildLODWeights().
   int influences_count;
 
   // Array of matrices for each joint. Joint are indexed through indices array.
+  // Must be empty if joint_affine_matrices or joint_dual_quaternions are used
+  // instead.
   span<const math::Float4x4> joint_matrices;
 
   // Optional array of inverse transposed matrices for each joint. If provided,
@@ -120,6 +182,37 @@ struct SkinningJob {
   // fall into a more costly code path in the skinning algorithm.
   span<const math::Float4x4> joint_inverse_transpose_matrices;
 
+  // Array of affine matrices for each joint, used instead of joint_matrices.
+  // Joint are indexed through indices array.
+  span<const math::Float3x4> joint_affine_matrices;
+
+  // Optional array of affine inverse transposed matrices for each joint, used
+  // along with joint_affine_matrices. See joint_inverse_transpose_matrices.
+  span<const math::Float3x4> joint_inverse_transpose_affine_matrices;
+
+  // Array of dual quaternions for each joint, used instead of joint_matrices
+  // to select dual quaternion skinning. Joint are indexed through indices
+  // array. Like matrices, they must be pre-multiplied with the inverse of the
+  // skeleton bind-pose, see SkinningPaletteJob::dual_quaternion_output.
+  span<const math::SimdDualQuaternion> joint_dual_quaternions;
+
+  // Optional previous frame palette, used to skin positions to
+  // out_previous_positions. Only the one matching joint matrices type can be
+  // provided: joint_previous_matrices with joint_matrices,
+  // joint_previous_affine_matrices with joint_affine_matrices, and
+  // joint_previous_dual_quaternions with joint_dual_quaternions. Previous
+  // palette is indexed and weighted like the current one.
+  span<const math::Float4x4> joint_previous_matrices;
+  span<const math::Float3x4> joint_previous_affine_matrices;
+  span<const math::SimdDualQuaternion> joint_previous_dual_quaternions;
+
+  // Array of joints rotations, used to skin QTangents with joint_matrices or
+  // joint_affine_matrices. Rotations are indexed and weighted like matrices,
+  // see SkinningPaletteJob::rotation_output. Must be empty if QTangents
+  // aren't used, or if joint_dual_quaternions are used, as QTangents are
+  // then skinned with dual quaternions real part.
+  span<const math::SimdQuaternion> joint_rotations;
+
   // Array of joints indices. This array is used to indexes matrices in joints
   // array.
   // Each vertex has influences_max number of indices, meaning that the size of
@@ -127,6 +220,10 @@ struct SkinningJob {
   span<const uint16_t> joint_indices;
   size_t joint_indices_stride;
 
+  // Array of 8 bits joints indices, used instead of joint_indices for
+  // skeletons with at most 256 joints. It's sampled with joint_indices_stride.
+  span<const uint8_t> joint_compact_indices;
+
   // Array of joints weights. This array is used to associate a weight to every
   // joint that influences a vertex. The number of weights required per vertex
   // is "influences_max - 1". The weight for the last joint (for each vertex) is
@@ -137,30 +234,70 @@ struct SkinningJob {
   span<const float> joint_weights;
   size_t joint_weights_stride;
 
+  // Array of 8 bits normalized joints weights (weight * 255), used instead of
+  // joint_weights. It's sampled with joint_weights_stride.
+  span<const uint8_t> joint_compact_weights;
+
   // Input vertex positions array (3 float values per vertex) and stride (number
   // of bytes between each position).
   // Array length must be at least vertex_count * in_positions_stride.
   span<const float> in_positions;
   size_t in_positions_stride;
 
+  // Input vertex positions as 3 half float values per vertex, used instead of
+  // in_positions. It's sampled with in_positions_stride.
+  span<const uint16_t> in_half_positions;
+
+  // Input vertex positions as 3 signed normalized int16 values per vertex, used
+  // instead of in_positions. It's sampled with in_positions_stride. Positions
+  // are dequantized as in_positions_offset + in_positions_scale * value, where
+  // value is in range [-1,1]. Scale and offset are usually mesh bounding box
+  // half extent and center.
+  span<const int16_t> in_snorm16_positions;
+  math::Float3 in_positions_scale;
+  math::Float3 in_positions_offset;
+
   // Input vertex normals (3 float values per vertex) array and stride (number
   // of bytes between each normal).
   // Array length must be at least vertex_count * in_normals_stride.
   span<const float> in_normals;
   size_t in_normals_stride;
 
+  // Input vertex normals as 2 signed normalized int16 values per vertex, using
+  // octahedral encoding. Used instead of in_normals, and sampled with
+  // in_normals_stride.
+  span<const int16_t> in_octahedral_normals;
+
   // Input vertex tangents (3 float values per vertex) array and stride (number
   // of bytes between each tangent).
   // Array length must be at least vertex_count * in_tangents_stride.
   span<const float> in_tangents;
   size_t in_tangents_stride;
 
+  // Input vertex tangents as 2 signed normalized int16 values per vertex, using
+  // octahedral encoding. Used instead of in_tangents, and sampled with
+  // in_tangents_stride. Note that tangent handedness isn't part of the
+  // encoding, application can store it with tangent or bitangent sign.
+  span<const int16_t> in_octahedral_tangents;
+
+  // Input vertex tangent frames as QTangents, 4 signed normalized int16 values
+  // (x, y, z, w) per vertex, and stride. The quaternion rotates tangent space
+  // x, y and z axes to the tangent, bi-normal and normal. The sign of w is
+  // the bi-normal handedness, so w is never 0. Used instead of normals and
+  // tangents, which must be empty.
+  span<const int16_t> in_qtangents;
+  size_t in_qtangents_stride;
+
   // Output vertex positions (3 float values per vertex) array and stride
   // (number of bytes between each position).
   // Array length must be at least vertex_count * out_positions_stride.
   span<float> out_positions;
   size_t out_positions_stride;
 
+  // Output vertex positions as 3 half float values per vertex, used instead of
+  // out_positions. It's written with out_positions_stride.
+  span<uint16_t> out_half_positions;
+
   // Output vertex normals (3 float values per vertex) array and stride (number
   // of bytes between each normal).
   // Note that output normals are not normalized by the skinning job. This task
@@ -171,6 +308,11 @@ struct SkinningJob {
   span<float> out_normals;
   size_t out_normals_stride;
 
+  // Output vertex normals as 2 signed normalized int16 values per vertex, using
+  // octahedral encoding. Used instead of out_normals, and written with
+  // out_normals_stride. Octahedral encoding implicitly normalizes normals.
+  span<int16_t> out_octahedral_normals;
+
   // Output vertex positions (3 float values per vertex) array and stride
   // (number of bytes between each tangent).
   // Like normals, Note that output tangents are not normalized by the skinning
@@ -178,6 +320,30 @@ struct SkinningJob {
   // Array length must be at least vertex_count * out_tangents_stride.
   span<float> out_tangents;
   size_t out_tangents_stride;
+
+  // Output vertex tangents as 2 signed normalized int16 values per vertex,
+  // using octahedral encoding. Used instead of out_tangents, and written with
+  // out_tangents_stride.
+  span<int16_t> out_octahedral_tangents;
+
+  // Output vertex tangent frames as QTangents, required if in_qtangents is
+  // provided, and stride. Quaternions are normalized and handedness is
+  // preserved.
+  span<int16_t> out_qtangents;
+  size_t out_qtangents_stride;
+
+  // Output vertex positions skinned with the previous frame palette (3 float
+  // values per vertex) array and stride (number of bytes between each
+  // position). Required if, and only if, a previous palette is provided.
+  // Array length must be at least vertex_count * out_previous_positions_stride.
+  span<float> out_previous_positions;
+  size_t out_previous_positions_stride;
+
+  // Optional output bounding box of skinned positions, computed while
+  // skinning if not nullptr. It's computed from full precision positions,
+  // before they are encoded to out_half_positions if used. It's set to an
+  // invalid box if vertex_count is 0.
+  math::Box* out_bounds;
 };
 }  // namespace geometry
 }  // namespace ozz
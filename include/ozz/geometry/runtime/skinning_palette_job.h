@@ -0,0 +1,120 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_PALETTE_JOB_H_
+#define OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_PALETTE_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace math {
+struct Float3x4;
+struct Float4x4;
+struct SimdDualQuaternion;
+struct SimdQuaternion;
+}  // namespace math
+namespace geometry {
+
+// Builds the skinning matrix palette of a mesh, ie the matrices indexed by the
+// per-vertex joint indices of the SkinningJob.
+// Each palette matrix is the product of a skeleton model-space matrix (usually
+// the output of the LocalToModelJob) with the inverse bind-pose matrix of the
+// corresponding mesh joint. A mesh might not be skinned by all skeleton
+// joints, or in a different order, so model-space matrices are gathered
+// through an optional joint remapping table:
+// palette[i] = model_matrices[joint_remaps[i]] * inverse_bind_poses[i]
+// The job can also output the inverse transpose of the palette matrices,
+// required by the SkinningJob to transform normals and tangents when matrices
+// have non-uniform scale or shearing.
+// Model-space and inverse bind-pose matrices are expected to be affine, which
+// allows the job to save the computation of the last row of the matrices.
+// Palettes can be output either as 4x4 matrices, affine 3x4 matrices or dual
+// quaternions, as SkinningJob::joint_matrices, joint_affine_matrices or
+// joint_dual_quaternions expect.
+// The job does not owned the buffers (in/output) and will thus not delete them
+// during job's destruction.
+struct SkinningPaletteJob {
+  // Default constructor, initializes default values.
+  SkinningPaletteJob();
+
+  // Validates job parameters.
+  // Returns true for a valid job, false otherwise:
+  // - if none or more than one of output, affine_output and
+  // dual_quaternion_output are provided, or if inverse transpose output doesn't
+  // match output type.
+  // - if any range is smaller than inverse_bind_poses, except rotation_output
+  // which can be empty.
+  // - if joint_remaps contains an index out of model_matrices range.
+  bool Validate() const;
+
+  // Runs job's palette building task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Skeleton model-space matrices, indexed through joint_remaps.
+  span<const math::Float4x4> model_matrices;
+
+  // Optional joint remapping table, from palette index to model_matrices
+  // index. If empty, palette index i uses model_matrices[i].
+  span<const uint16_t> joint_remaps;
+
+  // Mesh inverse bind-pose matrices. The size of this range defines the number
+  // of palette matrices to build.
+  span<const math::Float4x4> inverse_bind_poses;
+
+  // Job output, palette 4x4 matrices. Must be empty if affine_output or
+  // dual_quaternion_output is used instead.
+  span<math::Float4x4> output;
+
+  // Optional inverse transpose of output matrices. Only the upper 3x3 part is
+  // computed, the last row and column are set to identity as these matrices
+  // are only meant to transform vectors.
+  span<math::Float4x4> inverse_transpose_output;
+
+  // Job output, palette affine 3x4 matrices, used instead of output.
+  span<math::Float3x4> affine_output;
+
+  // Optional inverse transpose of affine_output matrices. See
+  // inverse_transpose_output.
+  span<math::Float3x4> affine_inverse_transpose_output;
+
+  // Job output, palette dual quaternions, used instead of output for dual
+  // quaternion skinning. Scale of palette matrices is discarded, and there's
+  // no inverse transpose output for dual quaternions.
+  span<math::SimdDualQuaternion> dual_quaternion_output;
+
+  // Optional output, rotation of each palette matrix (scale is discarded), as
+  // expected by SkinningJob::joint_rotations to skin QTangents. It can be
+  // used along with any of the palette outputs.
+  span<math::SimdQuaternion> rotation_output;
+};
+}  // namespace geometry
+}  // namespace ozz
+#endif  // OZZ_OZZ_GEOMETRY_RUNTIME_SKINNING_PALETTE_JOB_H_
@@ -26,6 +26,7 @@
 //----------------------------------------------------------------------------//
 
 #include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/blend_space_job.h"
 #include "ozz/animation/runtime/blending_job.h"
 #include "ozz/animation/runtime/local_to_model_job.h"
 #include "ozz/animation/runtime/sampling_job.h"
@@ -151,37 +152,36 @@ class BlendSampleApplication : public ozz::sample::Application {
   // Computes blending weight and synchronizes playback speed when the "manual"
   // option is off.
   void UpdateRuntimeParameters() {
-    // Computes weight parameters for all samplers.
-    const float kNumIntervals = kNumLayers - 1;
-    const float kInterval = 1.f / kNumIntervals;
+    // Clips are laid out uniformly on a 1D blend space.
+    const float kInterval = 1.f / (kNumLayers - 1);
+    ozz::math::Float2 positions[kNumLayers];
+    float durations[kNumLayers];
     for (int i = 0; i < kNumLayers; ++i) {
-      const float med = i * kInterval;
-      const float x = blend_ratio_ - med;
-      const float y = ((x < 0.f ? x : -x) + kInterval) * kNumIntervals;
-      samplers_[i].weight = ozz::math::Max(0.f, y);
+      positions[i] = ozz::math::Float2(i * kInterval, 0.f);
+      durations[i] = samplers_[i].animation.duration();
     }
 
-    // Synchronizes animations.
-    // First computes loop cycle duration. Selects the 2 samplers that define
-    // interval that contains blend_ratio_.
-    // Uses a maximum value smaller that 1.f (-epsilon) to ensure that
-    // (relevant_sampler + 1) is always valid.
-    const int relevant_sampler =
-        static_cast<int>((blend_ratio_ - 1e-3f) * (kNumLayers - 1));
-    assert(relevant_sampler + 1 < kNumLayers);
-    Sampler& sampler_l = samplers_[relevant_sampler];
-    Sampler& sampler_r = samplers_[relevant_sampler + 1];
-
-    // Interpolates animation durations using their respective weights, to
-    // find the loop cycle duration that matches blend_ratio_.
-    const float loop_duration =
-        sampler_l.animation.duration() * sampler_l.weight +
-        sampler_r.animation.duration() * sampler_r.weight;
-
-    // Finally finds the speed coefficient for all samplers.
+    // Computes weight parameters for all samplers, as well as loop cycle
+    // duration that matches blend_ratio_.
+    float weights[kNumLayers];
+    float loop_duration;
+    ozz::animation::BlendSpaceJob blend_space_job;
+    blend_space_job.parameter = ozz::math::Float2(blend_ratio_, 0.f);
+    blend_space_job.samples = positions;
+    blend_space_job.threshold = 0.f;
+    blend_space_job.durations = durations;
+    blend_space_job.weights = weights;
+    blend_space_job.duration = &loop_duration;
+    if (!blend_space_job.Run()) {
+      return;
+    }
+
+    // Synchronizes animations, finding the speed coefficient for all
+    // samplers.
     const float inv_loop_duration = 1.f / loop_duration;
     for (int i = 0; i < kNumLayers; ++i) {
       Sampler& sampler = samplers_[i];
+      sampler.weight = weights[i];
       const float speed = sampler.animation.duration() * inv_loop_duration;
       sampler.controller.set_playback_speed(speed);
     }
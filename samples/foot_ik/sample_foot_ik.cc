@@ -41,6 +41,7 @@
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/maths/vec_float.h"
 
+#include "ozz/geometry/runtime/skinning_palette_job.h"
 #include "ozz/options/options.h"
 
 #include "framework/application.h"
@@ -471,9 +472,13 @@ class FootIKSampleApplication : public ozz::sample::Application {
       // reorder model-space matrices and build skinning ones.
       for (size_t m = 0; m < meshes_.size(); ++m) {
         const ozz::sample::Mesh& mesh = meshes_[m];
-        for (size_t i = 0; i < mesh.joint_remaps.size(); ++i) {
-          skinning_matrices_[i] =
-              models_[mesh.joint_remaps[i]] * mesh.inverse_bind_poses[i];
+        ozz::geometry::SkinningPaletteJob palette_job;
+        palette_job.model_matrices = make_span(models_);
+        palette_job.joint_remaps = make_span(mesh.joint_remaps);
+        palette_job.inverse_bind_poses = make_span(mesh.inverse_bind_poses);
+        palette_job.output = make_span(skinning_matrices_);
+        if (!palette_job.Run()) {
+          return false;
         }
 
         success &= _renderer->DrawSkinnedMesh(
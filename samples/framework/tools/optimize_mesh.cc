@@ -0,0 +1,524 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "framework/mesh.h"
+
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/log.h"
+#include "ozz/geometry/runtime/incremental_skinning_job.h"
+#include "ozz/geometry/runtime/skinning_influences.h"
+
+#include "ozz/options/options.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+// Declares command line options.
+OZZ_OPTIONS_DECLARE_STRING(file, "Specifies input ozz mesh file.", "", true)
+OZZ_OPTIONS_DECLARE_STRING(mesh, "Specifies optimized ozz mesh output file.",
+                           "", true)
+OZZ_OPTIONS_DECLARE_FLOAT(
+    weight_threshold,
+    "Joint influences whose weight is below this threshold are pruned. "
+    "Default value is half of a 8 bits normalized weight step.",
+    .002f, false)
+OZZ_OPTIONS_DECLARE_INT(
+    max_influences,
+    "Maximum number of joint influences per vertex (0 means no limitation).", 0,
+    false)
+OZZ_OPTIONS_DECLARE_STRING(
+    skinning_index,
+    "Specifies an optional output file for the incremental skinning index of "
+    "every optimized mesh part.",
+    "", false)
+OZZ_OPTIONS_DECLARE_INT(
+    skinning_index_gap,
+    "Maximum number of vertices between two ranges of a joint merged by the "
+    "incremental skinning index.",
+    8, false)
+OZZ_OPTIONS_DECLARE_INT(alignment,
+                        "Number of vertices each part (but the last one) is "
+                        "aligned to, to match SIMD skinning width.",
+                        4, false)
+
+namespace {
+
+// Skinning cost model, in arbitrary units. Each vertex costs its
+// transformation, plus a weighted matrix accumulation per influence. Each mesh
+// part costs the setup of a SkinningJob, and a matrix palette cold start.
+const float kVertexCost = 2.f;
+const float kInfluenceCost = 1.f;
+const float kPartCost = 64.f;
+
+// Estimates the cost of skinning _vertex_count vertices with _influences joints
+// each.
+float PartCost(size_t _vertex_count, int _influences) {
+  if (_vertex_count == 0) {
+    return 0.f;
+  }
+  return kPartCost +
+         _vertex_count * (kVertexCost + _influences * kInfluenceCost);
+}
+
+// Estimates the cost of skinning all _mesh parts.
+float MeshCost(const ozz::sample::Mesh& _mesh) {
+  float cost = 0.f;
+  for (size_t i = 0; i < _mesh.parts.size(); ++i) {
+    const ozz::sample::Mesh::Part& part = _mesh.parts[i];
+    cost += PartCost(part.vertex_count(), part.influences_count());
+  }
+  return cost;
+}
+
+// Counts the number of time the most influencing joint changes from a vertex
+// to the next one, which gives an idea of the matrix palette access locality.
+int CountPaletteSwitches(const ozz::sample::Mesh& _mesh) {
+  int switches = 0;
+  for (size_t i = 0; i < _mesh.parts.size(); ++i) {
+    const ozz::sample::Mesh::Part& part = _mesh.parts[i];
+    const int influences = part.influences_count();
+    for (int j = 1; j < part.vertex_count(); ++j) {
+      switches += part.joint_indices[(j - 1) * influences] !=
+                  part.joint_indices[j * influences];
+    }
+  }
+  return switches;
+}
+
+using ozz::geometry::Influence;
+
+// Skinning data of a vertex, sorted by decreasing weight. part and index
+// locate the vertex in the source mesh.
+struct Vertex {
+  int part;
+  int index;
+  ozz::vector<Influence> influences;
+};
+
+// Orders vertices by their joints (most influencing first) so that
+// consecutive vertices access the same matrix palette entries.
+struct PaletteLess {
+  explicit PaletteLess(const ozz::vector<Vertex>& _vertices)
+      : vertices(&_vertices) {}
+  bool operator()(int _a, int _b) const {
+    const ozz::vector<Influence>& a = (*vertices)[_a].influences;
+    const ozz::vector<Influence>& b = (*vertices)[_b].influences;
+    for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+      if (a[i].joint != b[i].joint) {
+        return a[i].joint < b[i].joint;
+      }
+    }
+    if (a.size() != b.size()) {
+      return a.size() < b.size();
+    }
+    return _a < _b;  // Keeps original order otherwise.
+  }
+  const ozz::vector<Vertex>* vertices;
+};
+
+// Extracts all _mesh vertices influences. The last weight, which isn't stored
+// in the mesh, is restored.
+void ExtractInfluences(const ozz::sample::Mesh& _mesh,
+                       ozz::vector<Vertex>* _vertices) {
+  for (size_t i = 0; i < _mesh.parts.size(); ++i) {
+    const ozz::sample::Mesh::Part& part = _mesh.parts[i];
+    const int influences = part.influences_count();
+    for (int j = 0; j < part.vertex_count(); ++j) {
+      _vertices->resize(_vertices->size() + 1);
+      Vertex& vertex = _vertices->back();
+      vertex.part = static_cast<int>(i);
+      vertex.index = j;
+      vertex.influences.resize(influences);
+      float sum = 0.f;
+      for (int k = 0; k < influences - 1; ++k) {
+        const float weight = part.joint_weights[j * (influences - 1) + k];
+        vertex.influences[k].weight = weight;
+        sum += weight;
+      }
+      vertex.influences[influences - 1].weight = 1.f - sum;
+      for (int k = 0; k < influences; ++k) {
+        vertex.influences[k].joint = part.joint_indices[j * influences + k];
+      }
+    }
+  }
+}
+
+// Removes influences whose weight is below _threshold, and the ones exceeding
+// _limit (if not 0). Remaining weights are renormalized. Returns the number
+// of influences removed.
+int PruneInfluences(float _threshold, int _limit,
+                    ozz::vector<Vertex>* _vertices) {
+  int pruned = 0;
+  for (size_t i = 0; i < _vertices->size(); ++i) {
+    ozz::vector<Influence>& influences = (*_vertices)[i].influences;
+    ozz::geometry::SortInfluences(ozz::make_span(influences));
+
+    // Keeps at least the most influencing joint.
+    size_t count = 1;
+    for (; count < influences.size() && influences[count].weight >= _threshold;
+         ++count) {
+    }
+    if (_limit > 0 && count > static_cast<size_t>(_limit)) {
+      count = _limit;
+    }
+    pruned += static_cast<int>(influences.size() - count);
+    influences.resize(count);
+
+    float sum = 0.f;
+    for (size_t j = 0; j < count; ++j) {
+      sum += influences[j].weight;
+    }
+    for (size_t j = 0; j < count; ++j) {
+      influences[j].weight =
+          sum > 0.f ? influences[j].weight / sum : 1.f / count;
+    }
+  }
+  return pruned;
+}
+
+// Buckets of vertices, one per influence count (bucket i gathers vertices
+// skinned with i + 1 influences).
+typedef ozz::vector<ozz::vector<int>> Buckets;
+
+// Finds the next non empty bucket after _bucket, or returns buckets count.
+size_t NextBucket(const Buckets& _buckets, size_t _bucket) {
+  size_t next = _bucket + 1;
+  for (; next < _buckets.size() && _buckets[next].empty(); ++next) {
+  }
+  return next;
+}
+
+// Moves the _count last vertices of bucket _from to bucket _to. Vertices
+// with less influences are padded with null weights.
+void MoveVertices(Buckets* _buckets, size_t _from, size_t _to, size_t _count) {
+  ozz::vector<int>& from = (*_buckets)[_from];
+  ozz::vector<int>& to = (*_buckets)[_to];
+  to.insert(to.end(), from.end() - _count, from.end());
+  from.resize(from.size() - _count);
+}
+
+// Distributes vertices to buckets, according to their influence count. Small
+// buckets are merged into the next one when padding influences costs less
+// than skinning an additional part. Then all buckets but the last one are
+// resized to a multiple of _alignment vertices, moving remaining vertices to
+// the next bucket.
+void BuildBuckets(const ozz::vector<Vertex>& _vertices, int _alignment,
+                  Buckets* _buckets) {
+  for (size_t i = 0; i < _vertices.size(); ++i) {
+    const size_t bucket = _vertices[i].influences.size() - 1;
+    if (bucket >= _buckets->size()) {
+      _buckets->resize(bucket + 1);
+    }
+    (*_buckets)[bucket].push_back(static_cast<int>(i));
+  }
+
+  // Merges buckets.
+  for (size_t i = 0; i < _buckets->size(); ++i) {
+    const size_t next = NextBucket(*_buckets, i);
+    const size_t count = (*_buckets)[i].size();
+    if (count == 0 || next == _buckets->size()) {
+      continue;
+    }
+    const float padding_cost = count * (next - i) * kInfluenceCost;
+    if (padding_cost < kPartCost) {
+      MoveVertices(_buckets, i, next, count);
+    }
+  }
+
+  // Aligns buckets.
+  if (_alignment > 1) {
+    for (size_t i = 0; i < _buckets->size(); ++i) {
+      const size_t next = NextBucket(*_buckets, i);
+      const size_t count = (*_buckets)[i].size();
+      if (count == 0 || next == _buckets->size()) {
+        continue;
+      }
+      MoveVertices(_buckets, i, next, count % _alignment);
+    }
+  }
+}
+
+// Copies _count components of vertex _src_index from _src attribute to vertex
+// _dst_index of _dst, if _src isn't empty.
+template <typename _Ty>
+void CopyAttribute(const ozz::vector<_Ty>& _src, int _src_index,
+                   ozz::vector<_Ty>* _dst, int _dst_index, int _count) {
+  if (_src.empty()) {
+    return;
+  }
+  std::copy(_src.begin() + _src_index * _count,
+            _src.begin() + (_src_index + 1) * _count,
+            _dst->begin() + _dst_index * _count);
+}
+
+// Rebuilds _output mesh parts from _input mesh and _buckets of _vertices.
+// Triangle indices are remapped to the new vertex order.
+bool BuildMesh(const ozz::sample::Mesh& _input,
+               const ozz::vector<Vertex>& _vertices, const Buckets& _buckets,
+               ozz::sample::Mesh* _output) {
+  typedef ozz::sample::Mesh::Part Part;
+
+  // Vertex attributes must be the same for all parts, as parts are mixed.
+  const Part& first = _input.parts.front();
+  for (size_t i = 1; i < _input.parts.size(); ++i) {
+    const Part& part = _input.parts[i];
+    if (part.normals.empty() != first.normals.empty() ||
+        part.tangents.empty() != first.tangents.empty() ||
+        part.uvs.empty() != first.uvs.empty() ||
+        part.colors.empty() != first.colors.empty()) {
+      ozz::log::Err() << "Mesh parts have different vertex attributes."
+                      << std::endl;
+      return false;
+    }
+  }
+
+  // Global index of the first vertex of each input part.
+  ozz::vector<int> part_offsets(_input.parts.size(), 0);
+  for (size_t i = 1; i < _input.parts.size(); ++i) {
+    part_offsets[i] = part_offsets[i - 1] + _input.parts[i - 1].vertex_count();
+  }
+
+  ozz::vector<uint16_t> vertices_remap(_vertices.size());
+  int processed_vertices = 0;
+  for (size_t i = 0; i < _buckets.size(); ++i) {
+    const ozz::vector<int>& bucket = _buckets[i];
+    if (bucket.empty()) {
+      continue;
+    }
+    const int influences = static_cast<int>(i) + 1;
+    const int vertex_count = static_cast<int>(bucket.size());
+
+    _output->parts.resize(_output->parts.size() + 1);
+    Part& out = _output->parts.back();
+    out.positions.resize(vertex_count * Part::kPositionsCpnts);
+    out.normals.resize(
+        first.normals.empty() ? 0 : vertex_count * Part::kNormalsCpnts);
+    out.tangents.resize(
+        first.tangents.empty() ? 0 : vertex_count * Part::kTangentsCpnts);
+    out.uvs.resize(first.uvs.empty() ? 0 : vertex_count * Part::kUVsCpnts);
+    out.colors.resize(first.colors.empty() ? 0
+                                           : vertex_count * Part::kColorsCpnts);
+    out.joint_indices.resize(vertex_count * influences);
+    out.joint_weights.resize(vertex_count * (influences - 1));
+
+    for (int j = 0; j < vertex_count; ++j) {
+      const Vertex& vertex = _vertices[bucket[j]];
+      const Part& in = _input.parts[vertex.part];
+      CopyAttribute(in.positions, vertex.index, &out.positions, j,
+                    Part::kPositionsCpnts);
+      CopyAttribute(in.normals, vertex.index, &out.normals, j,
+                    Part::kNormalsCpnts);
+      CopyAttribute(in.tangents, vertex.index, &out.tangents, j,
+                    Part::kTangentsCpnts);
+      CopyAttribute(in.uvs, vertex.index, &out.uvs, j, Part::kUVsCpnts);
+      CopyAttribute(in.colors, vertex.index, &out.colors, j,
+                    Part::kColorsCpnts);
+
+      // Pads missing influences with the most influencing joint and a null
+      // weight, so no other palette entry is accessed.
+      const int vertex_influences = static_cast<int>(vertex.influences.size());
+      for (int k = 0; k < influences; ++k) {
+        const bool padded = k >= vertex_influences;
+        out.joint_indices[j * influences + k] =
+            vertex.influences[padded ? 0 : k].joint;
+        if (k < influences - 1) {
+          out.joint_weights[j * (influences - 1) + k] =
+              padded ? 0.f : vertex.influences[k].weight;
+        }
+      }
+
+      vertices_remap[part_offsets[vertex.part] + vertex.index] =
+          static_cast<uint16_t>(processed_vertices + j);
+    }
+    processed_vertices += vertex_count;
+  }
+
+  // Remaps triangle indices, using vertex mapping table.
+  _output->triangle_indices.resize(_input.triangle_indices.size());
+  for (size_t i = 0; i < _input.triangle_indices.size(); ++i) {
+    _output->triangle_indices[i] = vertices_remap[_input.triangle_indices[i]];
+  }
+
+  // Joints aren't modified.
+  _output->joint_remaps = _input.joint_remaps;
+  _output->inverse_bind_poses = _input.inverse_bind_poses;
+
+  return true;
+}
+
+// Optimizes _input skinned mesh to _output.
+bool Optimize(const ozz::sample::Mesh& _input, ozz::sample::Mesh* _output) {
+  for (size_t i = 0; i < _input.parts.size(); ++i) {
+    if (_input.parts[i].influences_count() == 0) {
+      ozz::log::Err() << "Mesh mixes skinned and rigid parts." << std::endl;
+      return false;
+    }
+  }
+
+  ozz::vector<Vertex> vertices;
+  ExtractInfluences(_input, &vertices);
+
+  const int pruned = PruneInfluences(OPTIONS_weight_threshold,
+                                     OPTIONS_max_influences, &vertices);
+  ozz::log::LogV() << pruned << " joint influences pruned." << std::endl;
+
+  Buckets buckets;
+  BuildBuckets(vertices, OPTIONS_alignment, &buckets);
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    std::sort(buckets[i].begin(), buckets[i].end(), PaletteLess(vertices));
+  }
+
+  return BuildMesh(_input, vertices, buckets, _output);
+}
+
+// Logs _mesh parts and skinning cost estimation.
+void Report(const char* _name, const ozz::sample::Mesh& _mesh) {
+  ozz::log::Log() << _name << " mesh: " << _mesh.vertex_count()
+                  << " vertices, " << _mesh.parts.size()
+                  << " parts, estimated skinning cost " << MeshCost(_mesh)
+                  << ", " << CountPaletteSwitches(_mesh)
+                  << " palette switches." << std::endl;
+  for (size_t i = 0; i < _mesh.parts.size(); ++i) {
+    const ozz::sample::Mesh::Part& part = _mesh.parts[i];
+    ozz::log::LogV() << " Part " << i << ": " << part.vertex_count()
+                     << " vertices, " << part.influences_count()
+                     << " influences." << std::endl;
+  }
+}
+}  // namespace
+
+int main(int _argc, const char** _argv) {
+  // Parses arguments.
+  ozz::options::ParseResult parse_result = ozz::options::ParseCommandLine(
+      _argc, _argv, "1.0",
+      "Optimizes ozz skinned meshes partitioning for skinning throughput");
+  if (parse_result != ozz::options::kSuccess) {
+    return parse_result == ozz::options::kExitSuccess ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+  }
+
+  if (OPTIONS_weight_threshold < 0.f || OPTIONS_max_influences < 0 ||
+      OPTIONS_alignment < 1 || OPTIONS_skinning_index_gap < 0) {
+    ozz::log::Err() << "Invalid options." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Loads all meshes.
+  ozz::vector<ozz::sample::Mesh> meshes;
+  {
+    ozz::log::Out() << "Loading meshes archive " << OPTIONS_file.value() << "."
+                    << std::endl;
+    ozz::io::File file(OPTIONS_file.value(), "rb");
+    if (!file.opened()) {
+      ozz::log::Err() << "Failed to open mesh file " << OPTIONS_file.value()
+                      << "." << std::endl;
+      return EXIT_FAILURE;
+    }
+    ozz::io::IArchive archive(&file);
+    while (archive.TestTag<ozz::sample::Mesh>()) {
+      meshes.resize(meshes.size() + 1);
+      archive >> meshes.back();
+    }
+    if (meshes.empty()) {
+      ozz::log::Err() << "Failed to load mesh instance from file "
+                      << OPTIONS_file.value() << "." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Optimizes skinned meshes. Other meshes are left unchanged.
+  for (size_t m = 0; m < meshes.size(); ++m) {
+    if (!meshes[m].skinned()) {
+      continue;
+    }
+    Report("Input", meshes[m]);
+
+    ozz::sample::Mesh optimized;
+    if (!Optimize(meshes[m], &optimized)) {
+      ozz::log::Err() << "Failed to optimize mesh." << std::endl;
+      return EXIT_FAILURE;
+    }
+    meshes[m] = optimized;
+
+    Report("Optimized", meshes[m]);
+  }
+
+  // Opens output file.
+  ozz::io::File mesh_file(OPTIONS_mesh, "wb");
+  if (!mesh_file.opened()) {
+    ozz::log::Err() << "Failed to open output file: " << OPTIONS_mesh.value()
+                    << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  {
+    // Serializes meshes the same way they were read.
+    ozz::io::OArchive archive(&mesh_file);
+    for (size_t m = 0; m < meshes.size(); ++m) {
+      archive << meshes[m];
+    }
+  }
+
+  // Builds and serializes skinning indices of all skinned meshes parts, in
+  // order.
+  if (OPTIONS_skinning_index.value()[0] != 0) {
+    ozz::io::File index_file(OPTIONS_skinning_index, "wb");
+    if (!index_file.opened()) {
+      ozz::log::Err() << "Failed to open output file: "
+                      << OPTIONS_skinning_index.value() << std::endl;
+      return EXIT_FAILURE;
+    }
+    ozz::io::OArchive archive(&index_file);
+    for (size_t m = 0; m < meshes.size(); ++m) {
+      const ozz::sample::Mesh& mesh = meshes[m];
+      if (!mesh.skinned()) {
+        continue;
+      }
+      for (size_t i = 0; i < mesh.parts.size(); ++i) {
+        const ozz::sample::Mesh::Part& part = mesh.parts[i];
+        ozz::geometry::SkinningIndex index;
+        if (!ozz::geometry::BuildSkinningIndex(
+                ozz::make_span(part.joint_indices),
+                sizeof(uint16_t) * part.influences_count(),
+                part.influences_count(), part.vertex_count(),
+                mesh.num_joints(), OPTIONS_skinning_index_gap, &index)) {
+          ozz::log::Err() << "Failed to build skinning index." << std::endl;
+          return EXIT_FAILURE;
+        }
+        archive << index;
+      }
+    }
+  }
+
+  ozz::log::Log() << "Optimized mesh binary archive successfully outputted for "
+                     "file "
+                  << OPTIONS_file.value() << "." << std::endl;
+
+  return EXIT_SUCCESS;
+}
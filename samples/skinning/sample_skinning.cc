@@ -41,6 +41,7 @@
 #include "ozz/base/maths/simd_math.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/maths/vec_float.h"
+#include "ozz/geometry/runtime/skinning_palette_job.h"
 #include "ozz/options/options.h"
 
 // Skeleton archive can be specified as an option.
@@ -102,9 +103,13 @@ class SkinningSampleApplication : public ozz::sample::Application {
       // the joint remapping table (available from the mesh object) to reorder
       // model-space matrices and build skinning ones.
       for (const ozz::sample::Mesh& mesh : meshes_) {
-        for (size_t i = 0; i < mesh.joint_remaps.size(); ++i) {
-          skinning_matrices_[i] =
-              models_[mesh.joint_remaps[i]] * mesh.inverse_bind_poses[i];
+        ozz::geometry::SkinningPaletteJob palette_job;
+        palette_job.model_matrices = make_span(models_);
+        palette_job.joint_remaps = make_span(mesh.joint_remaps);
+        palette_job.inverse_bind_poses = make_span(mesh.inverse_bind_poses);
+        palette_job.output = make_span(skinning_matrices_);
+        if (!palette_job.Run()) {
+          return false;
         }
 
         // Renders skin.
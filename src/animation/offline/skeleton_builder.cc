@@ -117,6 +117,9 @@ unique_ptr<ozz::animation::Skeleton> SkeletonBuilder::operator()(
     skeleton->joint_parents_[i] = lister.linear_joints[i].parent;
   }
 
+  // Precomputes depth-ordered layout from joint hierarchy.
+  skeleton->BuildDepthLayout();
+
   // Transfers t-poses.
   const math::SimdFloat4 w_axis = math::simd_float4::w_axis();
   const math::SimdFloat4 zero = math::simd_float4::zero();
@@ -0,0 +1,213 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+// skel2cpp generates a C++ header, specialized for a skeleton hierarchy. The
+// header contains the constant joint parents array, and a straight-line
+// LocalToModelJob evaluation function, that can be set as
+// LocalToModelJob::specialization. This allows the compiler to schedule the
+// whole hierarchy evaluation of a rig that never changes.
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/string.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/log.h"
+#include "ozz/options/options.h"
+
+// Declares command line options.
+OZZ_OPTIONS_DECLARE_STRING(file, "Specifies input skeleton file", "", true)
+OZZ_OPTIONS_DECLARE_STRING(output, "Specifies output header file", "", true)
+
+static bool ValidateNamespace(const ozz::options::Option& _option,
+                              int /*_argc*/) {
+  const ozz::options::StringOption& option =
+      static_cast<const ozz::options::StringOption&>(_option);
+  const char* name = option.value();
+  bool valid = std::isalpha(static_cast<unsigned char>(name[0])) != 0;
+  for (const char* c = name; valid && *c; ++c) {
+    valid = std::isalnum(static_cast<unsigned char>(*c)) != 0 || *c == '_';
+  }
+  if (!valid) {
+    ozz::log::Err() << "Invalid namespace option \"" << option << "\""
+                    << std::endl;
+  }
+  return valid;
+}
+
+OZZ_OPTIONS_DECLARE_STRING_FN(
+    namespace, "C++ namespace of the generated code, must be an identifier.",
+    "skeleton", false, &ValidateNamespace)
+
+namespace {
+
+bool LoadSkeleton(const char* _filename, ozz::animation::Skeleton* _skeleton) {
+  if (!ozz::io::File::Exist(_filename)) {
+    ozz::log::Err() << "File \"" << _filename << "\" doesn't exist."
+                    << std::endl;
+    return false;
+  }
+  ozz::io::File file(_filename, "rb");
+  ozz::io::IArchive archive(&file);
+  if (!archive.TestTag<ozz::animation::Skeleton>()) {
+    ozz::log::Err() << "Failed to load skeleton instance from file \""
+                    << _filename << "\"." << std::endl;
+    return false;
+  }
+
+  // Once the tag is validated, reading cannot fail.
+  archive >> *_skeleton;
+  return true;
+}
+
+// Writes the generated header to _os.
+void Generate(const ozz::animation::Skeleton& _skeleton, const char* _name,
+              std::ostream& _os) {
+  const ozz::span<const int16_t>& parents = _skeleton.joint_parents();
+  const int num_joints = _skeleton.num_joints();
+
+  ozz::string guard = ozz::string("OZZ_SKEL2CPP_") + _name + "_H_";
+  for (char& c : guard) {
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  }
+
+  _os << "// Generated by skel2cpp from \"" << OPTIONS_file.value()
+      << "\", don't edit.\n\n"
+      << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+      << "#include \"ozz/animation/runtime/local_to_model_job.h\"\n"
+      << "#include \"ozz/base/maths/simd_math.h\"\n"
+      << "#include \"ozz/base/maths/soa_float4x4.h\"\n"
+      << "#include \"ozz/base/maths/soa_transform.h\"\n\n"
+      << "namespace " << _name << " {\n\n";
+
+  // Constant hierarchy.
+  _os << "constexpr int kNumJoints = " << num_joints << ";\n\n"
+      << "constexpr int16_t kJointParents[" << (num_joints ? num_joints : 1)
+      << "] = {";
+  for (int i = 0; i < num_joints; ++i) {
+    _os << (i % 16 == 0 ? "\n    " : " ") << parents[i]
+        << (i + 1 < num_joints ? "," : "");
+  }
+  if (num_joints == 0) {
+    _os << "0";  // Zero sized arrays aren't allowed.
+  }
+  _os << "};\n\n";
+
+  // Helpers, that compute the same as LocalToModelJob.
+  _os << "// Converts soa transforms to 4 local-space matrices.\n"
+         "inline void ToMatrices(const ozz::math::SoaTransform& _transform,\n"
+         "                       ozz::math::Float4x4* _matrices) {\n"
+         "  const ozz::math::SoaFloat4x4 soa = "
+         "ozz::math::SoaFloat4x4::FromAffine(\n"
+         "      _transform.translation, _transform.rotation, "
+         "_transform.scale);\n"
+         "  ozz::math::Transpose16x16(&soa.cols[0].x, _matrices->cols);\n"
+         "}\n\n"
+         "// Multiplies _parent matrix by _local affine matrix.\n"
+         "inline ozz::math::Float4x4 Multiply(const ozz::math::Float4x4& "
+         "_parent,\n"
+         "                                    const ozz::math::Float4x4& "
+         "_local) {\n"
+         "  const ozz::math::Float4x4 ret = {\n"
+         "      {ozz::math::TransformVector(_parent, _local.cols[0]),\n"
+         "       ozz::math::TransformVector(_parent, _local.cols[1]),\n"
+         "       ozz::math::TransformVector(_parent, _local.cols[2]),\n"
+         "       ozz::math::TransformPoint(_parent, _local.cols[3])}};\n"
+         "  return ret;\n"
+         "}\n\n";
+
+  // Unrolled hierarchy evaluation.
+  _os << "// Computes model-space matrices of all joints.\n"
+         "inline void LocalToModel(const ozz::math::SoaTransform* _input,\n"
+         "                         const ozz::math::Float4x4& _root,\n"
+         "                         ozz::math::Float4x4* _output) {\n";
+  if (num_joints) {
+    _os << "  ozz::math::Float4x4 local[4];\n";
+  } else {
+    _os << "  (void)_input;\n  (void)_root;\n  (void)_output;\n";
+  }
+  for (int i = 0; i < num_joints; ++i) {
+    if ((i & 3) == 0) {
+      _os << "  ToMatrices(_input[" << i / 4 << "], local);\n";
+    }
+    _os << "  _output[" << i << "] = Multiply(";
+    if (parents[i] == ozz::animation::Skeleton::kNoParent) {
+      _os << "_root";
+    } else {
+      _os << "_output[" << parents[i] << "]";
+    }
+    _os << ", local[" << (i & 3) << "]);\n";
+  }
+  _os << "}\n\n";
+
+  // Job specialization.
+  _os << "// LocalToModelJob specialization for this skeleton.\n"
+         "inline const ozz::animation::LocalToModelJob::Specialization&\n"
+         "LocalToModelSpecialization() {\n"
+         "  static const ozz::animation::LocalToModelJob::Specialization "
+         "specialization = {\n"
+         "      ozz::span<const int16_t>(kJointParents, kNumJoints), "
+         "&LocalToModel};\n"
+         "  return specialization;\n"
+         "}\n"
+      << "}  // namespace " << _name << "\n"
+      << "#endif  // " << guard << "\n";
+}
+}  // namespace
+
+int main(int _argc, const char** _argv) {
+  // Parses arguments.
+  ozz::options::ParseResult parse_result = ozz::options::ParseCommandLine(
+      _argc, _argv, "1.0",
+      "Generates a C++ header specialized for a skeleton, containing an "
+      "unrolled LocalToModelJob hierarchy evaluation.");
+  if (parse_result != ozz::options::kSuccess) {
+    return parse_result == ozz::options::kExitSuccess ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+  }
+
+  ozz::animation::Skeleton skeleton;
+  if (!LoadSkeleton(OPTIONS_file, &skeleton)) {
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream file(OPTIONS_output.value());
+  if (!file.is_open()) {
+    ozz::log::Err() << "Failed to open output file: \""
+                    << OPTIONS_output.value() << "\"" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Generate(skeleton, OPTIONS_namespace, file);
+
+  ozz::log::Log() << "Generated \"" << OPTIONS_output.value() << "\" for "
+                  << skeleton.num_joints() << " joints." << std::endl;
+  return EXIT_SUCCESS;
+}
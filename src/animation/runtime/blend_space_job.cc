@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/blend_space_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/math_ex.h"
+
+namespace ozz {
+namespace animation {
+
+BlendSpaceJob::BlendSpaceJob()
+    : parameter(0.f), threshold(.05f), duration(nullptr) {}
+
+bool BlendSpaceJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = true;
+
+  // Test threshold range.
+  valid &= threshold >= 0.f && threshold < 1.f;
+
+  // At least one sample is required.
+  const size_t num_samples = samples.size();
+  valid &= num_samples != 0;
+  valid &= weights.size() >= num_samples;
+
+  // Durations are optional, unless duration is requested.
+  if (!durations.empty() || duration != nullptr) {
+    valid &= durations.size() >= num_samples;
+  }
+
+  return valid;
+}
+
+bool BlendSpaceJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Computes gradient band influence of each sample i. It's the minimum, for
+  // all other samples j, of the projection of the parameter onto [ij]
+  // segment, where i is 1 and j is 0.
+  const size_t num_samples = samples.size();
+  float sum = 0.f;
+  for (size_t i = 0; i < num_samples; ++i) {
+    const math::Float2& pi = samples[i];
+    const math::Float2 pip = parameter - pi;
+    float influence = 1.f;
+    for (size_t j = 0; j < num_samples; ++j) {
+      const math::Float2 pipj = samples[j] - pi;
+      const float len2 = LengthSqr(pipj);
+      if (len2 == 0.f) {  // Skips i itself and overlapping samples.
+        continue;
+      }
+      influence = math::Min(influence, 1.f - Dot(pip, pipj) / len2);
+    }
+    influence = math::Max(influence, 0.f);
+    weights[i] = influence;
+    sum += influence;
+  }
+
+  // The closest sample influence is at least .5, so sum can't be 0.
+  assert(sum > 0.f);
+
+  // Culls weights lower than the threshold, normalizing on the fly. The
+  // maximum weight is always kept, which ensures at least one sample remains.
+  float max_weight = 0.f;
+  for (size_t i = 0; i < num_samples; ++i) {
+    max_weight = math::Max(max_weight, weights[i]);
+  }
+  const float cull = math::Min(threshold * sum, max_weight);
+  float culled_sum = 0.f;
+  for (size_t i = 0; i < num_samples; ++i) {
+    const float weight = weights[i] < cull ? 0.f : weights[i];
+    weights[i] = weight;
+    culled_sum += weight;
+  }
+
+  // Normalizes remaining weights and computes blended duration.
+  const float inv_sum = 1.f / culled_sum;
+  float blended_duration = 0.f;
+  for (size_t i = 0; i < num_samples; ++i) {
+    const float weight = weights[i] * inv_sum;
+    weights[i] = weight;
+    if (!durations.empty()) {
+      blended_duration += durations[i] * weight;
+    }
+  }
+  if (duration) {
+    *duration = blended_duration;
+  }
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
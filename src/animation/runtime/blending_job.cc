@@ -77,6 +77,9 @@ bool BlendingJob::Validate() const {
   const size_t min_range = bind_pose.size();
   valid &= output.size() >= min_range;
 
+  // Dirty bits are optional, one bit per soa transform.
+  valid &= dirty.empty() || dirty.size() * 8 >= min_range;
+
   // Validates layers.
   for (const Layer& layer : layers) {
     valid &= ValidateLayer(layer, min_range);
@@ -158,15 +161,17 @@ namespace {
 
 // Defines parameters that are passed through blending stages.
 struct ProcessArgs {
-  ProcessArgs(const BlendingJob& _job)
+  ProcessArgs(const BlendingJob& _job, size_t _begin, size_t _end)
       : job(_job),
-        num_soa_joints(_job.bind_pose.size()),
+        begin(_begin),
+        end(_end),
         num_passes(0),
         num_partial_passes(0),
         accumulated_weight(0.f) {
     // The range of all buffers has already been validated.
-    assert(job.output.size() >= num_soa_joints);
-    assert(OZZ_ARRAY_SIZE(accumulated_weights) >= num_soa_joints);
+    assert(begin <= end && job.bind_pose.size() >= end);
+    assert(job.output.size() >= end);
+    assert(OZZ_ARRAY_SIZE(accumulated_weights) >= end);
   }
 
   // Allocates enough space to store a accumulated weights per-joint.
@@ -182,9 +187,10 @@ struct ProcessArgs {
   // The job to process.
   const BlendingJob& job;
 
-  // The number of transforms to process as defined by the size of the bind
-  // pose.
-  size_t num_soa_joints;
+  // The range [begin,end[ of soa transforms to process. The whole range is
+  // defined by the size of the bind pose.
+  size_t begin;
+  size_t end;
 
   // Number of processed blended passes (excluding passes with a weight <= 0.f),
   // including partial passes.
@@ -209,9 +215,9 @@ void BlendLayers(ProcessArgs* _args) {
   // Iterates through all layers and blend them to the output.
   for (const BlendingJob::Layer& layer : _args->job.layers) {
     // Asserts buffer sizes, which must never fail as it has been validated.
-    assert(layer.transform.size() >= _args->num_soa_joints);
+    assert(layer.transform.size() >= _args->end);
     assert(layer.joint_weights.empty() ||
-           (layer.joint_weights.size() >= _args->num_soa_joints));
+           (layer.joint_weights.size() >= _args->end));
 
     // Skip irrelevant layers.
     if (layer.weight <= 0.f) {
@@ -228,7 +234,7 @@ void BlendLayers(ProcessArgs* _args) {
       ++_args->num_partial_passes;
 
       if (_args->num_passes == 0) {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform* dest = _args->job.output.begin() + i;
           const math::SimdFloat4 weight =
@@ -237,7 +243,7 @@ void BlendLayers(ProcessArgs* _args) {
           OZZ_BLEND_1ST_PASS(src, weight, dest);
         }
       } else {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform* dest = _args->job.output.begin() + i;
           const math::SimdFloat4 weight =
@@ -250,14 +256,14 @@ void BlendLayers(ProcessArgs* _args) {
     } else {
       // This is a full layer.
       if (_args->num_passes == 0) {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform* dest = _args->job.output.begin() + i;
           _args->accumulated_weights[i] = layer_weight;
           OZZ_BLEND_1ST_PASS(src, layer_weight, dest);
         }
       } else {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform* dest = _args->job.output.begin() + i;
           _args->accumulated_weights[i] =
@@ -277,7 +283,7 @@ void BlendBindPose(ProcessArgs* _args) {
   assert(_args);
 
   // Asserts buffer sizes, which must never fail as it has been validated.
-  assert(_args->job.bind_pose.size() >= _args->num_soa_joints);
+  assert(_args->job.bind_pose.size() >= _args->end);
 
   if (_args->num_partial_passes == 0) {
     // No partial blending pass detected, threshold can be tested globally.
@@ -287,7 +293,7 @@ void BlendBindPose(ProcessArgs* _args) {
       if (_args->num_passes == 0) {
         // Strictly copying bind-pose.
         _args->accumulated_weight = 1.f;
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           _args->job.output[i] = _args->job.bind_pose[i];
         }
       } else {
@@ -298,7 +304,7 @@ void BlendBindPose(ProcessArgs* _args) {
         const math::SimdFloat4 simd_bp_weight =
             math::simd_float4::Load1(bp_weight);
 
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = _args->job.bind_pose[i];
           math::SoaTransform* dest = _args->job.output.begin() + i;
           OZZ_BLEND_N_PASS(src, simd_bp_weight, dest);
@@ -314,7 +320,7 @@ void BlendBindPose(ProcessArgs* _args) {
     // There's been at least 1 pass as num_partial_passes != 0.
     assert(_args->num_passes != 0);
 
-    for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+    for (size_t i = _args->begin; i < _args->end; ++i) {
       const math::SoaTransform& src = _args->job.bind_pose[i];
       math::SoaTransform* dest = _args->job.output.begin() + i;
       const math::SimdFloat4 bp_weight =
@@ -338,7 +344,7 @@ void Normalize(ProcessArgs* _args) {
     // division to all joints.
     const math::SimdFloat4 ratio =
         math::simd_float4::Load1(1.f / _args->accumulated_weight);
-    for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+    for (size_t i = _args->begin; i < _args->end; ++i) {
       math::SoaTransform& dest = _args->job.output[i];
       dest.rotation = NormalizeEst(dest.rotation);
       dest.translation = dest.translation * ratio;
@@ -347,7 +353,7 @@ void Normalize(ProcessArgs* _args) {
   } else {
     // Partial blending normalization requires to compute the divider per-joint.
     const math::SimdFloat4 one = math::simd_float4::one();
-    for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+    for (size_t i = _args->begin; i < _args->end; ++i) {
       const math::SimdFloat4 ratio = one / _args->accumulated_weights[i];
       math::SoaTransform& dest = _args->job.output[i];
       dest.rotation = NormalizeEst(dest.rotation);
@@ -364,9 +370,9 @@ void AddLayers(ProcessArgs* _args) {
   // Iterates through all layers and blend them to the output.
   for (const BlendingJob::Layer& layer : _args->job.additive_layers) {
     // Asserts buffer sizes, which must never fail as it has been validated.
-    assert(layer.transform.size() >= _args->num_soa_joints);
+    assert(layer.transform.size() >= _args->end);
     assert(layer.joint_weights.empty() ||
-           (layer.joint_weights.size() >= _args->num_soa_joints));
+           (layer.joint_weights.size() >= _args->end));
 
     // Prepares constants.
     const math::SimdFloat4 one = math::simd_float4::one();
@@ -378,7 +384,7 @@ void AddLayers(ProcessArgs* _args) {
 
       if (!layer.joint_weights.empty()) {
         // This layer has per-joint weights.
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           const math::SimdFloat4 weight =
@@ -394,7 +400,7 @@ void AddLayers(ProcessArgs* _args) {
         const math::SoaFloat3 one_minus_weight_f3 = {
             one_minus_weight, one_minus_weight, one_minus_weight};
 
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           OZZ_ADD_PASS(src, layer_weight, dest);
@@ -407,7 +413,7 @@ void AddLayers(ProcessArgs* _args) {
 
       if (!layer.joint_weights.empty()) {
         // This layer has per-joint weights.
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           const math::SimdFloat4 weight =
@@ -418,7 +424,7 @@ void AddLayers(ProcessArgs* _args) {
       } else {
         // This is a full layer.
         const math::SimdFloat4 one_minus_weight = one - layer_weight;
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           OZZ_SUB_PASS(src, layer_weight, dest);
@@ -429,6 +435,21 @@ void AddLayers(ProcessArgs* _args) {
     }
   }
 }
+
+// Processes all blending stages.
+void Blend(ProcessArgs* _args) {
+  // Blends all layers to the job output buffers.
+  BlendLayers(_args);
+
+  // Applies bind pose.
+  BlendBindPose(_args);
+
+  // Normalizes output.
+  Normalize(_args);
+
+  // Process additive blending.
+  AddLayers(_args);
+}
 }  // namespace
 
 bool BlendingJob::Run() const {
@@ -436,20 +457,34 @@ bool BlendingJob::Run() const {
     return false;
   }
 
-  // Initializes blended parameters that are exchanged across blend stages.
-  ProcessArgs process_args(*this);
-
-  // Blends all layers to the job output buffers.
-  BlendLayers(&process_args);
+  const size_t num_soa_joints = bind_pose.size();
+  if (dirty.empty()) {
+    // Initializes blended parameters that are exchanged across blend stages.
+    ProcessArgs process_args(*this, 0, num_soa_joints);
+    Blend(&process_args);
+    return true;
+  }
 
-  // Applies bind pose.
-  BlendBindPose(&process_args);
+  // Dirty bits require to compare blended transforms to the previous output.
+  // Transforms are thus processed by chunks, so that previous ones can be
+  // saved on the stack.
+  const size_t kChunkSize = 16;
+  for (size_t begin = 0; begin < num_soa_joints; begin += kChunkSize) {
+    const size_t end = math::Min(begin + kChunkSize, num_soa_joints);
+    math::SoaTransform previous[kChunkSize];
+    for (size_t i = begin; i < end; ++i) {
+      previous[i - begin] = output[i];
+    }
 
-  // Normalizes output.
-  Normalize(&process_args);
+    ProcessArgs process_args(*this, begin, end);
+    Blend(&process_args);
 
-  // Process additive blending.
-  AddLayers(&process_args);
+    for (size_t i = begin; i < end; ++i) {
+      if (!math::AreAllFalse(output[i] != previous[i - begin])) {
+        dirty[i / 8] |= 1 << (i & 7);
+      }
+    }
+  }
 
   return true;
 }
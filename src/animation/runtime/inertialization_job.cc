@@ -0,0 +1,187 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/inertialization_job.h"
+
+#include <cassert>
+#include <cmath>
+
+#include "ozz/base/maths/soa_transform.h"
+
+namespace ozz {
+namespace animation {
+
+InertializationCaptureJob::InertializationCaptureJob() : delta_time(0.f) {}
+
+bool InertializationCaptureJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = true;
+
+  // Velocity requires a time delta.
+  valid &= delta_time > 0.f;
+
+  // The target pose size defines the ranges of transforms to process, so all
+  // other buffers should be bigger.
+  const size_t min_range = target.size();
+  valid &= min_range != 0;
+  valid &= source.size() >= min_range;
+  valid &= previous_source.size() >= min_range;
+  valid &= offsets.size() >= min_range;
+
+  // Previous target is optional.
+  if (!previous_target.empty()) {
+    valid &= previous_target.size() >= min_range;
+  }
+
+  return valid;
+}
+
+namespace {
+
+// Computes the vector part of the quaternion that rotates _to to _from,
+// choosing the shortest path (aka positive w).
+OZZ_INLINE math::SoaFloat3 RotationOffset(const math::SoaQuaternion& _from,
+                                          const math::SoaQuaternion& _to) {
+  const math::SoaQuaternion offset = _from * Conjugate(_to);
+  const math::SimdInt4 sign = math::Sign(offset.w);
+  const math::SoaFloat3 ret = {math::Xor(offset.x, sign),
+                               math::Xor(offset.y, sign),
+                               math::Xor(offset.z, sign)};
+  return ret;
+}
+}  // namespace
+
+bool InertializationCaptureJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const math::SimdFloat4 inv_dt = math::simd_float4::Load1(1.f / delta_time);
+
+  // Target is considered static if previous target isn't provided.
+  const span<const math::SoaTransform>& prev_target =
+      previous_target.empty() ? target : previous_target;
+
+  const size_t num_soa_joints = target.size();
+  for (size_t i = 0; i < num_soa_joints; ++i) {
+    const math::SoaTransform& src = source[i];
+    const math::SoaTransform& prev_src = previous_source[i];
+    const math::SoaTransform& tgt = target[i];
+    const math::SoaTransform& prev_tgt = prev_target[i];
+    SoaInertializationOffset& offset = offsets[i];
+
+    // Offsets velocity is the derivative of offsets, which is equivalent to
+    // source velocity minus target velocity.
+    offset.translation = src.translation - tgt.translation;
+    offset.translation_velocity =
+        (offset.translation - (prev_src.translation - prev_tgt.translation)) *
+        inv_dt;
+
+    offset.rotation = RotationOffset(src.rotation, tgt.rotation);
+    const math::SoaFloat3 prev_rotation =
+        RotationOffset(prev_src.rotation, prev_tgt.rotation);
+    offset.rotation_velocity = (offset.rotation - prev_rotation) * inv_dt;
+
+    offset.scale = src.scale - tgt.scale;
+    offset.scale_velocity =
+        (offset.scale - (prev_src.scale - prev_tgt.scale)) * inv_dt;
+  }
+
+  return true;
+}
+
+InertializationJob::InertializationJob() : time(0.f), halflife(.1f) {}
+
+bool InertializationJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = true;
+
+  // Tests decay parameters.
+  valid &= halflife > 0.f;
+  valid &= time >= 0.f;
+
+  // The target pose size defines the ranges of transforms to process, so all
+  // other buffers should be bigger.
+  const size_t min_range = target.size();
+  valid &= min_range != 0;
+  valid &= offsets.size() >= min_range;
+  valid &= output.size() >= min_range;
+
+  return valid;
+}
+
+bool InertializationJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Critically damped spring decay of an offset x0 with velocity v0:
+  // x(t) = e^(-y.t) * (x0 + (v0 + y.x0).t)
+  //      = x0 * e^(-y.t).(1 + y.t) + v0 * e^(-y.t).t
+  // y is the damping coefficient, chosen so that e^(-y.h).(1 + y.h) = 1/2,
+  // where h is the halflife.
+  // Both coefficients only depend on time, so they can be computed once for
+  // all joints.
+  const float kHalflifeToDamping = 1.67834699f;
+  const float damping = kHalflifeToDamping / halflife;
+  const float decay = std::exp(-damping * time);
+  const math::SimdFloat4 offset_coeff =
+      math::simd_float4::Load1(decay * (1.f + damping * time));
+  const math::SimdFloat4 velocity_coeff =
+      math::simd_float4::Load1(decay * time);
+
+  const math::SimdFloat4 one = math::simd_float4::one();
+  const size_t num_soa_joints = target.size();
+  for (size_t i = 0; i < num_soa_joints; ++i) {
+    const SoaInertializationOffset& offset = offsets[i];
+    const math::SoaTransform& tgt = target[i];
+    math::SoaTransform& out = output[i];
+
+    out.translation = tgt.translation + offset.translation * offset_coeff +
+                      offset.translation_velocity * velocity_coeff;
+
+    // Rebuilds rotation offset quaternion from its vector part. w is clamped
+    // to 0 in case velocity extrapolated offset beyond a half turn.
+    const math::SoaFloat3 rotation = offset.rotation * offset_coeff +
+                                     offset.rotation_velocity * velocity_coeff;
+    const math::SimdFloat4 w2 = one - Dot(rotation, rotation);
+    const math::SoaQuaternion rotation_offset = {
+        rotation.x, rotation.y, rotation.z, math::Sqrt(math::Max0(w2))};
+    out.rotation = NormalizeEst(rotation_offset) * tgt.rotation;
+
+    out.scale = tgt.scale + offset.scale * offset_coeff +
+                offset.scale_velocity * velocity_coeff;
+  }
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -27,6 +27,7 @@
 
 #include "ozz/animation/runtime/local_to_model_job.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "ozz/base/maths/math_ex.h"
@@ -44,7 +45,9 @@ LocalToModelJob::LocalToModelJob()
       root(nullptr),
       from(Skeleton::kNoParent),
       to(Skeleton::kMaxJoints),
-      from_excluded(false) {}
+      from_excluded(false),
+      depth_ordered(false),
+      specialization(nullptr) {}
 
 bool LocalToModelJob::Validate() const {
   // Don't need any early out, as jobs are valid in most of the performance
@@ -62,11 +65,376 @@ bool LocalToModelJob::Validate() const {
 
   // Test input and output ranges, implicitly tests for nullptr end pointers.
   valid &= input.size() >= num_soa_joints;
-  valid &= output.size() >= num_joints;
+  if (!soa_output.empty()) {
+    valid &= soa_output.size() >= num_soa_joints;
+  } else if (!affine_output.empty()) {
+    valid &= affine_output.size() >= num_joints;
+  } else {
+    valid &= output.size() >= num_joints;
+  }
+
+  // Dirty bits are optional, one bit per soa input.
+  valid &= dirty.empty() || dirty.size() * 8 >= num_soa_joints;
+
+  // Specialization must match skeleton hierarchy.
+  if (specialization) {
+    const span<const int16_t>& parents = skeleton->joint_parents();
+    const span<const int16_t>& specialized = specialization->joint_parents;
+    valid &= specialization->function != nullptr;
+    valid &= specialized.size() == parents.size() &&
+             std::equal(parents.begin(), parents.end(), specialized.begin());
+  }
 
   return valid;
 }
 
+namespace {
+
+// Builds soa matrices from soa transforms. Scale multiplications are skipped
+// when the 4 joints have a unit scale, which is the case of most rigs as scale
+// is rarely animated.
+OZZ_INLINE math::SoaFloat4x4 LocalSoaMatrices(
+    const math::SoaTransform& _transform) {
+  if (math::AreAllTrue(_transform.scale == math::SoaFloat3::one())) {
+    return math::SoaFloat4x4::FromAffine(_transform.translation,
+                                         _transform.rotation);
+  }
+  return math::SoaFloat4x4::FromAffine(
+      _transform.translation, _transform.rotation, _transform.scale);
+}
+
+// Multiplies _parent matrix by _local affine matrix. Last row of _local being
+// [0 0 0 1], it's cheaper than a general matrix multiplication.
+OZZ_INLINE math::Float4x4 MultiplyAffine(const math::Float4x4& _parent,
+                                         const math::Float4x4& _local) {
+  const math::Float4x4 ret = {{math::TransformVector(_parent, _local.cols[0]),
+                               math::TransformVector(_parent, _local.cols[1]),
+                               math::TransformVector(_parent, _local.cols[2]),
+                               math::TransformPoint(_parent, _local.cols[3])}};
+  return ret;
+}
+
+// Loads the matrix of joint _lane from the soa matrix _soa.
+OZZ_INLINE void LoadLane(const math::SoaFloat4x4& _soa, int _lane,
+                         math::Float4x4* _out) {
+  const float* src = &reinterpret_cast<const float*>(_soa.cols)[_lane];
+  for (int c = 0; c < 4; ++c, src += 16) {
+    _out->cols[c] = math::simd_float4::Load(src[0], src[4], src[8], src[12]);
+  }
+}
+
+// Stores _in matrix to joint _lane of the soa matrix _soa.
+OZZ_INLINE void StoreLane(const math::Float4x4& _in, int _lane,
+                          math::SoaFloat4x4* _soa) {
+  float* dest = &reinterpret_cast<float*>(_soa->cols)[_lane];
+  for (int c = 0; c < 4; ++c, dest += 16) {
+    float col[4];
+    math::StorePtrU(_in.cols[c], col);
+    dest[0] = col[0];
+    dest[4] = col[1];
+    dest[8] = col[2];
+    dest[12] = col[3];
+  }
+}
+
+// Applies hierarchical transformation to soa output matrices. Iteration rules
+// are the same as the aos version.
+void RunSoa(const LocalToModelJob& _job, const math::Float4x4& _root_matrix) {
+  const span<const int16_t>& parents = _job.skeleton->joint_parents();
+  const int from = _job.from;
+
+  // Loop ends after "to".
+  const int end = math::Min(_job.to + 1, _job.skeleton->num_joints());
+  // Begins iteration from "from", or the next joint if "from" is excluded.
+  for (int i = math::Max(from + _job.from_excluded, 0),
+           process = i < end && (!_job.from_excluded || parents[i] >= from);
+       process;) {
+    // Builds soa matrices from soa transforms.
+    const math::SoaTransform& transform = _job.input[i / 4];
+    const math::SoaFloat4x4 local_soa_matrices = LocalSoaMatrices(transform);
+    math::SoaFloat4x4& model_soa_matrices = _job.soa_output[i / 4];
+
+    // The whole soa element can be computed at once if its 4 joints must be
+    // updated, and if their parents belong to previous soa elements (parents
+    // are always before their children).
+    const int soa_end = (i + 4) & ~3;
+    bool whole = (i & 3) == 0 && soa_end <= end;
+    for (int j = i; whole && j < soa_end; ++j) {
+      whole = parents[j] < i && (j == i || parents[j] >= from);
+    }
+
+    if (whole) {
+      // Gathers parents matrices.
+      math::Float4x4 parent_matrices[4];
+      for (int j = 0; j < 4; ++j) {
+        const int parent = parents[i + j];
+        if (parent == Skeleton::kNoParent) {
+          parent_matrices[j] = _root_matrix;
+        } else {
+          LoadLane(_job.soa_output[parent / 4], parent & 3,
+                   &parent_matrices[j]);
+        }
+      }
+      math::SoaFloat4x4 parent_soa_matrices;
+      for (int c = 0; c < 4; ++c) {
+        const math::SimdFloat4 cols[4] = {
+            parent_matrices[0].cols[c], parent_matrices[1].cols[c],
+            parent_matrices[2].cols[c], parent_matrices[3].cols[c]};
+        math::Transpose4x4(cols, &parent_soa_matrices.cols[c].x);
+      }
+
+      model_soa_matrices = parent_soa_matrices * local_soa_matrices;
+
+      i = soa_end;
+      process = i < end && parents[i] >= from;
+    } else {
+      // parents[i] >= from is true as long as "i" is a child of "from".
+      for (; i < soa_end && process;
+           ++i, process = i < end && parents[i] >= from) {
+        const int parent = parents[i];
+        math::Float4x4 parent_matrix;
+        if (parent == Skeleton::kNoParent) {
+          parent_matrix = _root_matrix;
+        } else {
+          LoadLane(_job.soa_output[parent / 4], parent & 3, &parent_matrix);
+        }
+        math::Float4x4 local_matrix;
+        LoadLane(local_soa_matrices, i & 3, &local_matrix);
+        StoreLane(MultiplyAffine(parent_matrix, local_matrix), i & 3,
+                  &model_soa_matrices);
+      }
+    }
+  }
+}
+
+// Applies hierarchical transformation to affine output matrices. Iteration
+// rules are the same as the aos version.
+void RunAffine(const LocalToModelJob& _job,
+               const math::Float4x4& _root_matrix) {
+  const span<const int16_t>& parents = _job.skeleton->joint_parents();
+  const int from = _job.from;
+  const math::Float3x4 root_matrix =
+      math::Float3x4::FromFloat4x4(_root_matrix);
+
+  // Loop ends after "to".
+  const int end = math::Min(_job.to + 1, _job.skeleton->num_joints());
+  // Begins iteration from "from", or the next joint if "from" is excluded.
+  for (int i = math::Max(from + _job.from_excluded, 0),
+           process = i < end && (!_job.from_excluded || parents[i] >= from);
+       process;) {
+    // Builds soa matrices from soa transforms.
+    const math::SoaTransform& transform = _job.input[i / 4];
+    const math::SoaFloat4x4 local_soa_matrices = LocalSoaMatrices(transform);
+
+    // Converts to affine matrices. Last row of local matrices is [0 0 0 1], so
+    // it doesn't need to be transposed.
+    math::SimdFloat4 local_rows[3][4];
+    for (int r = 0; r < 3; ++r) {
+      const math::SimdFloat4* cols = &local_soa_matrices.cols[0].x;
+      const math::SimdFloat4 row[4] = {cols[r], cols[4 + r], cols[8 + r],
+                                       cols[12 + r]};
+      math::Transpose4x4(row, local_rows[r]);
+    }
+
+    // parents[i] >= from is true as long as "i" is a child of "from".
+    for (const int soa_end = (i + 4) & ~3; i < soa_end && process;
+         ++i, process = i < end && parents[i] >= from) {
+      const math::Float3x4 local_matrix = {
+          {local_rows[0][i & 3], local_rows[1][i & 3], local_rows[2][i & 3]}};
+      const int parent = parents[i];
+      const math::Float3x4* parent_matrix =
+          parent == Skeleton::kNoParent ? &root_matrix
+                                        : &_job.affine_output[parent];
+      _job.affine_output[i] = *parent_matrix * local_matrix;
+    }
+  }
+}
+
+// Applies hierarchical transformation to joints whose soa input is dirty, or
+// whose parent was updated. Iteration rules are the same as the aos version.
+void RunDirty(const LocalToModelJob& _job, const math::Float4x4& _root_matrix) {
+  const span<const int16_t>& parents = _job.skeleton->joint_parents();
+  const int from = _job.from;
+
+  // One bit per joint, set when its model-space matrix is updated.
+  uint8_t updated[Skeleton::kMaxJoints / 8] = {0};
+
+  // Loop ends after "to".
+  const int end = math::Min(_job.to + 1, _job.skeleton->num_joints());
+  // Begins iteration from "from", or the next joint if "from" is excluded.
+  for (int i = math::Max(from + _job.from_excluded, 0),
+           process = i < end && (!_job.from_excluded || parents[i] >= from);
+       process;) {
+    const int soa = i / 4;
+    const bool dirty = (_job.dirty[soa / 8] & (1 << (soa & 7))) != 0;
+
+    // Local matrices are only built once a joint of the soa element needs to
+    // be updated.
+    bool built = false;
+    math::Float4x4 local_aos_matrices[4];
+
+    // parents[i] >= from is true as long as "i" is a child of "from".
+    for (const int soa_end = (i + 4) & ~3; i < soa_end && process;
+         ++i, process = i < end && parents[i] >= from) {
+      const int parent = parents[i];
+      const bool parent_updated =
+          parent != Skeleton::kNoParent &&
+          (updated[parent / 8] & (1 << (parent & 7))) != 0;
+      if (!dirty && !parent_updated) {
+        continue;
+      }
+
+      if (!built) {
+        const math::SoaTransform& transform = _job.input[soa];
+        const math::SoaFloat4x4 local_soa_matrices =
+            LocalSoaMatrices(transform);
+        math::Transpose16x16(&local_soa_matrices.cols[0].x,
+                             local_aos_matrices->cols);
+        built = true;
+      }
+
+      const math::Float4x4* parent_matrix =
+          parent == Skeleton::kNoParent ? &_root_matrix : &_job.output[parent];
+      _job.output[i] =
+          MultiplyAffine(*parent_matrix, local_aos_matrices[i & 3]);
+      updated[i / 8] |= 1 << (i & 7);
+    }
+  }
+}
+
+// Gathers local transforms of the 4 _joints to _out soa transform.
+OZZ_INLINE void GatherTransforms(const span<const math::SoaTransform>& _input,
+                                 const int16_t* _joints,
+                                 math::SoaTransform* _out) {
+  static_assert(sizeof(math::SoaTransform) == 40 * sizeof(float),
+                "Expects SoaTransform to be 10 SoaFloat4.");
+  float* dest = reinterpret_cast<float*>(_out);
+  for (int j = 0; j < 4; ++j) {
+    const int joint = _joints[j];
+    const float* src =
+        reinterpret_cast<const float*>(&_input[joint / 4]) + (joint & 3);
+    for (int c = 0; c < 10; ++c) {
+      dest[c * 4 + j] = src[c * 4];
+    }
+  }
+}
+
+// Computes model-space matrices of the _count joints of _group, whose local
+// transforms are _transform soa lanes. Parents must already be computed.
+// _group must contain 4 valid joints, even if _count is less than 4.
+void ComputeSoa(const LocalToModelJob& _job, const math::Float4x4& _root_matrix,
+                const math::SoaTransform& _transform, const int16_t* _group,
+                int _count) {
+  const span<const int16_t>& parents = _job.skeleton->joint_parents();
+
+  // Builds soa matrices from soa transforms.
+  const math::SoaFloat4x4 local_soa_matrices = LocalSoaMatrices(_transform);
+
+  // Gathers parents matrices. Siblings sharing the same parent (the most
+  // common case for wide hierarchies) don't need to be transposed.
+  const math::Float4x4* parent_matrices[4];
+  bool same_parent = true;
+  for (int j = 0; j < 4; ++j) {
+    const int parent = parents[_group[j]];
+    parent_matrices[j] =
+        parent == Skeleton::kNoParent ? &_root_matrix : &_job.output[parent];
+    same_parent &= parent_matrices[j] == parent_matrices[0];
+  }
+  math::SoaFloat4x4 parent_soa_matrices;
+  if (same_parent) {
+    for (int c = 0; c < 4; ++c) {
+      const math::SimdFloat4 col = parent_matrices[0]->cols[c];
+      const math::SoaFloat4 splat = {math::SplatX(col), math::SplatY(col),
+                                     math::SplatZ(col), math::SplatW(col)};
+      parent_soa_matrices.cols[c] = splat;
+    }
+  } else {
+    for (int c = 0; c < 4; ++c) {
+      const math::SimdFloat4 cols[4] = {
+          parent_matrices[0]->cols[c], parent_matrices[1]->cols[c],
+          parent_matrices[2]->cols[c], parent_matrices[3]->cols[c]};
+      math::Transpose4x4(cols, &parent_soa_matrices.cols[c].x);
+    }
+  }
+
+  const math::SoaFloat4x4 model_soa_matrices =
+      parent_soa_matrices * local_soa_matrices;
+
+  // Converts back to aos matrices.
+  math::Float4x4 model_matrices[4];
+  math::Transpose16x16(&model_soa_matrices.cols[0].x, model_matrices->cols);
+  for (int j = 0; j < _count; ++j) {
+    _job.output[_group[j]] = model_matrices[j];
+  }
+}
+
+// Computes model-space matrices of the _count (1 to 4) joints of _group, whose
+// local transforms need to be gathered from different soa elements.
+void ComputeGathered(const LocalToModelJob& _job,
+                     const math::Float4x4& _root_matrix, int16_t* _group,
+                     int _count) {
+  if (_count == 1) {
+    // A single joint doesn't benefit from SoA computation.
+    const int joint = _group[0];
+    const float* src =
+        reinterpret_cast<const float*>(&_job.input[joint / 4]) + (joint & 3);
+    const math::Float4x4 local_matrix = math::Float4x4::FromAffine(
+        math::simd_float4::Load(src[0], src[4], src[8], 0.f),
+        math::simd_float4::Load(src[12], src[16], src[20], src[24]),
+        math::simd_float4::Load(src[28], src[32], src[36], 0.f));
+    const int parent = _job.skeleton->joint_parents()[joint];
+    const math::Float4x4& parent_matrix =
+        parent == Skeleton::kNoParent ? _root_matrix : _job.output[parent];
+    _job.output[joint] = MultiplyAffine(parent_matrix, local_matrix);
+    return;
+  }
+
+  // Last joint is repeated if group isn't full.
+  for (int j = _count; j < 4; ++j) {
+    _group[j] = _group[_count - 1];
+  }
+  math::SoaTransform transform;
+  GatherTransforms(_job.input, _group, &transform);
+  ComputeSoa(_job, _root_matrix, transform, _group, _count);
+}
+
+// Computes all model-space matrices, level by level according to skeleton
+// depth layout. All parents of a level being computed, joints are processed 4
+// at a time in SoA. Soa elements whose 4 joints belong to the same level are
+// used as is, other joints are gathered.
+void RunDepthOrdered(const LocalToModelJob& _job,
+                     const math::Float4x4& _root_matrix) {
+  const span<const int16_t>& joints = _job.skeleton->joints_by_depth();
+  const span<const int16_t>& offsets = _job.skeleton->depth_offsets();
+
+  for (size_t l = 0; l + 1 < offsets.size(); ++l) {
+    const int level_end = offsets[l + 1];
+    int16_t gathered[4];
+    int num_gathered = 0;
+    for (int i = offsets[l]; i < level_end;) {
+      const int16_t joint = joints[i];
+      if ((joint & 3) == 0 && i + 3 < level_end && joints[i + 3] == joint + 3) {
+        const int16_t group[4] = {joint, static_cast<int16_t>(joint + 1),
+                                  static_cast<int16_t>(joint + 2),
+                                  static_cast<int16_t>(joint + 3)};
+        ComputeSoa(_job, _root_matrix, _job.input[joint / 4], group, 4);
+        i += 4;
+      } else {
+        gathered[num_gathered++] = joint;
+        ++i;
+        if (num_gathered == 4) {
+          ComputeGathered(_job, _root_matrix, gathered, 4);
+          num_gathered = 0;
+        }
+      }
+    }
+    if (num_gathered != 0) {
+      ComputeGathered(_job, _root_matrix, gathered, num_gathered);
+    }
+  }
+}
+}  // namespace
+
 bool LocalToModelJob::Run() const {
   if (!Validate()) {
     return false;
@@ -79,6 +447,32 @@ bool LocalToModelJob::Run() const {
   const math::Float4x4 identity = math::Float4x4::identity();
   const math::Float4x4* root_matrix = (root == nullptr) ? &identity : root;
 
+  if (!soa_output.empty()) {
+    RunSoa(*this, *root_matrix);
+    return true;
+  }
+  if (!affine_output.empty()) {
+    RunAffine(*this, *root_matrix);
+    return true;
+  }
+
+  if (!dirty.empty()) {
+    RunDirty(*this, *root_matrix);
+    return true;
+  }
+
+  // Specialized and depth ordered evaluations require the whole hierarchy to
+  // be updated.
+  const bool whole = from < 0 && to >= skeleton->num_joints() - 1;
+  if (specialization && whole) {
+    specialization->function(input.begin(), *root_matrix, output.begin());
+    return true;
+  }
+  if (depth_ordered && whole) {
+    RunDepthOrdered(*this, *root_matrix);
+    return true;
+  }
+
   // Applies hierarchical transformation.
   // Loop ends after "to".
   const int end = math::Min(to + 1, skeleton->num_joints());
@@ -90,8 +484,7 @@ bool LocalToModelJob::Run() const {
        process;) {
     // Builds soa matrices from soa transforms.
     const math::SoaTransform& transform = input[i / 4];
-    const math::SoaFloat4x4 local_soa_matrices = math::SoaFloat4x4::FromAffine(
-        transform.translation, transform.rotation, transform.scale);
+    const math::SoaFloat4x4 local_soa_matrices = LocalSoaMatrices(transform);
 
     // Converts to aos matrices.
     math::Float4x4 local_aos_matrices[4];
@@ -104,7 +497,7 @@ bool LocalToModelJob::Run() const {
       const int parent = parents[i];
       const math::Float4x4* parent_matrix =
           parent == Skeleton::kNoParent ? root_matrix : &output[parent];
-      output[i] = *parent_matrix * local_aos_matrices[i & 3];
+      output[i] = MultiplyAffine(*parent_matrix, local_aos_matrices[i & 3]);
     }
   }
   return true;
@@ -0,0 +1,190 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/model_blending_job.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_transform.h"
+
+namespace ozz {
+namespace animation {
+
+ModelBlendingJob::Layer::Layer() : weight(0.f) {}
+
+ModelBlendingJob::ModelBlendingJob() : threshold(.1f) {}
+
+bool ModelBlendingJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = true;
+
+  // Test for valid threshold).
+  valid &= threshold > 0.f;
+
+  // The bind pose size defines the ranges of matrices to blend, so all
+  // other buffers should be bigger.
+  const size_t min_range = bind_pose.size();
+  const size_t min_soa_range = (min_range + 3) / 4;
+  valid &= min_range != 0;
+  valid &= output.size() >= min_range;
+
+  // Validates layers.
+  for (const Layer& layer : layers) {
+    valid &= layer.transform.size() >= min_range;
+    // Joint weights are optional.
+    valid &= layer.joint_weights.empty() ||
+             layer.joint_weights.size() >= min_soa_range;
+  }
+
+  return valid;
+}
+
+namespace {
+
+// Loads _count (up to 4) matrices from _in to soa matrix _out. Missing
+// matrices are set to identity.
+void LoadSoa(const math::Float4x4* _in, size_t _count,
+             math::SoaFloat4x4* _out) {
+  math::Float4x4 padded[4];
+  if (_count < 4) {
+    for (size_t i = 0; i < 4; ++i) {
+      padded[i] = i < _count ? _in[i] : math::Float4x4::identity();
+    }
+    _in = padded;
+  }
+  for (int c = 0; c < 4; ++c) {
+    const math::SimdFloat4 cols[4] = {_in[0].cols[c], _in[1].cols[c],
+                                      _in[2].cols[c], _in[3].cols[c]};
+    math::Transpose4x4(cols, &_out->cols[c].x);
+  }
+}
+
+// Decomposes _count (up to 4) matrices from _in to soa transform _out.
+void Decompose(const math::Float4x4* _in, size_t _count,
+               math::SoaTransform* _out) {
+  math::SoaFloat4x4 matrices;
+  LoadSoa(_in, _count, &matrices);
+  // Matrices that can't be decomposed (null scale) still output a valid
+  // identity rotation and their null scale, so result is ignored.
+  math::ToAffine(matrices, &_out->translation, &_out->rotation, &_out->scale);
+}
+
+// Blends _in transform to _out, with weight _simd_weight.
+OZZ_INLINE void BlendPass(const math::SoaTransform& _in,
+                          math::SimdFloat4 _simd_weight,
+                          math::SoaTransform* _out) {
+  // Blends translation.
+  _out->translation = _out->translation + _in.translation * _simd_weight;
+  // Blends rotations, negates opposed quaternions to be sure to choose the
+  // shortest path between the two.
+  const math::SimdInt4 sign = math::Sign(Dot(_out->rotation, _in.rotation));
+  const math::SoaQuaternion rotation = {
+      math::Xor(_in.rotation.x, sign), math::Xor(_in.rotation.y, sign),
+      math::Xor(_in.rotation.z, sign), math::Xor(_in.rotation.w, sign)};
+  _out->rotation = _out->rotation + rotation * _simd_weight;
+  // Blends scales.
+  _out->scale = _out->scale + _in.scale * _simd_weight;
+}
+}  // namespace
+
+bool ModelBlendingJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const math::SimdFloat4 zero = math::simd_float4::zero();
+  const math::SimdFloat4 one = math::simd_float4::one();
+  const math::SimdFloat4 simd_threshold = math::simd_float4::Load1(threshold);
+
+  // Blends all layers 4 joints at a time, so that soa decomposition and
+  // recomposition are done once per group of joints.
+  const size_t num_joints = bind_pose.size();
+  for (size_t i = 0, soa = 0; i < num_joints; i += 4, ++soa) {
+    const size_t count = std::min(num_joints - i, size_t(4));
+
+    // Accumulated transform starts from zero, so that the first pass doesn't
+    // need to be handled specifically (quaternion sign test against a null
+    // quaternion is positive).
+    math::SoaTransform blended = {{zero, zero, zero},
+                                  {zero, zero, zero, zero},
+                                  {zero, zero, zero}};
+    math::SimdFloat4 accumulated_weight = zero;
+
+    for (const Layer& layer : layers) {
+      // Asserts buffer sizes, which must never fail as it has been validated.
+      assert(layer.transform.size() >= num_joints);
+      assert(layer.joint_weights.empty() || layer.joint_weights.size() > soa);
+
+      // Skip irrelevant layers.
+      if (layer.weight <= 0.f) {
+        continue;
+      }
+
+      math::SimdFloat4 weight = math::simd_float4::Load1(layer.weight);
+      if (!layer.joint_weights.empty()) {
+        weight = weight * math::Max0(layer.joint_weights[soa]);
+      }
+      accumulated_weight = accumulated_weight + weight;
+
+      math::SoaTransform transform;
+      Decompose(layer.transform.begin() + i, count, &transform);
+      BlendPass(transform, weight, &blended);
+    }
+
+    // Blends bind pose to the output if accumulated weight is less than the
+    // threshold value.
+    const math::SimdFloat4 bp_weight =
+        math::Max0(simd_threshold - accumulated_weight);
+    if (!math::AreAllFalse(math::CmpGt(bp_weight, zero))) {
+      math::SoaTransform transform;
+      Decompose(bind_pose.begin() + i, count, &transform);
+      BlendPass(transform, bp_weight, &blended);
+      accumulated_weight = math::Max(simd_threshold, accumulated_weight);
+    }
+
+    // Normalizes output. Quaternion length cannot be zero as opposed
+    // quaternions have been fixed up during blending passes.
+    const math::SimdFloat4 ratio = one / accumulated_weight;
+    const math::SoaFloat4x4 soa_matrices = math::SoaFloat4x4::FromAffine(
+        blended.translation * ratio, NormalizeEst(blended.rotation),
+        blended.scale * ratio);
+
+    // Converts back to aos matrices.
+    math::Float4x4 aos_matrices[4];
+    math::Transpose16x16(&soa_matrices.cols[0].x, aos_matrices->cols);
+    std::copy(aos_matrices, aos_matrices + count, output.begin() + i);
+  }
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/model_to_local_job.h"
+
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_transform.h"
+
+namespace ozz {
+namespace animation {
+
+ModelToLocalJob::ModelToLocalJob() : skeleton(nullptr), root(nullptr) {}
+
+bool ModelToLocalJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = true;
+
+  // Test for nullptr begin pointers.
+  if (!skeleton) {
+    return false;
+  }
+
+  const size_t num_joints = static_cast<size_t>(skeleton->num_joints());
+  const size_t num_soa_joints = (num_joints + 3) / 4;
+
+  // Test input and output ranges, implicitly tests for nullptr end pointers.
+  valid &= input.size() >= num_joints;
+  valid &= output.size() >= num_soa_joints;
+
+  return valid;
+}
+
+namespace {
+// Transposes 4 matrices to a soa matrix.
+OZZ_INLINE void ToSoa(const math::Float4x4* const _in[4],
+                      math::SoaFloat4x4* _out) {
+  for (int c = 0; c < 4; ++c) {
+    const math::SimdFloat4 cols[4] = {_in[0]->cols[c], _in[1]->cols[c],
+                                      _in[2]->cols[c], _in[3]->cols[c]};
+    math::Transpose4x4(cols, &_out->cols[c].x);
+  }
+}
+}  // namespace
+
+bool ModelToLocalJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const span<const int16_t>& parents = skeleton->joint_parents();
+  const int num_joints = skeleton->num_joints();
+
+  // Initializes an identity matrix that will be used for skeleton roots when
+  // no root matrix is provided, as well as for padding joints of the last soa
+  // element.
+  const math::Float4x4 identity = math::Float4x4::identity();
+  const math::Float4x4* root_matrix = (root == nullptr) ? &identity : root;
+
+  for (int i = 0; i < num_joints; i += 4) {
+    // Gathers joints and parents model-space matrices.
+    const math::Float4x4* models[4];
+    const math::Float4x4* parent_models[4];
+    for (int j = 0; j < 4; ++j) {
+      const int joint = i + j;
+      if (joint < num_joints) {
+        const int parent = parents[joint];
+        models[j] = &input[joint];
+        parent_models[j] =
+            parent == Skeleton::kNoParent ? root_matrix : &input[parent];
+      } else {
+        models[j] = &identity;
+        parent_models[j] = &identity;
+      }
+    }
+
+    math::SoaFloat4x4 soa_models;
+    ToSoa(models, &soa_models);
+    math::SoaFloat4x4 soa_parents;
+    ToSoa(parent_models, &soa_parents);
+
+    // Computes local matrices. Parents that aren't invertible (null scale)
+    // produce null local matrices, decomposed with a null scale.
+    math::SimdInt4 invertible;
+    const math::SoaFloat4x4 locals =
+        Invert(soa_parents, &invertible) * soa_models;
+
+    // Decomposes to local transforms.
+    math::SoaTransform& transform = output[i / 4];
+    ToAffine(locals, &transform.translation, &transform.rotation,
+             &transform.scale);
+  }
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
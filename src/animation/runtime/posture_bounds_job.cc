@@ -0,0 +1,143 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/posture_bounds_job.h"
+
+#include <limits>
+
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/box.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_float4x4.h"
+
+namespace ozz {
+namespace animation {
+
+PostureBoundsJob::PostureBoundsJob() : skeleton(nullptr), output(nullptr) {}
+
+bool PostureBoundsJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = true;
+
+  // Test for nullptr pointers.
+  if (!skeleton) {
+    return false;
+  }
+  valid &= output != nullptr;
+
+  const size_t num_joints = static_cast<size_t>(skeleton->num_joints());
+  const size_t num_soa_joints = (num_joints + 3) / 4;
+
+  // Test input ranges, implicitly tests for nullptr end pointers.
+  if (soa_input.empty()) {
+    valid &= input.size() >= num_joints;
+  } else {
+    valid &= soa_input.size() >= num_soa_joints;
+  }
+
+  return valid;
+}
+
+bool PostureBoundsJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const int num_joints = skeleton->num_joints();
+  if (num_joints == 0) {
+    *output = math::Box();
+    return true;
+  }
+
+  const math::SimdFloat4 max =
+      math::simd_float4::Load1(std::numeric_limits<float>::max());
+  math::SimdFloat4 box_min = max;
+  math::SimdFloat4 box_max = -max;
+
+  if (soa_input.empty()) {
+    for (int i = 0; i < num_joints; ++i) {
+      const math::SimdFloat4 position = input[i].cols[3];
+      box_min = math::Min(box_min, position);
+      box_max = math::Max(box_max, position);
+    }
+  } else {
+    // Finds min and max of each soa lane.
+    math::SimdFloat4 soa_min[3] = {max, max, max};
+    math::SimdFloat4 soa_max[3] = {-max, -max, -max};
+    const int num_full_soa_joints = num_joints / 4;
+    for (int i = 0; i < num_full_soa_joints; ++i) {
+      const math::SoaFloat4& position = soa_input[i].cols[3];
+      soa_min[0] = math::Min(soa_min[0], position.x);
+      soa_min[1] = math::Min(soa_min[1], position.y);
+      soa_min[2] = math::Min(soa_min[2], position.z);
+      soa_max[0] = math::Max(soa_max[0], position.x);
+      soa_max[1] = math::Max(soa_max[1], position.y);
+      soa_max[2] = math::Max(soa_max[2], position.z);
+    }
+
+    // Padding joints of the last soa element are replaced by the first joint
+    // of the element, which is always valid.
+    const int remaining = num_joints & 3;
+    if (remaining != 0) {
+      const math::SoaFloat4& position =
+          soa_input[num_full_soa_joints].cols[3];
+      const math::SimdInt4 padding = math::simd_int4::Load(
+          false, remaining < 2, remaining < 3, remaining < 4);
+      const math::SimdFloat4 x =
+          math::Select(padding, math::SplatX(position.x), position.x);
+      const math::SimdFloat4 y =
+          math::Select(padding, math::SplatX(position.y), position.y);
+      const math::SimdFloat4 z =
+          math::Select(padding, math::SplatX(position.z), position.z);
+      soa_min[0] = math::Min(soa_min[0], x);
+      soa_min[1] = math::Min(soa_min[1], y);
+      soa_min[2] = math::Min(soa_min[2], z);
+      soa_max[0] = math::Max(soa_max[0], x);
+      soa_max[1] = math::Max(soa_max[1], y);
+      soa_max[2] = math::Max(soa_max[2], z);
+    }
+
+    // Reduces soa lanes.
+    math::SimdFloat4 lanes_min[4];
+    math::Transpose3x4(soa_min, lanes_min);
+    math::SimdFloat4 lanes_max[4];
+    math::Transpose3x4(soa_max, lanes_max);
+    box_min = math::Min(math::Min(lanes_min[0], lanes_min[1]),
+                        math::Min(lanes_min[2], lanes_min[3]));
+    box_max = math::Max(math::Max(lanes_max[0], lanes_max[1]),
+                        math::Max(lanes_max[2], lanes_max[3]));
+  }
+
+  math::Store3PtrU(box_min, &output->min.x);
+  math::Store3PtrU(box_max, &output->max.x);
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
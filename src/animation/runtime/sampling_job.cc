@@ -71,6 +71,10 @@ bool SamplingJob::Validate() const {
   // Tests cache size.
   valid &= cache->max_soa_tracks() >= num_soa_tracks;
 
+  // Tests dirty bits size, one bit per soa track.
+  valid &= dirty.empty() ||
+           dirty.size() * 8 >= static_cast<size_t>(num_soa_tracks);
+
   return valid;
 }
 
@@ -266,7 +270,7 @@ void Interpolates(float _anim_ratio, int _num_soa_tracks,
                   const internal::InterpSoaFloat3* _translations,
                   const internal::InterpSoaQuaternion* _rotations,
                   const internal::InterpSoaFloat3* _scales,
-                  math::SoaTransform* _output) {
+                  math::SoaTransform* _output, uint8_t* _dirty) {
   const math::SimdFloat4 anim_ratio = math::simd_float4::Load1(_anim_ratio);
   for (int i = 0; i < _num_soa_tracks; ++i) {
     // Prepares interpolation coefficients.
@@ -283,12 +287,18 @@ void Interpolates(float _anim_ratio, int _num_soa_tracks,
     // Processes interpolations.
     // The lerp of the rotation uses the shortest path, because opposed
     // quaternions were negated during animation build stage (AnimationBuilder).
-    _output[i].translation = Lerp(_translations[i].value[0],
-                                  _translations[i].value[1], interp_t_ratio);
-    _output[i].rotation = NLerpEst(_rotations[i].value[0],
-                                   _rotations[i].value[1], interp_r_ratio);
-    _output[i].scale =
-        Lerp(_scales[i].value[0], _scales[i].value[1], interp_s_ratio);
+    const math::SoaTransform transform = {
+        Lerp(_translations[i].value[0], _translations[i].value[1],
+             interp_t_ratio),
+        NLerpEst(_rotations[i].value[0], _rotations[i].value[1],
+                 interp_r_ratio),
+        Lerp(_scales[i].value[0], _scales[i].value[1], interp_s_ratio)};
+
+    // Flags soa elements that differ from the previous output.
+    if (_dirty && !math::AreAllFalse(transform != _output[i])) {
+      _dirty[i / 8] |= 1 << (i & 7);
+    }
+    _output[i] = transform;
   }
 }
 }  // namespace
@@ -337,7 +347,8 @@ bool SamplingJob::Run() const {
 
   // Interpolates soa hot data.
   Interpolates(anim_ratio, num_soa_tracks, cache->soa_translations_,
-               cache->soa_rotations_, cache->soa_scales_, output.begin());
+               cache->soa_rotations_, cache->soa_scales_, output.begin(),
+               dirty.empty() ? nullptr : dirty.begin());
 
   return true;
 }
@@ -65,8 +65,10 @@ char* Skeleton::Allocate(size_t _chars_size, size_t _num_joints) {
       num_soa_joints * sizeof(math::SoaTransform);
   const size_t names_size = _num_joints * sizeof(char*);
   const size_t joint_parents_size = _num_joints * sizeof(int16_t);
-  const size_t buffer_size =
-      names_size + _chars_size + joint_parents_size + joint_bind_poses_size;
+  // Depth layout: sorted joints, and at most one level per joint (+1 offset).
+  const size_t depth_layout_size = (_num_joints * 2 + 1) * sizeof(int16_t);
+  const size_t buffer_size = names_size + _chars_size + joint_parents_size +
+                             depth_layout_size + joint_bind_poses_size;
 
   // Allocates whole buffer.
   span<char> buffer = {static_cast<char*>(memory::default_allocator()->Allocate(
@@ -82,6 +84,8 @@ char* Skeleton::Allocate(size_t _chars_size, size_t _num_joints) {
 
   // Parents, third biggest alignment.
   joint_parents_ = fill_span<int16_t>(buffer, _num_joints);
+  joints_by_depth_ = fill_span<int16_t>(buffer, _num_joints);
+  depth_offsets_ = fill_span<int16_t>(buffer, _num_joints + 1);
 
   // Remaning buffer will be used to store joint names.
   assert(buffer.size_bytes() == _chars_size &&
@@ -94,6 +98,43 @@ void Skeleton::Deallocate() {
   joint_bind_poses_ = {};
   joint_names_ = {};
   joint_parents_ = {};
+  joints_by_depth_ = {};
+  depth_offsets_ = {};
+}
+
+void Skeleton::BuildDepthLayout() {
+  const int num_joints = this->num_joints();
+  if (num_joints == 0) {
+    return;
+  }
+
+  // Computes joints depth, which is parent's one + 1, as parents are always
+  // before their children. Counts the number of joints per level at the same
+  // time, stored in the next level offset.
+  int16_t depths[kMaxJoints];
+  int16_t counts[kMaxJoints + 1] = {0};
+  int num_levels = 0;
+  for (int i = 0; i < num_joints; ++i) {
+    const int parent = joint_parents_[i];
+    const int depth = parent == kNoParent ? 0 : depths[parent] + 1;
+    depths[i] = static_cast<int16_t>(depth);
+    ++counts[depth + 1];
+    num_levels = math::Max(num_levels, depth + 1);
+  }
+
+  // Converts counts to offsets.
+  depth_offsets_ = {depth_offsets_.begin(),
+                    static_cast<size_t>(num_levels + 1)};
+  depth_offsets_[0] = 0;
+  for (int i = 0; i < num_levels; ++i) {
+    depth_offsets_[i + 1] = depth_offsets_[i] + counts[i + 1];
+    counts[i] = depth_offsets_[i];  // Reused as level write cursor.
+  }
+
+  // Sorts joints by level, keeping index order within a level.
+  for (int i = 0; i < num_joints; ++i) {
+    joints_by_depth_[counts[depths[i]]++] = static_cast<int16_t>(i);
+  }
 }
 
 void Skeleton::Save(ozz::io::OArchive& _archive) const {
@@ -156,6 +197,9 @@ void Skeleton::Load(ozz::io::IArchive& _archive, uint32_t _version) {
 
   _archive >> ozz::io::MakeArray(joint_parents_);
   _archive >> ozz::io::MakeArray(joint_bind_poses_);
+
+  // Depth layout isn't serialized, as it can be rebuilt from parents.
+  BuildDepthLayout();
 }
 }  // namespace animation
 }  // namespace ozz
@@ -27,6 +27,7 @@
 
 #include "ozz/animation/runtime/skeleton_utils.h"
 
+#include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/soa_transform.h"
 
 #include <assert.h>
@@ -60,5 +61,66 @@ ozz::math::Transform GetJointLocalBindPose(const Skeleton& _skeleton,
 
   return bind_pose;
 }
+
+void PartitionHierarchy(const Skeleton& _skeleton, int _num_tasks,
+                        HierarchyPartition* _partition) {
+  assert(_partition && _num_tasks > 0);
+  _partition->ancestors.clear();
+  _partition->subtrees.clear();
+  _partition->tasks.clear();
+
+  const span<const int16_t>& parents = _skeleton.joint_parents();
+  const int num_joints = _skeleton.num_joints();
+
+  // Computes the number of joints of each subtree. Children are always after
+  // their parent, so iterating backward accumulates whole subtrees.
+  ozz::vector<int> sizes(num_joints, 1);
+  for (int i = num_joints - 1; i >= 0; --i) {
+    const int parent = parents[i];
+    if (parent != Skeleton::kNoParent) {
+      sizes[parent] += sizes[i];
+    }
+  }
+
+  // Subtrees bigger than the threshold are split, so their root is an
+  // ancestor. As a parent subtree is always bigger than its children ones,
+  // ancestors of an ancestor are ancestors too.
+  const int threshold =
+      math::Max(1, (num_joints + _num_tasks - 1) / _num_tasks);
+  for (int i = 0; i < num_joints;) {
+    if (sizes[i] <= threshold) {
+      // Subtree joints are contiguous in depth-first order.
+      const JointRange subtree = {i, i + sizes[i] - 1};
+      _partition->subtrees.push_back(subtree);
+      i += sizes[i];
+    } else {
+      // Ancestors range is extended as long as LocalToModelJob would process
+      // joint i from range "from" (ie: i is a descendant of "from").
+      if (_partition->ancestors.empty() ||
+          _partition->ancestors.back().to != i - 1 ||
+          parents[i] < _partition->ancestors.back().from) {
+        const JointRange range = {i, i};
+        _partition->ancestors.push_back(range);
+      } else {
+        _partition->ancestors.back().to = i;
+      }
+      ++i;
+    }
+  }
+
+  // Groups subtrees in tasks.
+  int task_size = 0;
+  for (size_t i = 0; i < _partition->subtrees.size(); ++i) {
+    if (task_size == 0) {
+      _partition->tasks.push_back(static_cast<int>(i));
+    }
+    const JointRange& subtree = _partition->subtrees[i];
+    task_size += subtree.to - subtree.from + 1;
+    if (task_size >= threshold) {
+      task_size = 0;
+    }
+  }
+  _partition->tasks.push_back(static_cast<int>(_partition->subtrees.size()));
+}
 }  // namespace animation
 }  // namespace ozz
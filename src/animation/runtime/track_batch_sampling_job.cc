@@ -0,0 +1,236 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/track_batch_sampling_job.h"
+
+#include <cassert>
+
+#include "ozz/animation/runtime/track.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/simd_math.h"
+
+namespace ozz {
+namespace animation {
+namespace internal {
+
+namespace {
+
+// Number of samples interpolated at once.
+const int kSamplingLanes = 4;
+
+// Keyframes of kSamplingLanes samples, stored as structure of arrays so that
+// every component of all samples is interpolated with a single SIMD
+// instruction.
+template <typename _ValueType>
+struct SamplingLanes {
+  enum { kComponents = sizeof(_ValueType) / sizeof(float) };
+  static_assert(sizeof(_ValueType) == kComponents * sizeof(float),
+                "Value type must be made of floats");
+
+  SamplingLanes() : count(0) {}
+
+  float from[kComponents][kSamplingLanes];
+  float to[kComponents][kSamplingLanes];
+  float ratio[kSamplingLanes];
+  float ratio0[kSamplingLanes];
+  float ratio1[kSamplingLanes];
+  _ValueType* outputs[kSamplingLanes];
+  int count;
+};
+
+template <typename _ValueType>
+void SetLane(const _ValueType& _from, const _ValueType& _to, float _ratio,
+             float _ratio0, float _ratio1, _ValueType* _output,
+             SamplingLanes<_ValueType>* _lanes) {
+  const int lane = _lanes->count++;
+  const float* from = reinterpret_cast<const float*>(&_from);
+  const float* to = reinterpret_cast<const float*>(&_to);
+  for (int c = 0; c < SamplingLanes<_ValueType>::kComponents; ++c) {
+    _lanes->from[c][lane] = from[c];
+    _lanes->to[c][lane] = to[c];
+  }
+  _lanes->ratio[lane] = _ratio;
+  _lanes->ratio0[lane] = _ratio0;
+  _lanes->ratio1[lane] = _ratio1;
+  _lanes->outputs[lane] = _output;
+}
+
+// Searches _track keyframes for _ratio and pushes them to a new lane.
+// Constant values (step keyframes, track ends and default tracks) are pushed
+// with an alpha of 0, so that interpolation outputs them unchanged.
+template <typename _Track>
+void PushSample(const _Track& _track, float _ratio, TrackSamplingCache* _cache,
+                typename _Track::ValueType* _output,
+                SamplingLanes<typename _Track::ValueType>* _lanes) {
+  typedef typename _Track::ValueType ValueType;
+  const span<const float> ratios = _track.ratios();
+  const span<const ValueType> values = _track.values();
+  assert(ratios.size() == values.size() &&
+         _track.steps().size() * 8 >= values.size());
+
+  // Default track returns identity.
+  if (ratios.size() == 0) {
+    const ValueType identity = TrackPolicy<ValueType>::identity();
+    SetLane(identity, identity, 0.f, 0.f, 1.f, _output, _lanes);
+    return;
+  }
+
+  const size_t id1 = SearchTrackKey(ratios, _ratio, &_track, _cache);
+  const size_t id0 = id1 - 1;
+
+  const bool id0step = (_track.steps()[id0 / 8] & (1 << (id0 & 7))) != 0;
+  if (id0step || id1 == ratios.size()) {
+    SetLane(values[id0], values[id0], 0.f, 0.f, 1.f, _output, _lanes);
+  } else {
+    assert(_ratio >= ratios[id0] && _ratio < ratios[id1]);
+    SetLane(values[id0], values[id1], _ratio, ratios[id0], ratios[id1],
+            _output, _lanes);
+  }
+}
+
+// Interpolates all pushed lanes and writes them to their outputs.
+template <typename _ValueType>
+void FlushLanes(SamplingLanes<_ValueType>* _lanes) {
+  enum { kComponents = SamplingLanes<_ValueType>::kComponents };
+
+  // Unused lanes are set to constant values, avoiding processing garbage.
+  for (int lane = _lanes->count; lane < kSamplingLanes; ++lane) {
+    for (int c = 0; c < kComponents; ++c) {
+      _lanes->from[c][lane] = 0.f;
+      _lanes->to[c][lane] = 0.f;
+    }
+    _lanes->ratio[lane] = 0.f;
+    _lanes->ratio0[lane] = 0.f;
+    _lanes->ratio1[lane] = 1.f;
+  }
+
+  // Computes all interpolation coefficients at once.
+  const math::SimdFloat4 ratio = math::simd_float4::LoadPtrU(_lanes->ratio);
+  const math::SimdFloat4 ratio0 = math::simd_float4::LoadPtrU(_lanes->ratio0);
+  const math::SimdFloat4 ratio1 = math::simd_float4::LoadPtrU(_lanes->ratio1);
+  const math::SimdFloat4 alpha = (ratio - ratio0) / (ratio1 - ratio0);
+
+  // Interpolates each component of all lanes.
+  float lerped[kComponents][kSamplingLanes];
+  for (int c = 0; c < kComponents; ++c) {
+    const math::SimdFloat4 from = math::simd_float4::LoadPtrU(_lanes->from[c]);
+    const math::SimdFloat4 to = math::simd_float4::LoadPtrU(_lanes->to[c]);
+    math::StorePtrU(math::Lerp(from, to, alpha), lerped[c]);
+  }
+
+  // Scatters results to outputs.
+  for (int lane = 0; lane < _lanes->count; ++lane) {
+    float* output = reinterpret_cast<float*>(_lanes->outputs[lane]);
+    for (int c = 0; c < kComponents; ++c) {
+      output[c] = lerped[c][lane];
+    }
+  }
+  _lanes->count = 0;
+}
+}  // namespace
+
+template <typename _Track>
+TrackBatchSamplingJob<_Track>::TrackBatchSamplingJob() : ratio(0.f) {}
+
+template <typename _Track>
+bool TrackBatchSamplingJob<_Track>::Validate() const {
+  bool success = true;
+  success &= results.size() >= tracks.size();
+  success &= caches.empty() || caches.size() >= tracks.size();
+  for (const _Track* track : tracks) {
+    success &= track != nullptr;
+  }
+  return success;
+}
+
+template <typename _Track>
+bool TrackBatchSamplingJob<_Track>::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Clamps ratio in range [0,1].
+  const float clamped_ratio = math::Clamp(0.f, ratio, 1.f);
+
+  SamplingLanes<ValueType> lanes;
+  for (size_t i = 0; i < tracks.size(); ++i) {
+    TrackSamplingCache* cache = caches.empty() ? nullptr : &caches[i];
+    PushSample(*tracks[i], clamped_ratio, cache, &results[i], &lanes);
+    if (lanes.count == kSamplingLanes) {
+      FlushLanes(&lanes);
+    }
+  }
+  if (lanes.count != 0) {
+    FlushLanes(&lanes);
+  }
+  return true;
+}
+
+template <typename _Track>
+TrackMultiSamplingJob<_Track>::TrackMultiSamplingJob() : track(nullptr) {}
+
+template <typename _Track>
+bool TrackMultiSamplingJob<_Track>::Validate() const {
+  bool success = true;
+  success &= track != nullptr;
+  success &= results.size() >= ratios.size();
+  return success;
+}
+
+template <typename _Track>
+bool TrackMultiSamplingJob<_Track>::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  SamplingLanes<ValueType> lanes;
+  for (size_t i = 0; i < ratios.size(); ++i) {
+    // Clamps ratio in range [0,1].
+    const float clamped_ratio = math::Clamp(0.f, ratios[i], 1.f);
+    PushSample(*track, clamped_ratio, nullptr, &results[i], &lanes);
+    if (lanes.count == kSamplingLanes) {
+      FlushLanes(&lanes);
+    }
+  }
+  if (lanes.count != 0) {
+    FlushLanes(&lanes);
+  }
+  return true;
+}
+
+// Explicitly instantiate supported tracks.
+template struct TrackBatchSamplingJob<FloatTrack>;
+template struct TrackBatchSamplingJob<Float2Track>;
+template struct TrackBatchSamplingJob<Float3Track>;
+template struct TrackBatchSamplingJob<Float4Track>;
+template struct TrackMultiSamplingJob<FloatTrack>;
+template struct TrackMultiSamplingJob<Float2Track>;
+template struct TrackMultiSamplingJob<Float3Track>;
+template struct TrackMultiSamplingJob<Float4Track>;
+}  // namespace internal
+}  // namespace animation
+}  // namespace ozz
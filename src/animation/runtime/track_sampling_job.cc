@@ -34,11 +34,53 @@
 
 namespace ozz {
 namespace animation {
+
+TrackSamplingCache::TrackSamplingCache() : track_(nullptr), key_(0) {}
+
+void TrackSamplingCache::Invalidate() {
+  track_ = nullptr;
+  key_ = 0;
+}
+
 namespace internal {
 
+namespace {
+// Maximum number of keyframes stepped from the cached one, before falling
+// back to a binary search.
+const size_t kMaxCachedSteps = 4;
+}  // namespace
+
+size_t SearchTrackKey(span<const float> _ratios, float _ratio,
+                      const void* _track, TrackSamplingCache* _cache) {
+  // The cached key is used as a starting point if the ratio hasn't moved
+  // backward, in which case the next key is usually at most a few steps away.
+  size_t id1;
+  if (_cache && _cache->track_ == _track && _cache->key_ > 0 &&
+      _cache->key_ <= _ratios.size() && _ratios[_cache->key_ - 1] <= _ratio) {
+    id1 = _cache->key_;
+    const size_t steps_end = std::min(_ratios.size(), id1 + kMaxCachedSteps);
+    for (; id1 < steps_end && _ratios[id1] <= _ratio; ++id1) {
+    }
+    if (id1 < _ratios.size() && _ratios[id1] <= _ratio) {
+      id1 = std::upper_bound(_ratios.begin() + id1, _ratios.end(), _ratio) -
+            _ratios.begin();
+    }
+  } else {
+    id1 = std::upper_bound(_ratios.begin(), _ratios.end(), _ratio) -
+          _ratios.begin();
+  }
+
+  // Updates cache.
+  if (_cache) {
+    _cache->track_ = _track;
+    _cache->key_ = id1;
+  }
+  return id1;
+}
+
 template <typename _Track>
 TrackSamplingJob<_Track>::TrackSamplingJob()
-    : ratio(0.f), track(nullptr), result(nullptr) {}
+    : ratio(0.f), track(nullptr), cache(nullptr), result(nullptr) {}
 
 template <typename _Track>
 bool TrackSamplingJob<_Track>::Validate() const {
@@ -71,14 +113,11 @@ bool TrackSamplingJob<_Track>::Run() const {
 
   // Search for the first key frame with a ratio value greater than input ratio.
   // Our ratio is between this one and the previous one.
-  const float* ptk1 = std::upper_bound(ratios.begin(), ratios.end(), clamped_ratio);
-
-  // Deduce keys indices.
-  const size_t id1 = ptk1 - ratios.begin();
+  const size_t id1 = SearchTrackKey(ratios, clamped_ratio, track, cache);
   const size_t id0 = id1 - 1;
 
   const bool id0step = (track->steps()[id0 / 8] & (1 << (id0 & 7))) != 0;
-  if (id0step || ptk1 == ratios.end()) {
+  if (id0step || id1 == ratios.size()) {
     *result = values[id0];
   } else {
     // Lerp relevant keys.
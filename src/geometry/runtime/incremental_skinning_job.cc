@@ -0,0 +1,218 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/incremental_skinning_job.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "ozz/base/containers/vector_archive.h"
+#include "ozz/base/io/archive.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "geometry/runtime/vertex_stream.h"
+
+namespace ozz {
+namespace geometry {
+
+namespace {
+template <typename _Index>
+bool BuildSkinningIndexT(span<const _Index> _joint_indices, size_t _stride,
+                         int _influences_count, int _vertex_count,
+                         int _num_joints, int _max_gap,
+                         SkinningIndex* _index) {
+  if (!_index) {
+    return false;
+  }
+  _index->vertex_count = 0;
+  _index->joints.clear();
+  _index->ranges.clear();
+
+  // Validates arguments.
+  if (_influences_count <= 0 || _vertex_count < 0 || _num_joints < 0 ||
+      _max_gap < 0) {
+    return false;
+  }
+  if (!ValidateStream(_joint_indices, _stride,
+                      sizeof(_Index) * _influences_count, _vertex_count)) {
+    return false;
+  }
+
+  // Gathers ranges of each joint. As vertices are iterated in order, a joint
+  // range is either extended or a new one is pushed.
+  ozz::vector<ozz::vector<VertexRange>> joint_ranges(_num_joints);
+  for (int i = 0; i < _vertex_count; ++i) {
+    const _Index* indices = StreamElement(_joint_indices.data(), _stride, i);
+
+    // Vertices are indexed by pairs, starting at an even vertex.
+    const VertexRange pair = {i & ~1, std::min((i | 1) + 1, _vertex_count)};
+    for (int j = 0; j < _influences_count; ++j) {
+      const int joint = indices[j];
+      if (joint >= _num_joints) {
+        return false;
+      }
+      ozz::vector<VertexRange>& ranges = joint_ranges[joint];
+      if (!ranges.empty() && pair.begin <= ranges.back().end + _max_gap) {
+        ranges.back().end = pair.end;
+      } else {
+        ranges.push_back(pair);
+      }
+    }
+  }
+
+  // Flattens joints ranges.
+  _index->vertex_count = _vertex_count;
+  _index->joints.resize(_num_joints + 1);
+  for (int i = 0; i < _num_joints; ++i) {
+    _index->joints[i] = static_cast<int>(_index->ranges.size());
+    _index->ranges.insert(_index->ranges.end(), joint_ranges[i].begin(),
+                          joint_ranges[i].end());
+  }
+  _index->joints[_num_joints] = static_cast<int>(_index->ranges.size());
+
+  return true;
+}
+}  // namespace
+
+bool BuildSkinningIndex(span<const uint16_t> _joint_indices, size_t _stride,
+                        int _influences_count, int _vertex_count,
+                        int _num_joints, int _max_gap, SkinningIndex* _index) {
+  return BuildSkinningIndexT(_joint_indices, _stride, _influences_count,
+                             _vertex_count, _num_joints, _max_gap, _index);
+}
+
+bool BuildSkinningIndex(span<const uint8_t> _joint_indices, size_t _stride,
+                        int _influences_count, int _vertex_count,
+                        int _num_joints, int _max_gap, SkinningIndex* _index) {
+  return BuildSkinningIndexT(_joint_indices, _stride, _influences_count,
+                             _vertex_count, _num_joints, _max_gap, _index);
+}
+
+IncrementalSkinningJob::IncrementalSkinningJob()
+    : index(nullptr), out_skinned_count(nullptr) {}
+
+bool IncrementalSkinningJob::Validate() const {
+  bool valid = job.Validate();
+  valid &= job.out_bounds == nullptr;
+  if (!index || index->joints.empty()) {
+    return false;
+  }
+  valid &= index->vertex_count == job.vertex_count;
+  const size_t num_joints = index->joints.size() - 1;
+  valid &= changed.size() >= (num_joints + 7) / 8;
+  valid &= scratch.size() >= index->ranges.size();
+  return valid;
+}
+
+bool IncrementalSkinningJob::Run() const {
+  // Exit with an error if job is invalid.
+  if (!Validate()) {
+    return false;
+  }
+
+  // Gathers ranges of changed joints.
+  size_t count = 0;
+  const int num_joints = static_cast<int>(index->joints.size()) - 1;
+  for (int i = 0; i < num_joints; ++i) {
+    if (changed[i / 8] & (1 << (i & 7))) {
+      for (int r = index->joints[i]; r < index->joints[i + 1]; ++r) {
+        scratch[count++] = index->ranges[r];
+      }
+    }
+  }
+
+  // Sorts ranges, so that overlapping and contiguous ones can be merged.
+  std::sort(scratch.begin(), scratch.begin() + count,
+            [](const VertexRange& _a, const VertexRange& _b) {
+              return _a.begin < _b.begin;
+            });
+
+  // Skins merged ranges.
+  int skinned = 0;
+  for (size_t i = 0; i < count;) {
+    VertexRange range = scratch[i];
+    for (++i; i < count && scratch[i].begin <= range.end; ++i) {
+      range.end = std::max(range.end, scratch[i].end);
+    }
+    const bool success =
+        job.Range(range.begin, range.end - range.begin).Run();
+    (void)success;
+    assert(success);
+    skinned += range.end - range.begin;
+  }
+
+  if (out_skinned_count) {
+    *out_skinned_count = skinned;
+  }
+
+  return true;
+}
+}  // namespace geometry
+
+namespace io {
+
+void Extern<geometry::SkinningIndex>::Save(
+    OArchive& _archive, const geometry::SkinningIndex* _indices,
+    size_t _count) {
+  for (size_t i = 0; i < _count; ++i) {
+    const geometry::SkinningIndex& index = _indices[i];
+    _archive << static_cast<int32_t>(index.vertex_count);
+    _archive << index.joints;
+    const uint32_t ranges = static_cast<uint32_t>(index.ranges.size());
+    _archive << ranges;
+    for (const geometry::VertexRange& range : index.ranges) {
+      _archive << static_cast<int32_t>(range.begin);
+      _archive << static_cast<int32_t>(range.end);
+    }
+  }
+}
+
+void Extern<geometry::SkinningIndex>::Load(IArchive& _archive,
+                                           geometry::SkinningIndex* _indices,
+                                           size_t _count, uint32_t _version) {
+  (void)_version;
+  for (size_t i = 0; i < _count; ++i) {
+    geometry::SkinningIndex& index = _indices[i];
+    int32_t vertex_count;
+    _archive >> vertex_count;
+    index.vertex_count = vertex_count;
+    _archive >> index.joints;
+    uint32_t ranges;
+    _archive >> ranges;
+    index.ranges.resize(ranges);
+    for (geometry::VertexRange& range : index.ranges) {
+      int32_t begin, end;
+      _archive >> begin;
+      _archive >> end;
+      range.begin = begin;
+      range.end = end;
+    }
+  }
+}
+}  // namespace io
+}  // namespace ozz
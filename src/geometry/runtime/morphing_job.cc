@@ -0,0 +1,288 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/morphing_job.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "ozz/base/maths/box.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "geometry/runtime/vertex_stream.h"
+
+namespace ozz {
+namespace geometry {
+
+namespace {
+// Number of vertices morphed per chunk when fused with skinning. It's even so
+// that chunks are skinned with bitwise identical results to the whole mesh.
+const int kMorphChunkSize = 64;
+
+// Copies _count vertices from _in to _out, unless they're the same.
+void CopyVertices(const float* _in, size_t _in_stride, float* _out,
+                  size_t _out_stride, int _count) {
+  if (_in == _out && _in_stride == _out_stride) {
+    return;
+  }
+  for (int i = 0; i < _count; ++i) {
+    const float* in = StreamElement(_in, _in_stride, i);
+    float* out = StreamElement(_out, _out_stride, i);
+    out[0] = in[0];
+    out[1] = in[1];
+    out[2] = in[2];
+  }
+}
+
+// Accumulates _deltas of target _vertices [_first,_last[, scaled by _scale, to
+// _out whose first vertex is _begin.
+void AccumulateDeltas(const int* _vertices, const int16_t* _deltas,
+                      size_t _first, size_t _last, float _scale, int _begin,
+                      float* _out, size_t _stride) {
+  const math::SimdFloat4 scale = math::simd_float4::Load1(_scale);
+  const int16_t* deltas = _deltas + _first * 3;
+  for (size_t i = _first; i < _last; ++i, deltas += 3) {
+    float* out = StreamElement(_out, _stride, _vertices[i] - _begin);
+    const math::SimdInt4 q =
+        math::simd_int4::Load(deltas[0], deltas[1], deltas[2], 0);
+    const math::SimdFloat4 morphed =
+        math::MAdd(math::simd_float4::FromInt(q), scale,
+                   math::simd_float4::Load3PtrU(out));
+    math::Store3PtrU(morphed, out);
+  }
+}
+
+// Morphs vertices [_begin,_begin + _count[ of _job to _positions and
+// _normals, whose first vertex is _begin. _normals is nullptr if there's no
+// normals to morph.
+void Morph(const MorphingJob& _job, int _begin, int _count, float* _positions,
+           size_t _positions_stride, float* _normals, size_t _normals_stride) {
+  CopyVertices(
+      StreamElement(_job.in_positions.data(), _job.in_positions_stride, _begin),
+      _job.in_positions_stride, _positions, _positions_stride, _count);
+  if (_normals) {
+    CopyVertices(
+        StreamElement(_job.in_normals.data(), _job.in_normals_stride, _begin),
+        _job.in_normals_stride, _normals, _normals_stride, _count);
+  }
+
+  const int end = _begin + _count;
+  for (size_t i = 0; i < _job.targets.size(); ++i) {
+    // Skips targets with no effect.
+    const float weight = _job.weights[i];
+    if (weight == 0.f) {
+      continue;
+    }
+
+    // Finds target vertices in range [_begin,end[.
+    const MorphTarget& target = _job.targets[i];
+    const int* vertices = target.vertices.data();
+    const int* vertices_end = vertices + target.vertices.size();
+    const int* first = std::lower_bound(vertices, vertices_end, _begin);
+    const int* last = std::lower_bound(first, vertices_end, end);
+    if (first == last) {
+      continue;
+    }
+
+    AccumulateDeltas(vertices, target.position_deltas.data(), first - vertices,
+                     last - vertices, weight * target.position_scale, _begin,
+                     _positions, _positions_stride);
+    if (_normals && !target.normal_deltas.empty()) {
+      AccumulateDeltas(vertices, target.normal_deltas.data(), first - vertices,
+                       last - vertices, weight * target.normal_scale, _begin,
+                       _normals, _normals_stride);
+    }
+  }
+}
+}  // namespace
+
+bool BuildMorphTarget(span<const float> _position_deltas,
+                      span<const float> _normal_deltas, int _vertex_count,
+                      float _threshold, MorphTarget* _target) {
+  if (!_target) {
+    return false;
+  }
+  *_target = MorphTarget();
+
+  // Validates arguments.
+  if (_vertex_count < 0 || !(_threshold >= 0.f)) {
+    return false;
+  }
+  const size_t count = static_cast<size_t>(_vertex_count) * 3;
+  if (_position_deltas.size() < count ||
+      (!_normal_deltas.empty() && _normal_deltas.size() < count)) {
+    return false;
+  }
+
+  // Finds moved vertices and deltas range.
+  float max_position = 0.f;
+  float max_normal = 0.f;
+  for (int i = 0; i < _vertex_count; ++i) {
+    bool moved = false;
+    for (int j = i * 3; j < i * 3 + 3; ++j) {
+      const float position = std::abs(_position_deltas[j]);
+      const float normal =
+          _normal_deltas.empty() ? 0.f : std::abs(_normal_deltas[j]);
+      moved |= position > _threshold || normal > _threshold;
+      max_position = std::max(max_position, position);
+      max_normal = std::max(max_normal, normal);
+    }
+    if (moved) {
+      _target->vertices.push_back(i);
+    }
+  }
+
+  // Quantizes deltas of moved vertices.
+  _target->position_scale = max_position / kSnorm16;
+  _target->normal_scale = max_normal / kSnorm16;
+  const float position_rcp =
+      max_position > 0.f ? kSnorm16 / max_position : 0.f;
+  const float normal_rcp = max_normal > 0.f ? kSnorm16 / max_normal : 0.f;
+  for (int vertex : _target->vertices) {
+    for (int j = vertex * 3; j < vertex * 3 + 3; ++j) {
+      _target->position_deltas.push_back(static_cast<int16_t>(
+          std::floor(_position_deltas[j] * position_rcp + .5f)));
+      if (!_normal_deltas.empty()) {
+        _target->normal_deltas.push_back(static_cast<int16_t>(
+            std::floor(_normal_deltas[j] * normal_rcp + .5f)));
+      }
+    }
+  }
+
+  return true;
+}
+
+MorphingJob::MorphingJob()
+    : vertex_count(0),
+      in_positions_stride(0),
+      in_normals_stride(0),
+      out_positions_stride(0),
+      out_normals_stride(0),
+      skinning(nullptr) {}
+
+bool MorphingJob::Validate() const {
+  // Don't stop validation on the first failure.
+  bool valid = vertex_count >= 0;
+
+  // Checks targets.
+  valid &= weights.size() >= targets.size();
+  for (const MorphTarget& target : targets) {
+    const size_t count = target.vertices.size() * 3;
+    valid &= target.position_deltas.size() == count;
+    valid &=
+        target.normal_deltas.empty() || target.normal_deltas.size() == count;
+    valid &= target.vertices.empty() || (target.vertices.front() >= 0 &&
+                                         target.vertices.back() < vertex_count);
+  }
+
+  // Checks inputs.
+  valid &= ValidateStream(in_positions, in_positions_stride, sizeof(float) * 3,
+                          vertex_count);
+  if (!in_normals.empty()) {
+    valid &= ValidateStream(in_normals, in_normals_stride, sizeof(float) * 3,
+                            vertex_count);
+  }
+
+  // Checks outputs, which are those of the skinning job if morphing is fused.
+  if (skinning) {
+    valid &= skinning->Validate();
+    valid &= skinning->vertex_count == vertex_count;
+    valid &= out_positions.empty() && out_normals.empty();
+    if (!in_normals.empty()) {
+      valid &= !skinning->in_normals.empty() ||
+               !skinning->in_octahedral_normals.empty();
+    }
+  } else {
+    valid &= ValidateStream(out_positions, out_positions_stride,
+                            sizeof(float) * 3, vertex_count);
+    if (!in_normals.empty()) {
+      valid &= ValidateStream(out_normals, out_normals_stride,
+                              sizeof(float) * 3, vertex_count);
+    }
+  }
+
+  return valid;
+}
+
+bool MorphingJob::Run() const {
+  // Exit with an error if job is invalid.
+  if (!Validate()) {
+    return false;
+  }
+
+  if (!skinning) {
+    Morph(*this, 0, vertex_count, out_positions.data(), out_positions_stride,
+          in_normals.empty() ? nullptr : out_normals.data(),
+          out_normals_stride);
+    return true;
+  }
+
+  // Morphs by chunks to local buffers, used as skinning input. Buffers are
+  // padded as skinning functions load 4 floats per vertex.
+  float positions[kMorphChunkSize * 3 + 1];
+  float normals[kMorphChunkSize * 3 + 1];
+  const size_t stride = sizeof(float) * 3;
+  math::Box bounds;
+  for (int begin = 0; begin < vertex_count; begin += kMorphChunkSize) {
+    const int count = std::min(vertex_count - begin, kMorphChunkSize);
+    const bool has_normals = !in_normals.empty();
+    Morph(*this, begin, count, positions, stride,
+          has_normals ? normals : nullptr, stride);
+
+    SkinningJob chunk = skinning->Range(begin, count);
+    chunk.in_positions = {positions, count * 3u};
+    chunk.in_positions_stride = stride;
+    chunk.in_half_positions = {};
+    chunk.in_snorm16_positions = {};
+    if (has_normals) {
+      chunk.in_normals = {normals, count * 3u};
+      chunk.in_normals_stride = stride;
+      chunk.in_octahedral_normals = {};
+    }
+
+    // Bounds of all chunks are merged.
+    math::Box chunk_bounds;
+    if (chunk.out_bounds) {
+      chunk.out_bounds = &chunk_bounds;
+    }
+    const bool success = chunk.Run();
+    (void)success;
+    assert(success);
+    bounds = math::Merge(bounds, chunk_bounds);
+  }
+  if (skinning->out_bounds) {
+    *skinning->out_bounds = bounds;
+  }
+
+  return true;
+}
+}  // namespace geometry
+}  // namespace ozz
@@ -0,0 +1,115 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/parallel_skinning_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/box.h"
+
+namespace ozz {
+namespace geometry {
+
+namespace {
+// Default chunk size. 2048 vertices with positions, normals, tangents and 4
+// influences are around 200KB of input and output data.
+const int kDefaultChunkSize = 2048;
+
+// Returns chunk size rounded up to an even number, so that chunks are
+// skinned with bitwise identical results to the whole job (see
+// SkinningJob::Range()).
+int EvenChunkSize(int _chunk_size) { return _chunk_size + (_chunk_size & 1); }
+
+// Skins chunk _chunk of the ParallelSkinningJob _context.
+void RunChunk(const void* _context, int _chunk) {
+  const ParallelSkinningJob& parallel =
+      *static_cast<const ParallelSkinningJob*>(_context);
+  const int chunk_size = EvenChunkSize(parallel.chunk_size);
+  const int begin = _chunk * chunk_size;
+  const int remaining = parallel.job.vertex_count - begin;
+  assert(remaining > 0);
+  SkinningJob chunk = parallel.job.Range(
+      begin, remaining < chunk_size ? remaining : chunk_size);
+  if (chunk.out_bounds) {
+    chunk.out_bounds = &parallel.chunk_bounds[_chunk];
+  }
+  const bool success = chunk.Run();
+  (void)success;
+  assert(success);
+}
+}  // namespace
+
+ParallelSkinningJob::ParallelSkinningJob()
+    : chunk_size(kDefaultChunkSize),
+      parallel_for(nullptr),
+      user_data(nullptr) {}
+
+bool ParallelSkinningJob::Validate() const {
+  bool valid = job.Validate();
+  valid &= chunk_size > 0;
+  if (job.out_bounds) {
+    valid &= chunk_bounds.size() >= static_cast<size_t>(num_chunks());
+  }
+  return valid;
+}
+
+int ParallelSkinningJob::num_chunks() const {
+  if (chunk_size <= 0 || job.vertex_count <= 0) {
+    return 0;
+  }
+  const int even_chunk_size = EvenChunkSize(chunk_size);
+  return (job.vertex_count + even_chunk_size - 1) / even_chunk_size;
+}
+
+bool ParallelSkinningJob::Run() const {
+  // Exit with an error if job is invalid.
+  if (!Validate()) {
+    return false;
+  }
+
+  const int chunks = num_chunks();
+  if (parallel_for == nullptr || chunks < 2) {
+    for (int i = 0; i < chunks; ++i) {
+      RunChunk(this, i);
+    }
+  } else {
+    parallel_for(&RunChunk, this, chunks, user_data);
+  }
+
+  // Merges chunks bounds.
+  if (job.out_bounds) {
+    math::Box bounds;
+    for (int i = 0; i < chunks; ++i) {
+      bounds = math::Merge(bounds, chunk_bounds[i]);
+    }
+    *job.out_bounds = bounds;
+  }
+
+  return true;
+}
+}  // namespace geometry
+}  // namespace ozz
@@ -0,0 +1,141 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/skinning_influences.h"
+
+#include <algorithm>
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "geometry/runtime/vertex_stream.h"
+
+namespace ozz {
+namespace geometry {
+
+namespace {
+bool GreaterWeight(const Influence& _a, const Influence& _b) {
+  return _a.weight > _b.weight;
+}
+}  // namespace
+
+void SortInfluences(span<Influence> _influences) {
+  std::stable_sort(_influences.begin(), _influences.end(), GreaterWeight);
+}
+
+bool SortInfluences(span<uint16_t> _joint_indices, size_t _indices_stride,
+                    span<float> _joint_weights, size_t _weights_stride,
+                    int _influences_count, int _vertex_count) {
+  // Validates arguments.
+  if (_influences_count <= 0 || _influences_count > kMaxCompactInfluences ||
+      _vertex_count < 0) {
+    return false;
+  }
+  if (!ValidateStream(_joint_indices, _indices_stride,
+                      sizeof(uint16_t) * _influences_count, _vertex_count) ||
+      !ValidateStream(_joint_weights, _weights_stride,
+                      sizeof(float) * (_influences_count - 1), _vertex_count)) {
+    return false;
+  }
+
+  // Nothing to sort.
+  const int last = _influences_count - 1;
+  if (last == 0) {
+    return true;
+  }
+
+  Influence influences[kMaxCompactInfluences];
+  for (int i = 0; i < _vertex_count; ++i) {
+    uint16_t* indices =
+        StreamElement(_joint_indices.data(), _indices_stride, i);
+    float* weights = StreamElement(_joint_weights.data(), _weights_stride, i);
+
+    // Restores last weight.
+    float sum = 0.f;
+    for (int j = 0; j < last; ++j) {
+      influences[j].joint = indices[j];
+      influences[j].weight = weights[j];
+      sum += weights[j];
+    }
+    influences[last].joint = indices[last];
+    influences[last].weight = 1.f - sum;
+
+    SortInfluences({influences, static_cast<size_t>(_influences_count)});
+
+    for (int j = 0; j < last; ++j) {
+      indices[j] = influences[j].joint;
+      weights[j] = influences[j].weight;
+    }
+    indices[last] = influences[last].joint;
+  }
+  return true;
+}
+
+bool BuildLODWeights(span<const float> _joint_weights, size_t _weights_stride,
+                     int _influences_count, int _lod_influences_count,
+                     int _vertex_count, span<float> _lod_weights) {
+  // Validates arguments.
+  if (_lod_influences_count < 2 ||
+      _lod_influences_count > _influences_count || _vertex_count < 0) {
+    return false;
+  }
+  const int lod_weights = _lod_influences_count - 1;
+  if (!ValidateStream(_joint_weights, _weights_stride,
+                      sizeof(float) * (_influences_count - 1), _vertex_count) ||
+      _lod_weights.size() < static_cast<size_t>(lod_weights) * _vertex_count) {
+    return false;
+  }
+
+  float* out = _lod_weights.data();
+  for (int i = 0; i < _vertex_count; ++i, out += lod_weights) {
+    const float* weights =
+        StreamElement(_joint_weights.data(), _weights_stride, i);
+
+    // Sums kept weights. The last one isn't stored if all influences are kept.
+    float sum = 0.f;
+    for (int j = 0; j < lod_weights; ++j) {
+      sum += weights[j];
+    }
+    const float kept = _lod_influences_count == _influences_count
+                           ? 1.f
+                           : sum + weights[lod_weights];
+
+    // Kept weights are equally distributed if they're all 0.
+    if (kept > 0.f) {
+      const float rcp = 1.f / kept;
+      for (int j = 0; j < lod_weights; ++j) {
+        out[j] = weights[j] * rcp;
+      }
+    } else {
+      for (int j = 0; j < lod_weights; ++j) {
+        out[j] = 1.f / _lod_influences_count;
+      }
+    }
+  }
+  return true;
+}
+}  // namespace geometry
+}  // namespace ozz
@@ -28,8 +28,17 @@
 #include "ozz/geometry/runtime/skinning_job.h"
 
 #include <cassert>
+#include <cmath>
+#include <limits>
 
+#include "ozz/base/maths/box.h"
+#include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "geometry/runtime/vertex_stream.h"
 
 namespace ozz {
 namespace geometry {
@@ -40,11 +49,29 @@ SkinningJob::SkinningJob()
       joint_indices_stride(0),
       joint_weights_stride(0),
       in_positions_stride(0),
+      in_positions_scale(math::Float3::one()),
+      in_positions_offset(math::Float3::zero()),
       in_normals_stride(0),
       in_tangents_stride(0),
+      in_qtangents_stride(0),
       out_positions_stride(0),
       out_normals_stride(0),
-      out_tangents_stride(0) {}
+      out_tangents_stride(0),
+      out_qtangents_stride(0),
+      out_previous_positions_stride(0),
+      out_bounds(nullptr) {}
+
+namespace {
+// Validates a vector stream provided either as _floats or as _octahedral.
+template <typename _Float, typename _Octahedral>
+bool ValidateVectors(span<_Float> _floats, span<_Octahedral> _octahedral,
+                     size_t _stride, int _count) {
+  if (!_octahedral.empty()) {
+    return ValidateStream(_octahedral, _stride, sizeof(int16_t) * 2, _count);
+  }
+  return ValidateStream(_floats, _stride, sizeof(float) * 3, _count);
+}
+}  // namespace
 
 bool SkinningJob::Validate() const {
   // Start validation of all parameters.
@@ -53,58 +80,123 @@ bool SkinningJob::Validate() const {
   // Checks influences bounds.
   valid &= influences_count > 0;
 
-  // Checks joints matrices, required.
-  valid &= !joint_matrices.empty();
+  // Checks joints matrices, required. Only one matrix type can be used.
+  const int matrix_types = !joint_matrices.empty() +
+                           !joint_affine_matrices.empty() +
+                           !joint_dual_quaternions.empty();
+  valid &= matrix_types == 1;
+  if (joint_matrices.empty()) {
+    valid &= joint_inverse_transpose_matrices.empty();
+  }
+  if (joint_affine_matrices.empty()) {
+    valid &= joint_inverse_transpose_affine_matrices.empty();
+  }
 
-  // Prepares local variables used to compute buffer size.
-  const int vertex_count_minus_1 = vertex_count > 0 ? vertex_count - 1 : 0;
-  const int vertex_count_at_least_1 = vertex_count > 0;
+  // Checks previous frame palette, optional, which must be of the same type
+  // as joints matrices.
+  const int previous_types = !joint_previous_matrices.empty() +
+                             !joint_previous_affine_matrices.empty() +
+                             !joint_previous_dual_quaternions.empty();
+  valid &= previous_types <= 1;
+  valid &= joint_previous_matrices.empty() || !joint_matrices.empty();
+  valid &= joint_previous_affine_matrices.empty() ||
+           !joint_affine_matrices.empty();
+  valid &= joint_previous_dual_quaternions.empty() ||
+           !joint_dual_quaternions.empty();
+  valid &= (previous_types == 0) == out_previous_positions.empty();
+  if (previous_types != 0) {
+    valid &=
+        ValidateStream(out_previous_positions, out_previous_positions_stride,
+                       sizeof(float) * 3, vertex_count);
+  }
 
-  // Checks indices, required.
-  valid &= joint_indices.size_bytes() >=
-           joint_indices_stride * vertex_count_minus_1 +
-               sizeof(uint16_t) * influences_count * vertex_count_at_least_1;
+  // Checks indices, required. Only one format can be used.
+  valid &= joint_indices.empty() || joint_compact_indices.empty();
+  if (joint_compact_indices.empty()) {
+    valid &= ValidateStream(joint_indices, joint_indices_stride,
+                            sizeof(uint16_t) * influences_count, vertex_count);
+  } else {
+    valid &= ValidateStream(joint_compact_indices, joint_indices_stride,
+                            sizeof(uint8_t) * influences_count, vertex_count);
+  }
 
   // Checks weights, required if influences_count > 1.
   if (influences_count != 1) {
-    valid &=
-        joint_weights.size_bytes() >=
-        joint_weights_stride * vertex_count_minus_1 +
-            sizeof(float) * (influences_count - 1) * vertex_count_at_least_1;
+    valid &= joint_weights.empty() || joint_compact_weights.empty();
+    if (joint_compact_weights.empty()) {
+      valid &= ValidateStream(joint_weights, joint_weights_stride,
+                              sizeof(float) * (influences_count - 1),
+                              vertex_count);
+    } else {
+      valid &= ValidateStream(joint_compact_weights, joint_weights_stride,
+                              sizeof(uint8_t) * (influences_count - 1),
+                              vertex_count);
+    }
+  }
+
+  // Compact indices and weights are limited to kMaxCompactInfluences.
+  if (!joint_compact_indices.empty() || !joint_compact_weights.empty()) {
+    valid &= influences_count <= kMaxCompactInfluences;
   }
 
-  // Checks positions, mandatory.
-  valid &= in_positions.size_bytes() >=
-           in_positions_stride * vertex_count_minus_1 +
-               sizeof(float) * 3 * vertex_count_at_least_1;
-  valid &= !out_positions.empty();
-  valid &= out_positions.size_bytes() >=
-           out_positions_stride * vertex_count_minus_1 +
-               sizeof(float) * 3 * vertex_count_at_least_1;
+  // Checks positions, mandatory. Only one format can be used.
+  const int in_positions_formats = !in_positions.empty() +
+                                   !in_half_positions.empty() +
+                                   !in_snorm16_positions.empty();
+  valid &= in_positions_formats <= 1;
+  if (!in_half_positions.empty()) {
+    valid &= ValidateStream(in_half_positions, in_positions_stride,
+                            sizeof(uint16_t) * 3, vertex_count);
+  } else if (!in_snorm16_positions.empty()) {
+    valid &= ValidateStream(in_snorm16_positions, in_positions_stride,
+                            sizeof(int16_t) * 3, vertex_count);
+  } else {
+    valid &= ValidateStream(in_positions, in_positions_stride,
+                            sizeof(float) * 3, vertex_count);
+  }
+  valid &= out_positions.empty() != out_half_positions.empty();
+  if (!out_half_positions.empty()) {
+    valid &= ValidateStream(out_half_positions, out_positions_stride,
+                            sizeof(uint16_t) * 3, vertex_count);
+  } else {
+    valid &= ValidateStream(out_positions, out_positions_stride,
+                            sizeof(float) * 3, vertex_count);
+  }
 
   // Checks normals, optional.
-  if (!in_normals.empty()) {
-    valid &= in_normals.size_bytes() >=
-             in_normals_stride * vertex_count_minus_1 +
-                 sizeof(float) * 3 * vertex_count_at_least_1;
-    valid &= !out_normals.empty();
-    valid &= out_normals.size_bytes() >=
-             out_normals_stride * vertex_count_minus_1 +
-                 sizeof(float) * 3 * vertex_count_at_least_1;
+  if (!in_normals.empty() || !in_octahedral_normals.empty()) {
+    valid &= in_normals.empty() || in_octahedral_normals.empty();
+    valid &= ValidateVectors(in_normals, in_octahedral_normals,
+                             in_normals_stride, vertex_count);
+    valid &= out_normals.empty() != out_octahedral_normals.empty();
+    valid &= ValidateVectors(out_normals, out_octahedral_normals,
+                             out_normals_stride, vertex_count);
 
     // Checks tangents, optional but requires normals.
-    if (!in_tangents.empty()) {
-      valid &= in_tangents.size_bytes() >=
-               in_tangents_stride * vertex_count_minus_1 +
-                   sizeof(float) * 3 * vertex_count_at_least_1;
-      valid &= !out_tangents.empty();
-      valid &= out_tangents.size_bytes() >=
-               out_tangents_stride * vertex_count_minus_1 +
-                   sizeof(float) * 3 * vertex_count_at_least_1;
+    if (!in_tangents.empty() || !in_octahedral_tangents.empty()) {
+      valid &= in_tangents.empty() || in_octahedral_tangents.empty();
+      valid &= ValidateVectors(in_tangents, in_octahedral_tangents,
+                               in_tangents_stride, vertex_count);
+      valid &= out_tangents.empty() != out_octahedral_tangents.empty();
+      valid &= ValidateVectors(out_tangents, out_octahedral_tangents,
+                               out_tangents_stride, vertex_count);
     }
   } else {
     // Tangents are not supported if normals are not there.
-    valid &= in_tangents.empty();
+    valid &= in_tangents.empty() && in_octahedral_tangents.empty();
+  }
+
+  // Checks QTangents, optional, which replace normals and tangents. They
+  // require a rotation palette matching joint matrices type.
+  if (!in_qtangents.empty()) {
+    valid &= in_normals.empty() && in_octahedral_normals.empty();
+    valid &= ValidateStream(in_qtangents, in_qtangents_stride,
+                            sizeof(int16_t) * 4, vertex_count);
+    valid &= ValidateStream(out_qtangents, out_qtangents_stride,
+                            sizeof(int16_t) * 4, vertex_count);
+    valid &= joint_rotations.empty() != joint_dual_quaternions.empty();
+  } else {
+    valid &= out_qtangents.empty() && joint_rotations.empty();
   }
 
   return valid;
@@ -117,20 +209,81 @@ bool SkinningJob::Validate() const {
 // define a skeleton code (SKINNING_FN) for the skinning loop, which internally
 // calls MACRO that are shared or specialized according to skinning variants.
 
+// Scales matrix _m by weight _w, which is expected to be splat. Overloads
+// allow skinning functions to be instantiated for 4x4 and affine 3x4
+// matrices, as well as dual quaternions.
+// The 3 arguments version is used for all influences but the first one, _m0
+// being the matrix of the first influence.
+namespace {
+OZZ_INLINE math::Float4x4 WeightMatrix(const math::Float4x4& _m,
+                                       math::_SimdFloat4 _w) {
+  return math::ColumnMultiply(_m, _w);
+}
+
+OZZ_INLINE math::Float4x4 WeightMatrix(const math::Float4x4& _m,
+                                       math::_SimdFloat4 _w,
+                                       const math::Float4x4&) {
+  return math::ColumnMultiply(_m, _w);
+}
+
+OZZ_INLINE math::Float3x4 WeightMatrix(const math::Float3x4& _m,
+                                       math::_SimdFloat4 _w) {
+  return math::RowMultiply(_m, _w);
+}
+
+OZZ_INLINE math::Float3x4 WeightMatrix(const math::Float3x4& _m,
+                                       math::_SimdFloat4 _w,
+                                       const math::Float3x4&) {
+  return math::RowMultiply(_m, _w);
+}
+
+OZZ_INLINE math::SimdDualQuaternion WeightMatrix(
+    const math::SimdDualQuaternion& _m, math::_SimdFloat4 _w) {
+  const math::SimdDualQuaternion ret = {{_m.real.xyzw * _w},
+                                        {_m.dual.xyzw * _w}};
+  return ret;
+}
+
+// _m and -_m represent the same transformation, but they would cancel each
+// other out when blended. The weight is negated if _m isn't in the same
+// hemisphere as the first influence _m0.
+OZZ_INLINE math::SimdDualQuaternion WeightMatrix(
+    const math::SimdDualQuaternion& _m, math::_SimdFloat4 _w,
+    const math::SimdDualQuaternion& _m0) {
+  const math::SimdFloat4 sign =
+      math::And(math::SplatX(math::Dot4(_m.real.xyzw, _m0.real.xyzw)),
+                math::simd_int4::mask_sign());
+  return WeightMatrix(_m, math::Xor(_w, sign));
+}
+}  // namespace
+
 // Defines the skeleton code for the per vertex skinning loop.
-#define SKINNING_FN(_type, _it, _inf)                                        \
-  void SKINNING_FN_NAME(_type, _it, _inf)(const SkinningJob& _job) {         \
-    ASSERT_##_type() ASSERT_##_it() INIT_##_type() INIT_W##_inf()            \
-        const int loops = _job.vertex_count - 1;                             \
-    for (int i = 0; i < loops; ++i) {                                        \
-      PREPARE_##_inf##_INNER(_it) TRANSFORM_##_type##_INNER() NEXT_##_type() \
-          NEXT_W##_inf()                                                     \
-    }                                                                        \
-    PREPARE_##_inf##_OUTER(_it) TRANSFORM_##_type##_OUTER()                  \
+// _prev variants also skin positions with the previous frame palette.
+// Positions bounds are accumulated to _bounds (min and max) if _bounded.
+#define SKINNING_FN(_type, _it, _prev, _inf)                                  \
+  template <typename _Matrix, bool _bounded>                                  \
+  void SKINNING_FN_NAME(_type, _it, _prev, _inf)(                             \
+      const SkinningJob& _job, span<const _Matrix> _matrices,                 \
+      span<const _Matrix> _it_matrices, span<const _Matrix> _prev_matrices,   \
+      math::SimdFloat4* _bounds) {                                            \
+    (void)_it_matrices;                                                       \
+    (void)_prev_matrices;                                                     \
+    ASSERT_##_type() ASSERT_##_it() ASSERT_##_prev() INIT_##_type()           \
+        INIT_##_prev() INIT_W##_inf() INIT_BOUNDS() const int loops =         \
+            _job.vertex_count - 1;                                            \
+    for (int i = 0; i < loops; ++i) {                                         \
+      PREPARE_##_inf##_INNER(_it) PREPARE_##_prev##_##_inf()                  \
+          TRANSFORM_##_type##_INNER() TRANSFORM_##_prev() BOUNDS()            \
+              NEXT_##_type() NEXT_##_prev() NEXT_W##_inf()                    \
+    }                                                                         \
+    PREPARE_##_inf##_OUTER(_it) PREPARE_##_prev##_##_inf()                    \
+        TRANSFORM_##_type##_OUTER() TRANSFORM_##_prev() BOUNDS()              \
+            STORE_BOUNDS()                                                    \
   }
 
 // Defines skinning function name.
-#define SKINNING_FN_NAME(_type, _it, _inf) Skinning##_type##_it##_inf
+#define SKINNING_FN_NAME(_type, _it, _prev, _inf) \
+  Skinning##_type##_it##_prev##_inf
 
 // Implements pre-conditions assertions.
 #define ASSERT_P()                                          \
@@ -147,7 +300,12 @@ bool SkinningJob::Validate() const {
 
 #define ASSERT_NOIT()
 
-#define ASSERT_IT() assert(!_job.joint_inverse_transpose_matrices.empty());
+#define ASSERT_IT() assert(!_it_matrices.empty());
+
+#define ASSERT_NOPREV()
+
+#define ASSERT_PREV() \
+  assert(!_prev_matrices.empty() && !_job.out_previous_positions.empty());
 
 // Implements loop initializations for positions, ...
 #define INIT_P()                                              \
@@ -165,6 +323,12 @@ bool SkinningJob::Validate() const {
   const float* in_tangents = _job.in_tangents.begin(); \
   float* out_tangents = _job.out_tangents.begin();
 
+// Implements loop initializations for previous positions.
+#define INIT_NOPREV()
+
+#define INIT_PREV() \
+  float* out_previous_positions = _job.out_previous_positions.begin();
+
 // Implements loop initializations for weights.
 // Note that if the number of influences per vertex is 1, then there's no weight
 // as it's implicitly 1.
@@ -180,6 +344,25 @@ bool SkinningJob::Validate() const {
 
 #define INIT_WN() INIT_W2()
 
+// Implements positions bounds initialization, accumulation and storage.
+#define INIT_BOUNDS()                                    \
+  math::SimdFloat4 bounds_min =                          \
+      _bounded ? _bounds[0] : math::simd_float4::zero(); \
+  math::SimdFloat4 bounds_max =                          \
+      _bounded ? _bounds[1] : math::simd_float4::zero();
+
+#define BOUNDS()                               \
+  if (_bounded) {                              \
+    bounds_min = math::Min(bounds_min, out_p); \
+    bounds_max = math::Max(bounds_max, out_p); \
+  }
+
+#define STORE_BOUNDS()       \
+  if (_bounded) {            \
+    _bounds[0] = bounds_min; \
+    _bounds[1] = bounds_max; \
+  }
+
 // Implements pointer striding.
 #define NEXT(_type, _current, _stride) \
   reinterpret_cast<_type>(reinterpret_cast<uintptr_t>(_current) + _stride)
@@ -211,72 +394,74 @@ bool SkinningJob::Validate() const {
   in_tangents = NEXT(const float*, in_tangents, _job.in_tangents_stride); \
   out_tangents = NEXT(float*, out_tangents, _job.out_tangents_stride);
 
+#define NEXT_NOPREV()
+
+#define NEXT_PREV()                                             \
+  out_previous_positions = NEXT(float*, out_previous_positions, \
+                                _job.out_previous_positions_stride);
+
 // Implements weighted matrix preparation.
 // _INNER functions are intended to be used inside the vertex loop. They take
 // advantage of the fact that the buffers they are reading from contain enough
 // remaining data to use more optimized SIMD load functions. At the opposite,
 // _OUTER functions restrict access to data that are sure to be readable from
 // the buffer.
-#define PREPARE_1_INNER(_it)                                 \
-  const uint16_t i0 = joint_indices[0];                      \
-  const math::Float4x4& transform = _job.joint_matrices[i0]; \
+#define PREPARE_1_INNER(_it)                \
+  const uint16_t i0 = joint_indices[0];     \
+  const _Matrix& transform = _matrices[i0]; \
   PREPARE_##_it##_1()
 
 #define PREPARE_1_OUTER(_it) PREPARE_1_INNER(_it)
 
-#define PREPARE_NOIT()                            \
-  const math::Float4x4& it_transform = transform; \
+#define PREPARE_NOIT()                     \
+  const _Matrix& it_transform = transform; \
   (void)it_transform;
 
 #define PREPARE_NOIT_1() PREPARE_NOIT()
 
-#define PREPARE_IT_1()                 \
-  const math::Float4x4& it_transform = \
-      _job.joint_inverse_transpose_matrices[i0];
+#define PREPARE_IT_1() const _Matrix& it_transform = _it_matrices[i0];
 
 #define PREPARE_2_INNER(_it)                                                   \
   const math::SimdFloat4 w0 = math::simd_float4::Load1PtrU(joint_weights + 0); \
   const uint16_t i0 = joint_indices[0];                                        \
   const uint16_t i1 = joint_indices[1];                                        \
-  const math::Float4x4& m0 = _job.joint_matrices[i0];                          \
-  const math::Float4x4& m1 = _job.joint_matrices[i1];                          \
+  const _Matrix& m0 = _matrices[i0];                                           \
+  const _Matrix& m1 = _matrices[i1];                                           \
   const math::SimdFloat4 w1 = one - w0;                                        \
-  const math::Float4x4 transform =                                             \
-      math::ColumnMultiply(m0, w0) + math::ColumnMultiply(m1, w1);             \
+  const _Matrix transform = WeightMatrix(m0, w0) + WeightMatrix(m1, w1, m0);   \
   PREPARE_##_it##_2()
 
 #define PREPARE_NOIT_2() PREPARE_NOIT()
 
-#define PREPARE_IT_2()                                                    \
-  const math::Float4x4& mit0 = _job.joint_inverse_transpose_matrices[i0]; \
-  const math::Float4x4& mit1 = _job.joint_inverse_transpose_matrices[i1]; \
-  const math::Float4x4 it_transform =                                     \
-      math::ColumnMultiply(mit0, w0) + math::ColumnMultiply(mit1, w1);
+#define PREPARE_IT_2()                    \
+  const _Matrix& mit0 = _it_matrices[i0]; \
+  const _Matrix& mit1 = _it_matrices[i1]; \
+  const _Matrix it_transform = WeightMatrix(mit0, w0) + WeightMatrix(mit1, w1);
 
 #define PREPARE_2_OUTER(_it) PREPARE_2_INNER(_it)
 
-#define PREPARE_3_CONCAT(_it)                                     \
-  const uint16_t i0 = joint_indices[0];                           \
-  const uint16_t i1 = joint_indices[1];                           \
-  const uint16_t i2 = joint_indices[2];                           \
-  const math::Float4x4& m0 = _job.joint_matrices[i0];             \
-  const math::Float4x4& m1 = _job.joint_matrices[i1];             \
-  const math::Float4x4& m2 = _job.joint_matrices[i2];             \
-  const math::SimdFloat4 w2 = one - (w0 + w1);                    \
-  const math::Float4x4 transform = math::ColumnMultiply(m0, w0) + \
-                                   math::ColumnMultiply(m1, w1) + \
-                                   math::ColumnMultiply(m2, w2);  \
+#define PREPARE_3_CONCAT(_it)                          \
+  const uint16_t i0 = joint_indices[0];                \
+  const uint16_t i1 = joint_indices[1];                \
+  const uint16_t i2 = joint_indices[2];                \
+  const _Matrix& m0 = _matrices[i0];                   \
+  const _Matrix& m1 = _matrices[i1];                   \
+  const _Matrix& m2 = _matrices[i2];                   \
+  const math::SimdFloat4 w2 = one - (w0 + w1);         \
+  const _Matrix transform = WeightMatrix(m0, w0) +     \
+                            WeightMatrix(m1, w1, m0) + \
+                            WeightMatrix(m2, w2, m0);  \
   PREPARE_##_it##_3()
 
 #define PREPARE_NOIT_3() PREPARE_NOIT()
 
-#define PREPARE_IT_3()                                                    \
-  const math::Float4x4& mit0 = _job.joint_inverse_transpose_matrices[i0]; \
-  const math::Float4x4& mit1 = _job.joint_inverse_transpose_matrices[i1]; \
-  const math::Float4x4& mit2 = _job.joint_inverse_transpose_matrices[i2]; \
-  const math::Float4x4 it_transform = math::ColumnMultiply(mit0, w0) +    \
-                                      math::ColumnMultiply(mit1, w1) +    \
-                                      math::ColumnMultiply(mit2, w2);
+#define PREPARE_IT_3()                                  \
+  const _Matrix& mit0 = _it_matrices[i0];               \
+  const _Matrix& mit1 = _it_matrices[i1];               \
+  const _Matrix& mit2 = _it_matrices[i2];               \
+  const _Matrix it_transform = WeightMatrix(mit0, w0) + \
+                               WeightMatrix(mit1, w1) + \
+                               WeightMatrix(mit2, w2);
 
 #define PREPARE_3_INNER(_it)                                             \
   const math::SimdFloat4 w = math::simd_float4::LoadPtrU(joint_weights); \
@@ -289,31 +474,31 @@ bool SkinningJob::Validate() const {
   const math::SimdFloat4 w1 = math::simd_float4::Load1PtrU(joint_weights + 1); \
   PREPARE_3_CONCAT(_it)
 
-#define PREPARE_4_CONCAT(_it)                                       \
-  const uint16_t i0 = joint_indices[0];                             \
-  const uint16_t i1 = joint_indices[1];                             \
-  const uint16_t i2 = joint_indices[2];                             \
-  const uint16_t i3 = joint_indices[3];                             \
-  const math::Float4x4& m0 = _job.joint_matrices[i0];               \
-  const math::Float4x4& m1 = _job.joint_matrices[i1];               \
-  const math::Float4x4& m2 = _job.joint_matrices[i2];               \
-  const math::Float4x4& m3 = _job.joint_matrices[i3];               \
-  const math::SimdFloat4 w3 = one - (w0 + w1 + w2);                 \
-  const math::Float4x4 transform =                                  \
-      math::ColumnMultiply(m0, w0) + math::ColumnMultiply(m1, w1) + \
-      math::ColumnMultiply(m2, w2) + math::ColumnMultiply(m3, w3);  \
+#define PREPARE_4_CONCAT(_it)                              \
+  const uint16_t i0 = joint_indices[0];                    \
+  const uint16_t i1 = joint_indices[1];                    \
+  const uint16_t i2 = joint_indices[2];                    \
+  const uint16_t i3 = joint_indices[3];                    \
+  const _Matrix& m0 = _matrices[i0];                       \
+  const _Matrix& m1 = _matrices[i1];                       \
+  const _Matrix& m2 = _matrices[i2];                       \
+  const _Matrix& m3 = _matrices[i3];                       \
+  const math::SimdFloat4 w3 = one - (w0 + w1 + w2);        \
+  const _Matrix transform =                                \
+      WeightMatrix(m0, w0) + WeightMatrix(m1, w1, m0) +    \
+      WeightMatrix(m2, w2, m0) + WeightMatrix(m3, w3, m0); \
   PREPARE_##_it##_4()
 
 #define PREPARE_NOIT_4() PREPARE_NOIT()
 
-#define PREPARE_IT_4()                                                    \
-  const math::Float4x4& mit0 = _job.joint_inverse_transpose_matrices[i0]; \
-  const math::Float4x4& mit1 = _job.joint_inverse_transpose_matrices[i1]; \
-  const math::Float4x4& mit2 = _job.joint_inverse_transpose_matrices[i2]; \
-  const math::Float4x4& mit3 = _job.joint_inverse_transpose_matrices[i3]; \
-  const math::Float4x4 it_transform =                                     \
-      math::ColumnMultiply(mit0, w0) + math::ColumnMultiply(mit1, w1) +   \
-      math::ColumnMultiply(mit2, w2) + math::ColumnMultiply(mit3, w3);
+#define PREPARE_IT_4()                                  \
+  const _Matrix& mit0 = _it_matrices[i0];               \
+  const _Matrix& mit1 = _it_matrices[i1];               \
+  const _Matrix& mit2 = _it_matrices[i2];               \
+  const _Matrix& mit3 = _it_matrices[i3];               \
+  const _Matrix it_transform =                          \
+      WeightMatrix(mit0, w0) + WeightMatrix(mit1, w1) + \
+      WeightMatrix(mit2, w2) + WeightMatrix(mit3, w3);
 
 #define PREPARE_4_INNER(_it)                                             \
   const math::SimdFloat4 w = math::simd_float4::LoadPtrU(joint_weights); \
@@ -328,53 +513,93 @@ bool SkinningJob::Validate() const {
   const math::SimdFloat4 w2 = math::simd_float4::Load1PtrU(joint_weights + 2); \
   PREPARE_4_CONCAT(_it)
 
-#define PREPARE_NOIT_N()                                                     \
-  math::SimdFloat4 wsum = math::simd_float4::Load1PtrU(joint_weights + 0);   \
-  math::Float4x4 transform =                                                 \
-      math::ColumnMultiply(_job.joint_matrices[joint_indices[0]], wsum);     \
-  const int last = _job.influences_count - 1;                                \
-  for (int j = 1; j < last; ++j) {                                           \
-    const math::SimdFloat4 w =                                               \
-        math::simd_float4::Load1PtrU(joint_weights + j);                     \
-    wsum = wsum + w;                                                         \
-    transform = transform + math::ColumnMultiply(                            \
-                                _job.joint_matrices[joint_indices[j]], w);   \
-  }                                                                          \
-  transform =                                                                \
-      transform + math::ColumnMultiply(                                      \
-                      _job.joint_matrices[joint_indices[last]], one - wsum); \
+#define PREPARE_NOIT_N()                                                    \
+  math::SimdFloat4 wsum = math::simd_float4::Load1PtrU(joint_weights + 0);  \
+  const _Matrix& m0 = _matrices[joint_indices[0]];                          \
+  _Matrix transform = WeightMatrix(m0, wsum);                               \
+  const int last = _job.influences_count - 1;                               \
+  for (int j = 1; j < last; ++j) {                                          \
+    const math::SimdFloat4 w =                                              \
+        math::simd_float4::Load1PtrU(joint_weights + j);                    \
+    wsum = wsum + w;                                                        \
+    transform =                                                             \
+        transform + WeightMatrix(_matrices[joint_indices[j]], w, m0);       \
+  }                                                                         \
+  transform = transform +                                                   \
+              WeightMatrix(_matrices[joint_indices[last]], one - wsum, m0); \
   PREPARE_NOIT()
 
-#define PREPARE_IT_N()                                                        \
-  math::SimdFloat4 wsum = math::simd_float4::Load1PtrU(joint_weights + 0);    \
-  const uint16_t i0 = joint_indices[0];                                       \
-  math::Float4x4 transform =                                                  \
-      math::ColumnMultiply(_job.joint_matrices[i0], wsum);                    \
-  math::Float4x4 it_transform =                                               \
-      math::ColumnMultiply(_job.joint_inverse_transpose_matrices[i0], wsum);  \
-  const int last = _job.influences_count - 1;                                 \
-  for (int j = 1; j < last; ++j) {                                            \
-    const uint16_t ij = joint_indices[j];                                     \
-    const math::SimdFloat4 w =                                                \
-        math::simd_float4::Load1PtrU(joint_weights + j);                      \
-    wsum = wsum + w;                                                          \
-    transform = transform + math::ColumnMultiply(_job.joint_matrices[ij], w); \
-    it_transform =                                                            \
-        it_transform +                                                        \
-        math::ColumnMultiply(_job.joint_inverse_transpose_matrices[ij], w);   \
-  }                                                                           \
-  const math::SimdFloat4 wlast = one - wsum;                                  \
-  const int ilast = joint_indices[last];                                      \
-  transform =                                                                 \
-      transform + math::ColumnMultiply(_job.joint_matrices[ilast], wlast);    \
-  it_transform =                                                              \
-      it_transform + math::ColumnMultiply(                                    \
-                         _job.joint_inverse_transpose_matrices[ilast], wlast);
+#define PREPARE_IT_N()                                                     \
+  math::SimdFloat4 wsum = math::simd_float4::Load1PtrU(joint_weights + 0); \
+  const uint16_t i0 = joint_indices[0];                                    \
+  const _Matrix& m0 = _matrices[i0];                                       \
+  _Matrix transform = WeightMatrix(m0, wsum);                              \
+  _Matrix it_transform = WeightMatrix(_it_matrices[i0], wsum);             \
+  const int last = _job.influences_count - 1;                              \
+  for (int j = 1; j < last; ++j) {                                         \
+    const uint16_t ij = joint_indices[j];                                  \
+    const math::SimdFloat4 w =                                             \
+        math::simd_float4::Load1PtrU(joint_weights + j);                   \
+    wsum = wsum + w;                                                       \
+    transform = transform + WeightMatrix(_matrices[ij], w, m0);            \
+    it_transform = it_transform + WeightMatrix(_it_matrices[ij], w);       \
+  }                                                                        \
+  const math::SimdFloat4 wlast = one - wsum;                               \
+  const int ilast = joint_indices[last];                                   \
+  transform = transform + WeightMatrix(_matrices[ilast], wlast, m0);       \
+  it_transform = it_transform + WeightMatrix(_it_matrices[ilast], wlast);
 
 #define PREPARE_N_INNER(_it) PREPARE_##_it##_N()
 
 #define PREPARE_N_OUTER(_it) PREPARE_##_it##_N()
 
+// Implements previous frame palette matrix preparation, reusing indices and
+// weights of the current frame preparation.
+#define PREPARE_NOPREV_1()
+
+#define PREPARE_NOPREV_2()
+
+#define PREPARE_NOPREV_3()
+
+#define PREPARE_NOPREV_4()
+
+#define PREPARE_NOPREV_N()
+
+#define PREPARE_PREV_1() const _Matrix& prev_transform = _prev_matrices[i0];
+
+#define PREPARE_PREV_2()                   \
+  const _Matrix& pm0 = _prev_matrices[i0]; \
+  const _Matrix prev_transform =           \
+      WeightMatrix(pm0, w0) + WeightMatrix(_prev_matrices[i1], w1, pm0);
+
+#define PREPARE_PREV_3()                                                     \
+  const _Matrix& pm0 = _prev_matrices[i0];                                   \
+  const _Matrix prev_transform = WeightMatrix(pm0, w0) +                     \
+                                 WeightMatrix(_prev_matrices[i1], w1, pm0) + \
+                                 WeightMatrix(_prev_matrices[i2], w2, pm0);
+
+#define PREPARE_PREV_4()                                                     \
+  const _Matrix& pm0 = _prev_matrices[i0];                                   \
+  const _Matrix prev_transform = WeightMatrix(pm0, w0) +                     \
+                                 WeightMatrix(_prev_matrices[i1], w1, pm0) + \
+                                 WeightMatrix(_prev_matrices[i2], w2, pm0) + \
+                                 WeightMatrix(_prev_matrices[i3], w3, pm0);
+
+#define PREPARE_PREV_N()                                                     \
+  math::SimdFloat4 pwsum = math::simd_float4::Load1PtrU(joint_weights + 0);  \
+  const _Matrix& pm0 = _prev_matrices[joint_indices[0]];                     \
+  _Matrix prev_transform = WeightMatrix(pm0, pwsum);                         \
+  for (int j = 1; j < last; ++j) {                                           \
+    const math::SimdFloat4 w =                                               \
+        math::simd_float4::Load1PtrU(joint_weights + j);                     \
+    pwsum = pwsum + w;                                                       \
+    prev_transform = prev_transform +                                        \
+                     WeightMatrix(_prev_matrices[joint_indices[j]], w, pm0); \
+  }                                                                          \
+  prev_transform =                                                           \
+      prev_transform +                                                       \
+      WeightMatrix(_prev_matrices[joint_indices[last]], one - pwsum, pm0);
+
 // Implement point and vector transformation. _INNER and _OUTER have the same
 // meaning as defined for the PREPARE functions.
 #define TRANSFORM_P_INNER()                                                \
@@ -411,61 +636,859 @@ bool SkinningJob::Validate() const {
   const math::SimdFloat4 out_t = TransformVector(it_transform, in_t);      \
   math::Store3PtrU(out_t, out_tangents);
 
+// Implements previous positions transformation, from the current input
+// position.
+#define TRANSFORM_NOPREV()
+
+#define TRANSFORM_PREV()                                 \
+  math::Store3PtrU(TransformPoint(prev_transform, in_p), \
+                   out_previous_positions);
+
 // Instantiates all skinning function variants.
-SKINNING_FN(P, NOIT, 1)
-SKINNING_FN(PN, NOIT, 1)
-SKINNING_FN(PNT, NOIT, 1)
-SKINNING_FN(PN, IT, 1)
-SKINNING_FN(PNT, IT, 1)
-SKINNING_FN(P, NOIT, 2)
-SKINNING_FN(PN, NOIT, 2)
-SKINNING_FN(PNT, NOIT, 2)
-SKINNING_FN(PN, IT, 2)
-SKINNING_FN(PNT, IT, 2)
-SKINNING_FN(P, NOIT, 3)
-SKINNING_FN(PN, NOIT, 3)
-SKINNING_FN(PNT, NOIT, 3)
-SKINNING_FN(PN, IT, 3)
-SKINNING_FN(PNT, IT, 3)
-SKINNING_FN(P, NOIT, 4)
-SKINNING_FN(PN, NOIT, 4)
-SKINNING_FN(PNT, NOIT, 4)
-SKINNING_FN(PN, IT, 4)
-SKINNING_FN(PNT, IT, 4)
-SKINNING_FN(P, NOIT, N)
-SKINNING_FN(PN, NOIT, N)
-SKINNING_FN(PNT, NOIT, N)
-SKINNING_FN(PN, IT, N)
-SKINNING_FN(PNT, IT, N)
-
-// Defines a matrix of skinning function pointers. This matrix will then be
-// indexed according to skinning jobs parameters.
-typedef void (*SkiningFct)(const SkinningJob&);
-static const SkiningFct kSkinningFct[2][5][3] = {
-    {
-        {&SKINNING_FN_NAME(P, NOIT, 1), &SKINNING_FN_NAME(PN, NOIT, 1),
-         &SKINNING_FN_NAME(PNT, NOIT, 1)},
-        {&SKINNING_FN_NAME(P, NOIT, 2), &SKINNING_FN_NAME(PN, NOIT, 2),
-         &SKINNING_FN_NAME(PNT, NOIT, 2)},
-        {&SKINNING_FN_NAME(P, NOIT, 3), &SKINNING_FN_NAME(PN, NOIT, 3),
-         &SKINNING_FN_NAME(PNT, NOIT, 3)},
-        {&SKINNING_FN_NAME(P, NOIT, 4), &SKINNING_FN_NAME(PN, NOIT, 4),
-         &SKINNING_FN_NAME(PNT, NOIT, 4)},
-        {&SKINNING_FN_NAME(P, NOIT, N), &SKINNING_FN_NAME(PN, NOIT, N),
-         &SKINNING_FN_NAME(PNT, NOIT, N)},
-    },
-    {
-        {&SKINNING_FN_NAME(P, NOIT, 1), &SKINNING_FN_NAME(PN, IT, 1),
-         &SKINNING_FN_NAME(PNT, IT, 1)},
-        {&SKINNING_FN_NAME(P, NOIT, 2), &SKINNING_FN_NAME(PN, IT, 2),
-         &SKINNING_FN_NAME(PNT, IT, 2)},
-        {&SKINNING_FN_NAME(P, NOIT, 3), &SKINNING_FN_NAME(PN, IT, 3),
-         &SKINNING_FN_NAME(PNT, IT, 3)},
-        {&SKINNING_FN_NAME(P, NOIT, 4), &SKINNING_FN_NAME(PN, IT, 4),
-         &SKINNING_FN_NAME(PNT, IT, 4)},
-        {&SKINNING_FN_NAME(P, NOIT, N), &SKINNING_FN_NAME(PN, IT, N),
-         &SKINNING_FN_NAME(PNT, IT, N)},
-    }};
+SKINNING_FN(P, NOIT, NOPREV, 1)
+SKINNING_FN(PN, NOIT, NOPREV, 1)
+SKINNING_FN(PNT, NOIT, NOPREV, 1)
+SKINNING_FN(PN, IT, NOPREV, 1)
+SKINNING_FN(PNT, IT, NOPREV, 1)
+SKINNING_FN(P, NOIT, NOPREV, 2)
+SKINNING_FN(PN, NOIT, NOPREV, 2)
+SKINNING_FN(PNT, NOIT, NOPREV, 2)
+SKINNING_FN(PN, IT, NOPREV, 2)
+SKINNING_FN(PNT, IT, NOPREV, 2)
+SKINNING_FN(P, NOIT, NOPREV, 3)
+SKINNING_FN(PN, NOIT, NOPREV, 3)
+SKINNING_FN(PNT, NOIT, NOPREV, 3)
+SKINNING_FN(PN, IT, NOPREV, 3)
+SKINNING_FN(PNT, IT, NOPREV, 3)
+SKINNING_FN(P, NOIT, NOPREV, 4)
+SKINNING_FN(PN, NOIT, NOPREV, 4)
+SKINNING_FN(PNT, NOIT, NOPREV, 4)
+SKINNING_FN(PN, IT, NOPREV, 4)
+SKINNING_FN(PNT, IT, NOPREV, 4)
+SKINNING_FN(P, NOIT, NOPREV, N)
+SKINNING_FN(PN, NOIT, NOPREV, N)
+SKINNING_FN(PNT, NOIT, NOPREV, N)
+SKINNING_FN(PN, IT, NOPREV, N)
+SKINNING_FN(PNT, IT, NOPREV, N)
+SKINNING_FN(P, NOIT, PREV, 1)
+SKINNING_FN(PN, NOIT, PREV, 1)
+SKINNING_FN(PNT, NOIT, PREV, 1)
+SKINNING_FN(PN, IT, PREV, 1)
+SKINNING_FN(PNT, IT, PREV, 1)
+SKINNING_FN(P, NOIT, PREV, 2)
+SKINNING_FN(PN, NOIT, PREV, 2)
+SKINNING_FN(PNT, NOIT, PREV, 2)
+SKINNING_FN(PN, IT, PREV, 2)
+SKINNING_FN(PNT, IT, PREV, 2)
+SKINNING_FN(P, NOIT, PREV, 3)
+SKINNING_FN(PN, NOIT, PREV, 3)
+SKINNING_FN(PNT, NOIT, PREV, 3)
+SKINNING_FN(PN, IT, PREV, 3)
+SKINNING_FN(PNT, IT, PREV, 3)
+SKINNING_FN(P, NOIT, PREV, 4)
+SKINNING_FN(PN, NOIT, PREV, 4)
+SKINNING_FN(PNT, NOIT, PREV, 4)
+SKINNING_FN(PN, IT, PREV, 4)
+SKINNING_FN(PNT, IT, PREV, 4)
+SKINNING_FN(P, NOIT, PREV, N)
+SKINNING_FN(PN, NOIT, PREV, N)
+SKINNING_FN(PNT, NOIT, PREV, N)
+SKINNING_FN(PN, IT, PREV, N)
+SKINNING_FN(PNT, IT, PREV, N)
+
+namespace {
+// Offsets strided span _span by _count elements.
+template <typename _Ty>
+span<_Ty> Advance(span<_Ty> _span, size_t _stride, int _count) {
+  if (_span.empty()) {
+    return _span;
+  }
+  return {NEXT(_Ty*, _span.begin(), _stride * _count), _span.end()};
+}
+}  // namespace
+
+SkinningJob SkinningJob::Range(int _begin, int _count) const {
+  assert(_begin >= 0 && _count >= 0 && _begin + _count <= vertex_count);
+  SkinningJob job = *this;
+  job.vertex_count = _count;
+  job.joint_indices = Advance(joint_indices, joint_indices_stride, _begin);
+  job.joint_weights = Advance(joint_weights, joint_weights_stride, _begin);
+  job.in_positions = Advance(in_positions, in_positions_stride, _begin);
+  job.in_normals = Advance(in_normals, in_normals_stride, _begin);
+  job.in_tangents = Advance(in_tangents, in_tangents_stride, _begin);
+  job.out_positions = Advance(out_positions, out_positions_stride, _begin);
+  job.out_normals = Advance(out_normals, out_normals_stride, _begin);
+  job.out_tangents = Advance(out_tangents, out_tangents_stride, _begin);
+  job.out_previous_positions =
+      Advance(out_previous_positions, out_previous_positions_stride, _begin);
+  job.in_qtangents = Advance(in_qtangents, in_qtangents_stride, _begin);
+  job.out_qtangents = Advance(out_qtangents, out_qtangents_stride, _begin);
+
+  // Compressed streams.
+  job.joint_compact_indices =
+      Advance(joint_compact_indices, joint_indices_stride, _begin);
+  job.joint_compact_weights =
+      Advance(joint_compact_weights, joint_weights_stride, _begin);
+  job.in_half_positions =
+      Advance(in_half_positions, in_positions_stride, _begin);
+  job.in_snorm16_positions =
+      Advance(in_snorm16_positions, in_positions_stride, _begin);
+  job.in_octahedral_normals =
+      Advance(in_octahedral_normals, in_normals_stride, _begin);
+  job.in_octahedral_tangents =
+      Advance(in_octahedral_tangents, in_tangents_stride, _begin);
+  job.out_half_positions =
+      Advance(out_half_positions, out_positions_stride, _begin);
+  job.out_octahedral_normals =
+      Advance(out_octahedral_normals, out_normals_stride, _begin);
+  job.out_octahedral_tangents =
+      Advance(out_octahedral_tangents, out_tangents_stride, _begin);
+  return job;
+}
+
+#if defined(OZZ_SIMD_AVX2)
+// AVX2 implementation skins 2 vertices per loop, each one using one 128 bits
+// lane of 256 bits registers. Matrices are blended and vertices transformed
+// with the same algorithm as 4-wide functions, but each instruction processes
+// both vertices at once. Note that AVX2 shuffle instructions operate within
+// 128 bits lanes, so vertices never need to cross lanes.
+// Only affine matrices are supported, as their transformation requires more
+// instructions than 4x4 matrices which don't benefit from 2 vertices per loop.
+namespace {
+
+// Per component multiply-add, using FMA instructions if available.
+OZZ_INLINE __m256 MAdd2(__m256 _a, __m256 _b, __m256 _c) {
+#if defined(OZZ_SIMD_FMA)
+  return _mm256_fmadd_ps(_a, _b, _c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(_a, _b), _c);
+#endif
+}
+
+// Loads _a to the low lane and _b to the high lane.
+OZZ_INLINE __m256 Load2(math::_SimdFloat4 _a, math::_SimdFloat4 _b) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_a), _b, 1);
+}
+
+// Loads 4 floats from _a to the low lane, and from _b to the high lane.
+OZZ_INLINE __m256 Load2(const float* _a, const float* _b) {
+  return Load2(math::simd_float4::LoadPtrU(_a),
+               math::simd_float4::LoadPtrU(_b));
+}
+
+// Loads and splats _a to the low lane and _b to the high lane.
+OZZ_INLINE __m256 Load1x2(const float* _a, const float* _b) {
+  return Load2(_mm_broadcast_ss(_a), _mm_broadcast_ss(_b));
+}
+
+// Stores x, y and z components of each lane of _v.
+OZZ_INLINE void Store3x2(__m256 _v, float* _a, float* _b) {
+  math::Store3PtrU(_mm256_castps256_ps128(_v), _a);
+  math::Store3PtrU(_mm256_extractf128_ps(_v, 1), _b);
+}
+
+// Affine matrix rows of 2 vertices.
+struct Matrix2 {
+  __m256 v[3];
+};
+
+// Loads matrices _a and _b.
+OZZ_INLINE Matrix2 Load2(const math::Float3x4& _a, const math::Float3x4& _b) {
+  const Matrix2 ret = {{Load2(_a.rows[0], _b.rows[0]),
+                        Load2(_a.rows[1], _b.rows[1]),
+                        Load2(_a.rows[2], _b.rows[2])}};
+  return ret;
+}
+
+// Returns matrices _m weighted by _w.
+OZZ_INLINE Matrix2 Weight2(const Matrix2& _m, __m256 _w) {
+  const Matrix2 ret = {{_mm256_mul_ps(_m.v[0], _w), _mm256_mul_ps(_m.v[1], _w),
+                        _mm256_mul_ps(_m.v[2], _w)}};
+  return ret;
+}
+
+// Returns _acc + _m weighted by _w.
+OZZ_INLINE Matrix2 Weight2(const Matrix2& _m, __m256 _w, const Matrix2& _acc) {
+  const Matrix2 ret = {{MAdd2(_m.v[0], _w, _acc.v[0]),
+                        MAdd2(_m.v[1], _w, _acc.v[1]),
+                        MAdd2(_m.v[2], _w, _acc.v[2])}};
+  return ret;
+}
+
+// Transforms points (_w = 1) or vectors (_w = 0) _v by affine 3x4 matrices,
+// computing dot products of _v with each row.
+template <bool _point>
+OZZ_INLINE __m256 Transform2(const Matrix2& _m, __m256 _v) {
+  const __m256 w = _point ? _mm256_set1_ps(1.f) : _mm256_setzero_ps();
+  const __m256 v = _mm256_blend_ps(_v, w, 0x88);
+  const __m256 a = _mm256_mul_ps(_m.v[0], v);
+  const __m256 b = _mm256_mul_ps(_m.v[1], v);
+  const __m256 c = _mm256_mul_ps(_m.v[2], v);
+  const __m256 ab =
+      _mm256_add_ps(_mm256_unpacklo_ps(a, b), _mm256_unpackhi_ps(a, b));
+  const __m256 cc =
+      _mm256_add_ps(c, _mm256_permute_ps(c, _MM_SHUFFLE(1, 0, 3, 2)));
+  return _mm256_add_ps(_mm256_shuffle_ps(ab, cc, _MM_SHUFFLE(1, 0, 1, 0)),
+                       _mm256_shuffle_ps(ab, cc, _MM_SHUFFLE(0, 1, 3, 2)));
+}
+
+// Skinning function for _inf influences (0 for any number of influences), and
+// _type 0 for positions, 1 for positions and normals, 2 for positions, normals
+// and tangents. Previous positions are skinned with _prev_matrices if _prev.
+// Positions bounds are accumulated to _bounds if _bounded.
+template <int _inf, int _type, bool _it, bool _prev, bool _bounded>
+void SkinningAvx2(const SkinningJob& _job, span<const math::Float3x4> _matrices,
+                  span<const math::Float3x4> _it_matrices,
+                  span<const math::Float3x4> _prev_matrices, int _count,
+                  math::SimdFloat4* _bounds) {
+  const int last = _inf ? _inf - 1 : _job.influences_count - 1;
+  const math::Float3x4* matrices = _matrices.begin();
+  const math::Float3x4* it_matrices = _it_matrices.begin();
+  const math::Float3x4* prev_matrices = _prev_matrices.begin();
+
+  const uint16_t* joint_indices = _job.joint_indices.begin();
+  const float* joint_weights = _job.joint_weights.begin();
+  const float* in_positions = _job.in_positions.begin();
+  const float* in_normals = _job.in_normals.begin();
+  const float* in_tangents = _job.in_tangents.begin();
+  float* out_positions = _job.out_positions.begin();
+  float* out_normals = _job.out_normals.begin();
+  float* out_tangents = _job.out_tangents.begin();
+  float* out_prev_positions = _job.out_previous_positions.begin();
+
+  // Strides, from a vertex to the next one.
+  const size_t is = _job.joint_indices_stride;
+  const size_t ws = _job.joint_weights_stride;
+  const size_t ips = _job.in_positions_stride;
+  const size_t ins = _job.in_normals_stride;
+  const size_t its = _job.in_tangents_stride;
+  const size_t ops = _job.out_positions_stride;
+  const size_t ons = _job.out_normals_stride;
+  const size_t ots = _job.out_tangents_stride;
+  const size_t opps = _job.out_previous_positions_stride;
+
+  // Both lanes accumulate bounds, they're merged once all vertices are
+  // skinned.
+  __m256 bounds_min = _mm256_setzero_ps();
+  __m256 bounds_max = _mm256_setzero_ps();
+  if (_bounded) {
+    bounds_min = Load2(_bounds[0], _bounds[0]);
+    bounds_max = Load2(_bounds[1], _bounds[1]);
+  }
+
+  for (int i = 0; i < _count; i += 2) {
+    const uint16_t* joint_indices1 = NEXT(const uint16_t*, joint_indices, is);
+    const float* joint_weights1 = NEXT(const float*, joint_weights, ws);
+
+    // Blends matrices of all influences. The weight of the last influence is
+    // restored from the sum of the others.
+    const uint16_t i0 = joint_indices[0];
+    const uint16_t i1 = joint_indices1[0];
+    Matrix2 transform = Load2(matrices[i0], matrices[i1]);
+    Matrix2 it_transform;
+    if (_it) {
+      it_transform = Load2(it_matrices[i0], it_matrices[i1]);
+    }
+    Matrix2 prev_transform;
+    if (_prev) {
+      prev_transform = Load2(prev_matrices[i0], prev_matrices[i1]);
+    }
+    if (last > 0) {
+      __m256 wsum = Load1x2(joint_weights, joint_weights1);
+      transform = Weight2(transform, wsum);
+      if (_it) {
+        it_transform = Weight2(it_transform, wsum);
+      }
+      if (_prev) {
+        prev_transform = Weight2(prev_transform, wsum);
+      }
+      for (int j = 1; j <= last; ++j) {
+        const uint16_t j0 = joint_indices[j];
+        const uint16_t j1 = joint_indices1[j];
+        __m256 w;
+        if (j < last) {
+          w = Load1x2(joint_weights + j, joint_weights1 + j);
+          wsum = _mm256_add_ps(wsum, w);
+        } else {
+          w = _mm256_sub_ps(_mm256_set1_ps(1.f), wsum);
+        }
+        transform = Weight2(Load2(matrices[j0], matrices[j1]), w, transform);
+        if (_it) {
+          it_transform = Weight2(Load2(it_matrices[j0], it_matrices[j1]), w,
+                                 it_transform);
+        }
+        if (_prev) {
+          prev_transform = Weight2(Load2(prev_matrices[j0], prev_matrices[j1]),
+                                   w, prev_transform);
+        }
+      }
+    }
+    const Matrix2& vector_transform = _it ? it_transform : transform;
+
+    // Transforms positions, normals and tangents. Vertices are loaded as 4
+    // floats, which SkinAvx2 checked is safe.
+    const __m256 in_p =
+        Load2(in_positions, NEXT(const float*, in_positions, ips));
+    const __m256 out_p = Transform2<true>(transform, in_p);
+    Store3x2(out_p, out_positions, NEXT(float*, out_positions, ops));
+    if (_bounded) {
+      bounds_min = _mm256_min_ps(bounds_min, out_p);
+      bounds_max = _mm256_max_ps(bounds_max, out_p);
+    }
+    if (_prev) {
+      Store3x2(Transform2<true>(prev_transform, in_p), out_prev_positions,
+               NEXT(float*, out_prev_positions, opps));
+    }
+    if (_type > 0) {
+      const __m256 in_n =
+          Load2(in_normals, NEXT(const float*, in_normals, ins));
+      Store3x2(Transform2<false>(vector_transform, in_n), out_normals,
+               NEXT(float*, out_normals, ons));
+    }
+    if (_type > 1) {
+      const __m256 in_t =
+          Load2(in_tangents, NEXT(const float*, in_tangents, its));
+      Store3x2(Transform2<false>(vector_transform, in_t),
+               out_tangents, NEXT(float*, out_tangents, ots));
+    }
+
+    joint_indices = NEXT(const uint16_t*, joint_indices, is * 2);
+    joint_weights = NEXT(const float*, joint_weights, ws * 2);
+    in_positions = NEXT(const float*, in_positions, ips * 2);
+    out_positions = NEXT(float*, out_positions, ops * 2);
+    if (_prev) {
+      out_prev_positions = NEXT(float*, out_prev_positions, opps * 2);
+    }
+    if (_type > 0) {
+      in_normals = NEXT(const float*, in_normals, ins * 2);
+      out_normals = NEXT(float*, out_normals, ons * 2);
+    }
+    if (_type > 1) {
+      in_tangents = NEXT(const float*, in_tangents, its * 2);
+      out_tangents = NEXT(float*, out_tangents, ots * 2);
+    }
+  }
+
+  if (_bounded) {
+    _bounds[0] = _mm_min_ps(_mm256_castps256_ps128(bounds_min),
+                            _mm256_extractf128_ps(bounds_min, 1));
+    _bounds[1] = _mm_max_ps(_mm256_castps256_ps128(bounds_max),
+                            _mm256_extractf128_ps(bounds_max, 1));
+  }
+}
+
+// Returns true if 4 floats can be loaded from _span's vertex _index, which
+// isn't the case for the last vertex of a tightly packed buffer.
+OZZ_INLINE bool CanLoad4(span<const float> _span, size_t _stride, int _index) {
+  return _span.empty() ||
+         _span.size_bytes() >= _stride * _index + sizeof(float) * 4;
+}
+
+// Skins vertices 2 by 2, and returns the number of skinned vertices. The last
+// vertex is left to 4-wide functions if it can't be loaded as 4 floats (they
+// know how to load it without reading out of the buffer), or if vertex count
+// is odd. Pairs are thus always made of the same vertices for any range
+// starting at an even vertex, whichever the job.
+int SkinAvx2(const SkinningJob& _job, span<const math::Float3x4> _matrices,
+             span<const math::Float3x4> _it_matrices,
+             span<const math::Float3x4> _prev_matrices,
+             math::SimdFloat4* _bounds) {
+  typedef void (*SkiningFct)(const SkinningJob&, span<const math::Float3x4>,
+                             span<const math::Float3x4>,
+                             span<const math::Float3x4>, int,
+                             math::SimdFloat4*);
+#define SKINNING_AVX2_FCT(_inf, _prev, _bounded)     \
+  {{&SkinningAvx2<_inf, 0, false, _prev, _bounded>,  \
+    &SkinningAvx2<_inf, 1, false, _prev, _bounded>,  \
+    &SkinningAvx2<_inf, 2, false, _prev, _bounded>}, \
+   {&SkinningAvx2<_inf, 0, false, _prev, _bounded>,  \
+    &SkinningAvx2<_inf, 1, true, _prev, _bounded>,   \
+    &SkinningAvx2<_inf, 2, true, _prev, _bounded>}}
+
+#define SKINNING_AVX2_FCT_TABLE(_prev, _bounded) \
+  {SKINNING_AVX2_FCT(1, _prev, _bounded),        \
+   SKINNING_AVX2_FCT(2, _prev, _bounded),        \
+   SKINNING_AVX2_FCT(3, _prev, _bounded),        \
+   SKINNING_AVX2_FCT(4, _prev, _bounded),        \
+   SKINNING_AVX2_FCT(0, _prev, _bounded)}
+
+  static const SkiningFct kSkinningFct[2][2][5][2][3] = {
+      {SKINNING_AVX2_FCT_TABLE(false, false),
+       SKINNING_AVX2_FCT_TABLE(true, false)},
+      {SKINNING_AVX2_FCT_TABLE(false, true),
+       SKINNING_AVX2_FCT_TABLE(true, true)}};
+#undef SKINNING_AVX2_FCT_TABLE
+#undef SKINNING_AVX2_FCT
+
+  const int last = (_job.vertex_count & ~1) - 1;
+  const bool load4 =
+      last > 0 &&
+      CanLoad4(_job.in_positions, _job.in_positions_stride, last) &&
+      CanLoad4(_job.in_normals, _job.in_normals_stride, last) &&
+      CanLoad4(_job.in_tangents, _job.in_tangents_stride, last);
+  const int count = load4 ? last + 1 : (_job.vertex_count - 1) & ~1;
+  if (count != 0) {
+    const int inf = _job.influences_count <= 4 ? _job.influences_count - 1 : 4;
+    const size_t it = !_it_matrices.empty();
+    const size_t fct = !_job.in_normals.empty() + !_job.in_tangents.empty();
+    const size_t prev = !_prev_matrices.empty();
+    const size_t bounded = _bounds != nullptr;
+    kSkinningFct[bounded][prev][inf][it][fct](_job, _matrices, _it_matrices,
+                                              _prev_matrices, count, _bounds);
+  }
+  return count;
+}
+
+// 4x4 matrices and dual quaternions are left to 4-wide functions.
+template <typename _Matrix>
+int SkinAvx2(const SkinningJob&, span<const _Matrix>, span<const _Matrix>,
+             span<const _Matrix>, math::SimdFloat4*) {
+  return 0;
+}
+
+}  // namespace
+#endif  // OZZ_SIMD_AVX2
+
+// Selects and calls the skinning function matching job parameters, for the
+// _Matrix type of the joint matrices. Previous positions are skinned with
+// _prev_matrices palette if not empty. Positions bounds are accumulated to
+// _bounds (min and max) if not nullptr.
+template <typename _Matrix>
+void Skin(const SkinningJob& _job, span<const _Matrix> _matrices,
+          span<const _Matrix> _it_matrices, span<const _Matrix> _prev_matrices,
+          math::SimdFloat4* _bounds) {
+#if defined(OZZ_SIMD_AVX2)
+  // Skins vertices 2 by 2, and remaining ones with 4-wide functions below.
+  const int skinned =
+      SkinAvx2(_job, _matrices, _it_matrices, _prev_matrices, _bounds);
+  if (skinned != 0) {
+    if (skinned != _job.vertex_count) {
+      Skin(_job.Range(skinned, _job.vertex_count - skinned), _matrices,
+           _it_matrices, _prev_matrices, _bounds);
+    }
+    return;
+  }
+#endif  // OZZ_SIMD_AVX2
+
+  // Defines a matrix of skinning function pointers. This matrix will then be
+  // indexed according to skinning jobs parameters.
+  typedef void (*SkiningFct)(const SkinningJob&, span<const _Matrix>,
+                             span<const _Matrix>, span<const _Matrix>,
+                             math::SimdFloat4*);
+#define SKINNING_FCT(_type, _it, _prev, _inf, _bounded) \
+  &SKINNING_FN_NAME(_type, _it, _prev, _inf)<_Matrix, _bounded>
+
+#define SKINNING_FCT_TABLE(_prev, _bounded)         \
+  {{{SKINNING_FCT(P, NOIT, _prev, 1, _bounded),     \
+     SKINNING_FCT(PN, NOIT, _prev, 1, _bounded),    \
+     SKINNING_FCT(PNT, NOIT, _prev, 1, _bounded)},  \
+    {SKINNING_FCT(P, NOIT, _prev, 2, _bounded),     \
+     SKINNING_FCT(PN, NOIT, _prev, 2, _bounded),    \
+     SKINNING_FCT(PNT, NOIT, _prev, 2, _bounded)},  \
+    {SKINNING_FCT(P, NOIT, _prev, 3, _bounded),     \
+     SKINNING_FCT(PN, NOIT, _prev, 3, _bounded),    \
+     SKINNING_FCT(PNT, NOIT, _prev, 3, _bounded)},  \
+    {SKINNING_FCT(P, NOIT, _prev, 4, _bounded),     \
+     SKINNING_FCT(PN, NOIT, _prev, 4, _bounded),    \
+     SKINNING_FCT(PNT, NOIT, _prev, 4, _bounded)},  \
+    {SKINNING_FCT(P, NOIT, _prev, N, _bounded),     \
+     SKINNING_FCT(PN, NOIT, _prev, N, _bounded),    \
+     SKINNING_FCT(PNT, NOIT, _prev, N, _bounded)}}, \
+   {{SKINNING_FCT(P, NOIT, _prev, 1, _bounded),     \
+     SKINNING_FCT(PN, IT, _prev, 1, _bounded),      \
+     SKINNING_FCT(PNT, IT, _prev, 1, _bounded)},    \
+    {SKINNING_FCT(P, NOIT, _prev, 2, _bounded),     \
+     SKINNING_FCT(PN, IT, _prev, 2, _bounded),      \
+     SKINNING_FCT(PNT, IT, _prev, 2, _bounded)},    \
+    {SKINNING_FCT(P, NOIT, _prev, 3, _bounded),     \
+     SKINNING_FCT(PN, IT, _prev, 3, _bounded),      \
+     SKINNING_FCT(PNT, IT, _prev, 3, _bounded)},    \
+    {SKINNING_FCT(P, NOIT, _prev, 4, _bounded),     \
+     SKINNING_FCT(PN, IT, _prev, 4, _bounded),      \
+     SKINNING_FCT(PNT, IT, _prev, 4, _bounded)},    \
+    {SKINNING_FCT(P, NOIT, _prev, N, _bounded),     \
+     SKINNING_FCT(PN, IT, _prev, N, _bounded),      \
+     SKINNING_FCT(PNT, IT, _prev, N, _bounded)}}}
+
+  static const SkiningFct kSkinningFct[2][2][2][5][3] = {
+      {SKINNING_FCT_TABLE(NOPREV, false), SKINNING_FCT_TABLE(PREV, false)},
+      {SKINNING_FCT_TABLE(NOPREV, true), SKINNING_FCT_TABLE(PREV, true)}};
+#undef SKINNING_FCT_TABLE
+#undef SKINNING_FCT
+
+  // Find skinning function index.
+  const size_t it = !_it_matrices.empty();
+  assert(it < OZZ_ARRAY_SIZE(kSkinningFct[0][0]));
+  const size_t inf =
+      static_cast<size_t>(_job.influences_count) >
+              OZZ_ARRAY_SIZE(kSkinningFct[0][0][0])
+          ? OZZ_ARRAY_SIZE(kSkinningFct[0][0][0]) - 1
+          : _job.influences_count - 1;
+  assert(inf < OZZ_ARRAY_SIZE(kSkinningFct[0][0][0]));
+  const size_t fct = !_job.in_normals.empty() + !_job.in_tangents.empty();
+  assert(fct < OZZ_ARRAY_SIZE(kSkinningFct[0][0][0][0]));
+  const size_t prev = !_prev_matrices.empty();
+  const size_t bounded = _bounds != nullptr;
+
+  // Calls skinning function. Cannot fail because job is valid.
+  kSkinningFct[bounded][prev][it][inf][fct](_job, _matrices, _it_matrices,
+                                            _prev_matrices, _bounds);
+}
+
+namespace {
+// Dispatches according to joint matrices type.
+void Skin(const SkinningJob& _job, math::SimdFloat4* _bounds) {
+  if (!_job.joint_affine_matrices.empty()) {
+    Skin(_job, _job.joint_affine_matrices,
+         _job.joint_inverse_transpose_affine_matrices,
+         _job.joint_previous_affine_matrices, _bounds);
+  } else if (!_job.joint_dual_quaternions.empty()) {
+    Skin(_job, _job.joint_dual_quaternions,
+         span<const math::SimdDualQuaternion>(),
+         _job.joint_previous_dual_quaternions, _bounds);
+  } else {
+    Skin(_job, _job.joint_matrices, _job.joint_inverse_transpose_matrices,
+         _job.joint_previous_matrices, _bounds);
+  }
+}
+
+// Compressed streams are decoded to (and encoded from) float buffers of
+// kChunkSize vertices, small enough to remain in cache.
+const int kChunkSize = 32;
+
+// Maximum number of indices and weights decoded per chunk.
+const int kChunkInfluences = kChunkSize * 16;
+static_assert(kChunkInfluences >= kMaxCompactInfluences * 2,
+              "Chunk must be able to decode at least two vertices.");
+
+// Stride of decoded positions, normals and tangents.
+const size_t kDecodedStride = sizeof(float) * 3;
+
+// Decodes _count vertices 8 bits indices to 16 bits indices.
+void DecodeIndices(const uint8_t* _in, size_t _stride, int _influences,
+                   int _count, uint16_t* _out) {
+  for (int i = 0; i < _count; ++i, _in = NEXT(const uint8_t*, _in, _stride)) {
+    for (int j = 0; j < _influences; ++j) {
+      *_out++ = _in[j];
+    }
+  }
+}
+
+// Decodes _count vertices 8 bits normalized weights to floats.
+void DecodeWeights(const uint8_t* _in, size_t _stride, int _weights,
+                   int _count, float* _out) {
+  const float kUnorm8 = 1.f / 255.f;
+  for (int i = 0; i < _count; ++i, _in = NEXT(const uint8_t*, _in, _stride)) {
+    for (int j = 0; j < _weights; ++j) {
+      *_out++ = _in[j] * kUnorm8;
+    }
+  }
+}
+
+// Decodes _count half float positions.
+void DecodePositions(const uint16_t* _in, size_t _stride, int _count,
+                     float* _out) {
+  for (int i = 0; i < _count; ++i, _out += 3) {
+    const math::SimdInt4 h = math::simd_int4::Load(_in[0], _in[1], _in[2], 0);
+    math::Store3PtrU(math::HalfToFloat(h), _out);
+    _in = NEXT(const uint16_t*, _in, _stride);
+  }
+}
+
+// Decodes _count signed normalized int16 positions, and dequantizes them with
+// _scale and _offset.
+void DecodePositions(const int16_t* _in, size_t _stride, int _count,
+                     const math::Float3& _scale, const math::Float3& _offset,
+                     float* _out) {
+  const math::SimdFloat4 scale = math::simd_float4::Load(
+      _scale.x / kSnorm16, _scale.y / kSnorm16, _scale.z / kSnorm16, 0.f);
+  const math::SimdFloat4 offset =
+      math::simd_float4::Load(_offset.x, _offset.y, _offset.z, 0.f);
+  for (int i = 0; i < _count; ++i, _out += 3) {
+    const math::SimdInt4 q = math::simd_int4::Load(_in[0], _in[1], _in[2], 0);
+    math::Store3PtrU(math::simd_float4::FromInt(q) * scale + offset, _out);
+    _in = NEXT(const int16_t*, _in, _stride);
+  }
+}
+
+// Decodes _count octahedral encoded unit vectors. Octahedron lower half (z <
+// 0) is folded over the upper half, see "A Survey of Efficient
+// Representations for Independent Unit Vectors", Cigolle et al. 2014.
+void DecodeVectors(const int16_t* _in, size_t _stride, int _count,
+                   float* _out) {
+  const math::SimdFloat4 one = math::simd_float4::one();
+  const math::SimdFloat4 rcp = math::simd_float4::Load1(1.f / kSnorm16);
+  for (int i = 0; i < _count; ++i, _out += 3) {
+    const math::SimdInt4 q = math::simd_int4::Load(_in[0], _in[1], 0, 0);
+    const math::SimdFloat4 xy =
+        math::Max(math::simd_float4::FromInt(q) * rcp, -one);
+    const math::SimdFloat4 abs = math::Abs(xy);
+    const math::SimdFloat4 z = one - math::SplatX(abs) - math::SplatY(abs);
+    const math::SimdFloat4 fold = math::Max0(-z);
+    const math::SimdFloat4 v =
+        math::SetZ(xy - math::Or(fold, math::Sign(xy)), z);
+    math::Store3PtrU(math::Normalize3(v), _out);
+    _in = NEXT(const int16_t*, _in, _stride);
+  }
+}
+
+// Encodes _count positions to half floats.
+void EncodePositions(const float* _in, int _count, uint16_t* _out,
+                     size_t _stride) {
+  for (int i = 0; i < _count; ++i, _in += 3) {
+    int h[4];
+    math::StorePtrU(math::FloatToHalf(math::simd_float4::LoadPtrU(_in)), h);
+    _out[0] = static_cast<uint16_t>(h[0]);
+    _out[1] = static_cast<uint16_t>(h[1]);
+    _out[2] = static_cast<uint16_t>(h[2]);
+    _out = NEXT(uint16_t*, _out, _stride);
+  }
+}
+
+// Normalizes and encodes _count vectors to octahedral signed normalized
+// int16.
+void EncodeVectors(const float* _in, int _count, int16_t* _out,
+                   size_t _stride) {
+  const math::SimdFloat4 one = math::simd_float4::one();
+  const math::SimdFloat4 zero = math::simd_float4::zero();
+  const math::SimdFloat4 epsilon = math::simd_float4::Load1(1e-20f);
+  const math::SimdFloat4 scale = math::simd_float4::Load1(kSnorm16);
+  for (int i = 0; i < _count; ++i, _in += 3) {
+    const math::SimdFloat4 v = math::simd_float4::LoadPtrU(_in);
+    const math::SimdFloat4 abs = math::Abs(v);
+    const math::SimdFloat4 l1 =
+        math::SplatX(abs) + math::SplatY(abs) + math::SplatZ(abs);
+    const math::SimdFloat4 p = v / math::Max(l1, epsilon);
+    const math::SimdFloat4 fold =
+        math::Or(one - math::Abs(math::Swizzle<1, 0, 2, 3>(p)), math::Sign(p));
+    const math::SimdFloat4 xy =
+        math::Select(math::CmpLt(math::SplatZ(p), zero), fold, p);
+    int q[4];
+    math::StorePtrU(math::simd_int4::FromFloatRound(xy * scale), q);
+    _out[0] = static_cast<int16_t>(q[0]);
+    _out[1] = static_cast<int16_t>(q[1]);
+    _out = NEXT(int16_t*, _out, _stride);
+  }
+}
+
+// Returns the rotation of palette element _q or _dq.
+OZZ_INLINE math::SimdFloat4 QTangentRotation(const math::SimdQuaternion& _q) {
+  return _q.xyzw;
+}
+
+OZZ_INLINE math::SimdFloat4 QTangentRotation(
+    const math::SimdDualQuaternion& _dq) {
+  return _dq.real.xyzw;
+}
+
+// Skins _job QTangents with _palette rotations. Rotations are blended in the
+// hemisphere of the first influence (like dual quaternions), and the
+// normalized product of the blended rotation with the vertex QTangent is
+// encoded with the same handedness as the input.
+template <typename _Palette>
+void SkinQTangents(const SkinningJob& _job, const _Palette* _palette) {
+  const math::SimdFloat4 one = math::simd_float4::one();
+  const math::SimdFloat4 rcp = math::simd_float4::Load1(1.f / kSnorm16);
+  const math::SimdFloat4 scale = math::simd_float4::Load1(kSnorm16);
+  const math::SimdInt4 sign_mask = math::simd_int4::mask_sign();
+
+  // w is kept greater than the smallest snorm16 value, so that handedness
+  // survives quantization. x, y and z are scaled to keep the quaternion
+  // normalized.
+  const math::SimdFloat4 bias = math::simd_float4::Load1(1.f / kSnorm16);
+  const math::SimdFloat4 bias_scale = math::simd_float4::Load(
+      std::sqrt(1.f - 1.f / (kSnorm16 * kSnorm16)),
+      std::sqrt(1.f - 1.f / (kSnorm16 * kSnorm16)),
+      std::sqrt(1.f - 1.f / (kSnorm16 * kSnorm16)), 1.f);
+
+  const int last = _job.influences_count - 1;
+  const uint16_t* joint_indices = _job.joint_indices.begin();
+  const float* joint_weights = _job.joint_weights.begin();
+  const int16_t* in_qtangents = _job.in_qtangents.begin();
+  int16_t* out_qtangents = _job.out_qtangents.begin();
+  for (int i = 0; i < _job.vertex_count; ++i) {
+    // Blends rotations, the last weight being 1 - sum of the others.
+    const math::SimdFloat4 r0 = QTangentRotation(_palette[joint_indices[0]]);
+    math::SimdFloat4 rotation = r0;
+    if (last != 0) {
+      math::SimdFloat4 w = math::simd_float4::Load1(joint_weights[0]);
+      math::SimdFloat4 sum = w;
+      rotation = r0 * w;
+      for (int j = 1; j <= last; ++j) {
+        w = j == last ? one - sum : math::simd_float4::Load1(joint_weights[j]);
+        sum = sum + w;
+        const math::SimdFloat4 r =
+            QTangentRotation(_palette[joint_indices[j]]);
+        const math::SimdFloat4 sign = math::And(
+            math::SplatX(math::Dot4(r, r0)), sign_mask);
+        rotation = math::MAdd(r, math::Xor(w, sign), rotation);
+      }
+      joint_weights = NEXT(const float*, joint_weights,
+                           _job.joint_weights_stride);
+    }
+
+    // Rotates vertex tangent frame.
+    const math::SimdInt4 in_q =
+        math::simd_int4::Load(in_qtangents[0], in_qtangents[1],
+                              in_qtangents[2], in_qtangents[3]);
+    const math::SimdQuaternion q = {math::simd_float4::FromInt(in_q) * rcp};
+    const math::SimdQuaternion blended = {rotation};
+    const math::SimdFloat4 skinned = math::Normalize(blended * q).xyzw;
+
+    // Moves skinned quaternion to positive w hemisphere, biases w, and
+    // restores handedness.
+    const math::SimdFloat4 handedness = math::And(math::SplatW(q.xyzw),
+                                                  sign_mask);
+    const math::SimdFloat4 positive = math::Xor(
+        skinned, math::And(math::SplatW(skinned), sign_mask));
+    const math::SimdInt4 biased =
+        math::CmpLt(math::SplatW(positive), bias);
+    const math::SimdFloat4 out_q = math::Xor(
+        math::Select(biased,
+                     math::SetW(positive * bias_scale, bias), positive),
+        handedness);
+
+    int encoded[4];
+    math::StorePtrU(math::simd_int4::FromFloatRound(out_q * scale), encoded);
+    out_qtangents[0] = static_cast<int16_t>(encoded[0]);
+    out_qtangents[1] = static_cast<int16_t>(encoded[1]);
+    out_qtangents[2] = static_cast<int16_t>(encoded[2]);
+    out_qtangents[3] = static_cast<int16_t>(encoded[3]);
+
+    joint_indices =
+        NEXT(const uint16_t*, joint_indices, _job.joint_indices_stride);
+    in_qtangents =
+        NEXT(const int16_t*, in_qtangents, _job.in_qtangents_stride);
+    out_qtangents = NEXT(int16_t*, out_qtangents, _job.out_qtangents_stride);
+  }
+}
+
+// Skins a job using compressed streams, by chunks. Each chunk's compressed
+// inputs are decoded to local buffers, skinned to local buffers, and then
+// encoded to compressed outputs. Float streams are used in place.
+void SkinCompressed(const SkinningJob& _job, math::SimdFloat4* _bounds) {
+  uint16_t indices[kChunkInfluences];
+  float weights[kChunkInfluences];
+
+  // Buffers are padded as skinning functions load 4 floats per vertex.
+  float in_positions[kChunkSize * 3 + 1];
+  float in_normals[kChunkSize * 3 + 1];
+  float in_tangents[kChunkSize * 3 + 1];
+  float out_positions[kChunkSize * 3 + 1];
+  float out_normals[kChunkSize * 3 + 1];
+  float out_tangents[kChunkSize * 3 + 1];
+
+  const int influences = _job.influences_count;
+  // Decoded indices and weights buffers bound chunk size, which is kept even
+  // so that vertices are paired the same way by AVX2 functions whichever the
+  // range of the job. Other streams are decoded per vertex.
+  const bool decodes_influences = !_job.joint_compact_indices.empty() ||
+                                  !_job.joint_compact_weights.empty();
+  int max_chunk_size = kChunkSize;
+  if (decodes_influences && influences > kChunkInfluences / kChunkSize) {
+    max_chunk_size = math::Max((kChunkInfluences / influences) & ~1, 2);
+  }
+  for (int begin = 0; begin < _job.vertex_count; begin += max_chunk_size) {
+    const int count = _job.vertex_count - begin < max_chunk_size
+                          ? _job.vertex_count - begin
+                          : max_chunk_size;
+    SkinningJob job = _job.Range(begin, count);
+
+    // Decodes compressed inputs.
+    if (!job.joint_compact_indices.empty()) {
+      DecodeIndices(job.joint_compact_indices.begin(), job.joint_indices_stride,
+                    influences, count, indices);
+      job.joint_indices = {indices, static_cast<size_t>(count * influences)};
+      job.joint_indices_stride = sizeof(uint16_t) * influences;
+    }
+    if (!job.joint_compact_weights.empty()) {
+      const int weights_count = influences - 1;
+      DecodeWeights(job.joint_compact_weights.begin(), job.joint_weights_stride,
+                    weights_count, count, weights);
+      job.joint_weights = {weights, static_cast<size_t>(count * weights_count)};
+      job.joint_weights_stride = sizeof(float) * weights_count;
+    }
+    if (!job.in_half_positions.empty()) {
+      DecodePositions(job.in_half_positions.begin(), job.in_positions_stride,
+                      count, in_positions);
+      job.in_positions = in_positions;
+      job.in_positions_stride = kDecodedStride;
+    } else if (!job.in_snorm16_positions.empty()) {
+      DecodePositions(job.in_snorm16_positions.begin(),
+                      job.in_positions_stride, count, job.in_positions_scale,
+                      job.in_positions_offset, in_positions);
+      job.in_positions = in_positions;
+      job.in_positions_stride = kDecodedStride;
+    }
+    if (!job.in_octahedral_normals.empty()) {
+      DecodeVectors(job.in_octahedral_normals.begin(), job.in_normals_stride,
+                    count, in_normals);
+      job.in_normals = in_normals;
+      job.in_normals_stride = kDecodedStride;
+    }
+    if (!job.in_octahedral_tangents.empty()) {
+      DecodeVectors(job.in_octahedral_tangents.begin(), job.in_tangents_stride,
+                    count, in_tangents);
+      job.in_tangents = in_tangents;
+      job.in_tangents_stride = kDecodedStride;
+    }
+
+    // Redirects compressed outputs to local buffers.
+    if (!job.out_half_positions.empty()) {
+      job.out_positions = out_positions;
+      job.out_positions_stride = kDecodedStride;
+    }
+    if (!job.in_normals.empty() && !job.out_octahedral_normals.empty()) {
+      job.out_normals = out_normals;
+      job.out_normals_stride = kDecodedStride;
+    }
+    if (!job.in_tangents.empty() && !job.out_octahedral_tangents.empty()) {
+      job.out_tangents = out_tangents;
+      job.out_tangents_stride = kDecodedStride;
+    }
+
+    Skin(job, _bounds);
+
+    // Skins QTangents while indices and weights are in cache.
+    if (!job.in_qtangents.empty()) {
+      if (!job.joint_rotations.empty()) {
+        SkinQTangents(job, job.joint_rotations.begin());
+      } else {
+        SkinQTangents(job, job.joint_dual_quaternions.begin());
+      }
+    }
+
+    // Encodes compressed outputs.
+    if (!job.out_half_positions.empty()) {
+      EncodePositions(out_positions, count, job.out_half_positions.begin(),
+                      _job.out_positions_stride);
+    }
+    if (!job.in_normals.empty() && !job.out_octahedral_normals.empty()) {
+      EncodeVectors(out_normals, count, job.out_octahedral_normals.begin(),
+                    _job.out_normals_stride);
+    }
+    if (!job.in_tangents.empty() && !job.out_octahedral_tangents.empty()) {
+      EncodeVectors(out_tangents, count, job.out_octahedral_tangents.begin(),
+                    _job.out_tangents_stride);
+    }
+  }
+}
+
+// Returns true if any of _job streams is compressed. QTangents are skinned by
+// chunks too.
+bool IsCompressed(const SkinningJob& _job) {
+  return !_job.joint_compact_indices.empty() ||
+         !_job.joint_compact_weights.empty() ||
+         !_job.in_half_positions.empty() ||
+         !_job.in_snorm16_positions.empty() ||
+         !_job.in_octahedral_normals.empty() ||
+         !_job.in_octahedral_tangents.empty() ||
+         !_job.out_half_positions.empty() ||
+         !_job.out_octahedral_normals.empty() ||
+         !_job.out_octahedral_tangents.empty() ||
+         !_job.in_qtangents.empty();
+}
+}  // namespace
 
 // Implements job Run function.
 bool SkinningJob::Run() const {
@@ -477,22 +1500,30 @@ bool SkinningJob::Run() const {
   // Early out if no vertex. This isn't an error.
   // Skinning function algorithm doesn't support the case.
   if (vertex_count == 0) {
+    if (out_bounds) {
+      *out_bounds = math::Box();
+    }
     return true;
   }
 
-  // Find skinning function index.
-  const size_t it = !joint_inverse_transpose_matrices.empty();
-  assert(it < OZZ_ARRAY_SIZE(kSkinningFct));
-  const size_t inf =
-      static_cast<size_t>(influences_count) > OZZ_ARRAY_SIZE(kSkinningFct[0])
-          ? OZZ_ARRAY_SIZE(kSkinningFct[0]) - 1
-          : influences_count - 1;
-  assert(inf < OZZ_ARRAY_SIZE(kSkinningFct[0]));
-  const size_t fct = !in_normals.empty() + !in_tangents.empty();
-  assert(fct < OZZ_ARRAY_SIZE(kSkinningFct[0][0]));
+  // Bounds are accumulated by skinning functions, starting from an invalid
+  // box.
+  math::SimdFloat4 bounds[2] = {
+      math::simd_float4::Load1(std::numeric_limits<float>::max()),
+      math::simd_float4::Load1(-std::numeric_limits<float>::max())};
+  math::SimdFloat4* bounds_ptr = out_bounds ? bounds : nullptr;
 
-  // Calls skinning function. Cannot fail because job is valid.
-  kSkinningFct[it][inf][fct](*this);
+  // Compressed streams are decoded and encoded by chunks.
+  if (IsCompressed(*this)) {
+    SkinCompressed(*this, bounds_ptr);
+  } else {
+    Skin(*this, bounds_ptr);
+  }
+
+  if (out_bounds) {
+    math::Store3PtrU(bounds[0], &out_bounds->min.x);
+    math::Store3PtrU(bounds[1], &out_bounds->max.x);
+  }
 
   return true;
 }
@@ -0,0 +1,200 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/skinning_palette_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+
+namespace ozz {
+namespace geometry {
+
+SkinningPaletteJob::SkinningPaletteJob() {}
+
+bool SkinningPaletteJob::Validate() const {
+  // Start validation of all parameters.
+  bool valid = true;
+
+  const size_t count = inverse_bind_poses.size();
+
+  // Checks outputs, required. Only one matrix type can be used.
+  const int output_types = !output.empty() + !affine_output.empty() +
+                           !dual_quaternion_output.empty();
+  valid &= output_types == 1;
+  if (!output.empty()) {
+    valid &= output.size() >= count;
+    valid &= inverse_transpose_output.empty() ||
+             inverse_transpose_output.size() >= count;
+  } else {
+    valid &= inverse_transpose_output.empty();
+  }
+  if (!affine_output.empty()) {
+    valid &= affine_output.size() >= count;
+    valid &= affine_inverse_transpose_output.empty() ||
+             affine_inverse_transpose_output.size() >= count;
+  } else {
+    valid &= affine_inverse_transpose_output.empty();
+  }
+  if (!dual_quaternion_output.empty()) {
+    valid &= dual_quaternion_output.size() >= count;
+  }
+  valid &= rotation_output.empty() || rotation_output.size() >= count;
+
+  // Checks model matrices, directly indexed or through the remapping table.
+  if (joint_remaps.empty()) {
+    valid &= model_matrices.size() >= count;
+  } else {
+    valid &= joint_remaps.size() >= count;
+    for (size_t i = 0; valid && i < count; ++i) {
+      valid &= joint_remaps[i] < model_matrices.size();
+    }
+  }
+
+  return valid;
+}
+
+namespace {
+
+// Multiplies affine matrices, skipping the computation of the last row, which
+// is known to be [0, 0, 0, 1].
+OZZ_INLINE math::Float4x4 MultiplyAffine(const math::Float4x4& _a,
+                                         const math::Float4x4& _b) {
+  const math::Float4x4 ret = {{math::TransformVector(_a, _b.cols[0]),
+                               math::TransformVector(_a, _b.cols[1]),
+                               math::TransformVector(_a, _b.cols[2]),
+                               math::TransformPoint(_a, _b.cols[3])}};
+  return ret;
+}
+
+// Computes the inverse transpose of the upper 3x3 part of affine matrix _m,
+// using the cofactors of its columns. The last row and column are set to
+// identity.
+OZZ_INLINE math::Float4x4 InverseTranspose(const math::Float4x4& _m) {
+  const math::SimdInt4 mask = math::simd_int4::mask_fff0();
+  const math::SimdFloat4 c0 = math::Cross3(_m.cols[1], _m.cols[2]);
+  const math::SimdFloat4 c1 = math::Cross3(_m.cols[2], _m.cols[0]);
+  const math::SimdFloat4 c2 = math::Cross3(_m.cols[0], _m.cols[1]);
+  const math::SimdFloat4 inv_det = math::And(
+      math::simd_float4::one() / math::SplatX(math::Dot3(_m.cols[0], c0)),
+      mask);
+  const math::Float4x4 ret = {
+      {c0 * inv_det, c1 * inv_det, c2 * inv_det, math::simd_float4::w_axis()}};
+  return ret;
+}
+
+OZZ_INLINE void Store(const math::Float4x4& _m, math::Float4x4* _out) {
+  *_out = _m;
+}
+
+OZZ_INLINE void Store(const math::Float4x4& _m, math::Float3x4* _out) {
+  *_out = math::Float3x4::FromFloat4x4(_m);
+}
+
+// Decomposes _m to its rotation and translation, scale is discarded.
+OZZ_INLINE void Store(const math::Float4x4& _m,
+                      math::SimdDualQuaternion* _out) {
+  math::SimdFloat4 translation, rotation, scale;
+  if (!math::ToAffine(_m, &translation, &rotation, &scale)) {
+    rotation = math::simd_float4::w_axis();
+  }
+  const math::SimdQuaternion quaternion = {rotation};
+  *_out = math::SimdDualQuaternion::FromAffine(translation, quaternion);
+}
+
+// Decomposes _m to its rotation, translation and scale are discarded.
+OZZ_INLINE void Store(const math::Float4x4& _m, math::SimdQuaternion* _out) {
+  math::SimdFloat4 translation, rotation, scale;
+  if (!math::ToAffine(_m, &translation, &rotation, &scale)) {
+    rotation = math::simd_float4::w_axis();
+  }
+  _out->xyzw = rotation;
+}
+
+template <typename _Matrix>
+void BuildPalette(const SkinningPaletteJob& _job, span<_Matrix> _output,
+                  span<_Matrix> _inverse_transpose_output) {
+  const size_t count = _job.inverse_bind_poses.size();
+  const math::Float4x4* models = _job.model_matrices.data();
+  const math::Float4x4* inv_binds = _job.inverse_bind_poses.data();
+  const uint16_t* remaps = _job.joint_remaps.data();
+  _Matrix* output = _output.data();
+  _Matrix* it_output = _inverse_transpose_output.data();
+
+  if (_job.joint_remaps.empty()) {
+    if (_inverse_transpose_output.empty()) {
+      for (size_t i = 0; i < count; ++i) {
+        Store(MultiplyAffine(models[i], inv_binds[i]), &output[i]);
+      }
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        const math::Float4x4 palette = MultiplyAffine(models[i], inv_binds[i]);
+        Store(palette, &output[i]);
+        Store(InverseTranspose(palette), &it_output[i]);
+      }
+    }
+  } else {
+    if (_inverse_transpose_output.empty()) {
+      for (size_t i = 0; i < count; ++i) {
+        Store(MultiplyAffine(models[remaps[i]], inv_binds[i]), &output[i]);
+      }
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        const math::Float4x4 palette =
+            MultiplyAffine(models[remaps[i]], inv_binds[i]);
+        Store(palette, &output[i]);
+        Store(InverseTranspose(palette), &it_output[i]);
+      }
+    }
+  }
+}
+}  // namespace
+
+bool SkinningPaletteJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  if (!affine_output.empty()) {
+    BuildPalette(*this, affine_output, affine_inverse_transpose_output);
+  } else if (!dual_quaternion_output.empty()) {
+    BuildPalette(*this, dual_quaternion_output,
+                 span<math::SimdDualQuaternion>());
+  } else {
+    BuildPalette(*this, output, inverse_transpose_output);
+  }
+
+  // Rotations are extracted from the palette matrices, as a second pass.
+  if (!rotation_output.empty()) {
+    BuildPalette(*this, rotation_output, span<math::SimdQuaternion>());
+  }
+
+  return true;
+}
+}  // namespace geometry
+}  // namespace ozz
@@ -0,0 +1,70 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_GEOMETRY_RUNTIME_VERTEX_STREAM_H_
+#define OZZ_GEOMETRY_RUNTIME_VERTEX_STREAM_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+#ifndef OZZ_INCLUDE_PRIVATE_HEADER
+#error "This header is private, it cannot be included from public headers."
+#endif  // OZZ_INCLUDE_PRIVATE_HEADER
+
+namespace ozz {
+namespace geometry {
+
+// Defines helpers shared by geometry jobs to access strided vertex streams.
+
+// Compact indices and weights are decoded by chunks of vertices, for which the
+// number of influences must be bounded. This bound also applies to the
+// influences sorted per vertex on the stack.
+const int kMaxCompactInfluences = 256;
+
+// Scale of signed normalized int16 values.
+const float kSnorm16 = 32767.f;
+
+// Returns true if _span is big enough to store _count elements of _size bytes,
+// separated by _stride bytes.
+template <typename _Ty>
+inline bool ValidateStream(span<_Ty> _span, size_t _stride, size_t _size,
+                           int _count) {
+  if (_count <= 0) {
+    return true;
+  }
+  return _span.size_bytes() >= _stride * (_count - 1) + _size;
+}
+
+// Returns the address of element _index of a stream whose elements are
+// separated by _stride bytes.
+template <typename _Ty>
+inline _Ty* StreamElement(_Ty* _stream, size_t _stride, int _index) {
+  return reinterpret_cast<_Ty*>(reinterpret_cast<uintptr_t>(_stream) +
+                                _stride * _index);
+}
+}  // namespace geometry
+}  // namespace ozz
+#endif  // OZZ_GEOMETRY_RUNTIME_VERTEX_STREAM_H_
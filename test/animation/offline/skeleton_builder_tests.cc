@@ -606,6 +606,58 @@ TEST(MultiRoots, SkeletonBuilder) {
   }
 }
 
+TEST(DepthLayout, SkeletonBuilder) {
+  // Instantiates a builder objects with default parameters.
+  SkeletonBuilder builder;
+
+  /*
+  6 joints (2 roots)
+     *
+    /  \
+   j0   j2
+   |    |  \
+   j1  j3  j5
+        |
+       j4
+  */
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(2);
+
+  raw_skeleton.roots[0].name = "j0";
+  raw_skeleton.roots[0].children.resize(1);
+  raw_skeleton.roots[0].children[0].name = "j1";
+
+  raw_skeleton.roots[1].name = "j2";
+  raw_skeleton.roots[1].children.resize(2);
+  raw_skeleton.roots[1].children[0].name = "j3";
+  raw_skeleton.roots[1].children[1].name = "j5";
+
+  raw_skeleton.roots[1].children[0].children.resize(1);
+  raw_skeleton.roots[1].children[0].children[0].name = "j4";
+
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 6);
+
+  // Depth-first order is j0, j1, j2, j3, j4, j5.
+  const int16_t expected_joints[] = {0, 2, 1, 3, 5, 4};
+  const int16_t expected_offsets[] = {0, 2, 5, 6};
+  ASSERT_EQ(skeleton->joints_by_depth().size(), 6u);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(skeleton->joints_by_depth()[i], expected_joints[i]);
+  }
+  ASSERT_EQ(skeleton->depth_offsets().size(), 4u);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(skeleton->depth_offsets()[i], expected_offsets[i]);
+  }
+
+  // Empty skeleton has no level.
+  ozz::unique_ptr<Skeleton> empty(builder(RawSkeleton()));
+  ASSERT_TRUE(empty);
+  EXPECT_EQ(empty->joints_by_depth().size(), 0u);
+  EXPECT_EQ(empty->depth_offsets().size(), 0u);
+}
+
 TEST(BindPose, SkeletonBuilder) {
   using ozz::math::Float3;
   using ozz::math::Float4;
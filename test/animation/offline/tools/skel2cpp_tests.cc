@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "skel2cpp_pab_skeleton.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/options/options.h"
+
+OZZ_OPTIONS_DECLARE_STRING(file, "Specifies input skeleton file", "", true)
+
+int main(int _argc, char** _argv) {
+  // Parses arguments.
+  testing::InitGoogleTest(&_argc, _argv);
+  ozz::options::ParseResult parse_result = ozz::options::ParseCommandLine(
+      _argc, _argv, "1.0", "Test skel2cpp generated code");
+  if (parse_result != ozz::options::kSuccess) {
+    return parse_result == ozz::options::kExitSuccess ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+  }
+
+  return RUN_ALL_TESTS();
+}
+
+TEST(Specialization, Skel2cpp) {
+  // Loads the skeleton the header was generated from.
+  ozz::io::File file(OPTIONS_file, "rb");
+  ASSERT_TRUE(file.opened());
+  ozz::io::IArchive archive(&file);
+  ASSERT_TRUE(archive.TestTag<ozz::animation::Skeleton>());
+  ozz::animation::Skeleton skeleton;
+  archive >> skeleton;
+
+  ASSERT_EQ(skeleton.num_joints(), pab_skeleton::kNumJoints);
+  for (int i = 0; i < skeleton.num_joints(); ++i) {
+    EXPECT_EQ(skeleton.joint_parents()[i], pab_skeleton::kJointParents[i]);
+  }
+
+  // Scales bind pose, so scale path is tested.
+  const ozz::span<const ozz::math::SoaTransform>& bind_poses =
+      skeleton.joint_bind_poses();
+  ozz::vector<ozz::math::SoaTransform> input(bind_poses.begin(),
+                                             bind_poses.end());
+  input[1].scale.y = ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 4.f);
+
+  const ozz::math::Float4x4 root =
+      ozz::math::Float4x4::Translation(ozz::math::simd_float4::y_axis());
+
+  ozz::vector<ozz::math::Float4x4> expected(skeleton.num_joints());
+  ozz::animation::LocalToModelJob job;
+  job.skeleton = &skeleton;
+  job.root = &root;
+  job.input = ozz::make_span(input);
+  job.output = ozz::make_span(expected);
+  ASSERT_TRUE(job.Run());
+
+  ozz::vector<ozz::math::Float4x4> output(skeleton.num_joints());
+  job.output = ozz::make_span(output);
+  job.specialization = &pab_skeleton::LocalToModelSpecialization();
+  ASSERT_TRUE(job.Validate());
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(memcmp(output.data(), expected.data(),
+                   output.size() * sizeof(ozz::math::Float4x4)),
+            0);
+
+  // Partial updates don't use the specialization, so joint 0 isn't updated.
+  memset(output.data(), 0, output.size() * sizeof(ozz::math::Float4x4));
+  job.from = 1;
+  ASSERT_TRUE(job.Run());
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(reinterpret_cast<const float*>(output[0].cols)[i], 0.f);
+  }
+
+  // A specialization for another skeleton isn't valid.
+  ozz::animation::Skeleton empty;
+  job.skeleton = &empty;
+  EXPECT_FALSE(job.Validate());
+
+  const int16_t parents[] = {-1, 0, 0};
+  const ozz::animation::LocalToModelJob::Specialization other = {
+      parents, &pab_skeleton::LocalToModel};
+  job.skeleton = &skeleton;
+  job.specialization = &other;
+  EXPECT_FALSE(job.Validate());
+}
@@ -0,0 +1,281 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/blend_space_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+
+using ozz::animation::BlendSpaceJob;
+
+TEST(JobValidity, BlendSpaceJob) {
+  const ozz::math::Float2 samples[2] = {ozz::math::Float2(0.f, 0.f),
+                                        ozz::math::Float2(1.f, 0.f)};
+  const float durations[2] = {1.f, 2.f};
+  float weights[2];
+  float duration;
+
+  {  // Default job.
+    BlendSpaceJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // No weights.
+    BlendSpaceJob job;
+    job.samples = samples;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Weights too small.
+    BlendSpaceJob job;
+    job.samples = samples;
+    job.weights = {weights, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid threshold.
+    BlendSpaceJob job;
+    job.samples = samples;
+    job.weights = weights;
+    job.threshold = -.1f;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+    job.threshold = 1.f;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Durations too small.
+    BlendSpaceJob job;
+    job.samples = samples;
+    job.weights = weights;
+    job.durations = {durations, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Duration output without durations.
+    BlendSpaceJob job;
+    job.samples = samples;
+    job.weights = weights;
+    job.duration = &duration;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid job.
+    BlendSpaceJob job;
+    job.samples = samples;
+    job.weights = weights;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid job with durations.
+    BlendSpaceJob job;
+    job.samples = samples;
+    job.weights = weights;
+    job.durations = durations;
+    job.duration = &duration;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Single, BlendSpaceJob) {
+  const ozz::math::Float2 samples[1] = {ozz::math::Float2(1.f, 2.f)};
+  float weights[1];
+
+  BlendSpaceJob job;
+  job.samples = samples;
+  job.weights = weights;
+
+  job.parameter = ozz::math::Float2(1.f, 2.f);
+  ASSERT_TRUE(job.Run());
+  EXPECT_FLOAT_EQ(weights[0], 1.f);
+
+  job.parameter = ozz::math::Float2(-10.f, 20.f);
+  ASSERT_TRUE(job.Run());
+  EXPECT_FLOAT_EQ(weights[0], 1.f);
+}
+
+TEST(Linear, BlendSpaceJob) {
+  const ozz::math::Float2 samples[3] = {ozz::math::Float2(0.f, 0.f),
+                                        ozz::math::Float2(4.f, 0.f),
+                                        ozz::math::Float2(1.f, 0.f)};
+  const float durations[3] = {1.f, 3.f, 2.f};
+  float weights[3];
+  float duration;
+
+  BlendSpaceJob job;
+  job.samples = samples;
+  job.threshold = 0.f;
+  job.weights = weights;
+  job.durations = durations;
+  job.duration = &duration;
+
+  {  // On a sample.
+    job.parameter = ozz::math::Float2(1.f, 0.f);
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(weights[0], 0.f);
+    EXPECT_FLOAT_EQ(weights[1], 0.f);
+    EXPECT_FLOAT_EQ(weights[2], 1.f);
+    EXPECT_FLOAT_EQ(duration, 2.f);
+  }
+
+  {  // Between first 2 samples.
+    job.parameter = ozz::math::Float2(.25f, 0.f);
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(weights[0], .75f);
+    EXPECT_FLOAT_EQ(weights[1], 0.f);
+    EXPECT_FLOAT_EQ(weights[2], .25f);
+    EXPECT_FLOAT_EQ(duration, 1.25f);
+  }
+
+  {  // Between last 2 samples.
+    job.parameter = ozz::math::Float2(3.f, 0.f);
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(weights[0], 0.f);
+    EXPECT_FLOAT_EQ(weights[1], 2.f / 3.f);
+    EXPECT_FLOAT_EQ(weights[2], 1.f / 3.f);
+    EXPECT_FLOAT_EQ(duration, 8.f / 3.f);
+  }
+
+  {  // Outside of the range.
+    job.parameter = ozz::math::Float2(-1.f, 0.f);
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(weights[0], 1.f);
+    EXPECT_FLOAT_EQ(weights[1], 0.f);
+    EXPECT_FLOAT_EQ(weights[2], 0.f);
+
+    job.parameter = ozz::math::Float2(46.f, 0.f);
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(weights[0], 0.f);
+    EXPECT_FLOAT_EQ(weights[1], 1.f);
+    EXPECT_FLOAT_EQ(weights[2], 0.f);
+  }
+}
+
+TEST(Planar, BlendSpaceJob) {
+  // Idle at the center, surrounded by 4 directional clips.
+  const ozz::math::Float2 samples[5] = {
+      ozz::math::Float2(0.f, 0.f), ozz::math::Float2(1.f, 0.f),
+      ozz::math::Float2(0.f, 1.f), ozz::math::Float2(-1.f, 0.f),
+      ozz::math::Float2(0.f, -1.f)};
+  float weights[5];
+
+  BlendSpaceJob job;
+  job.samples = samples;
+  job.threshold = 0.f;
+  job.weights = weights;
+
+  // Weights are 1 on each sample position.
+  for (int i = 0; i < 5; ++i) {
+    job.parameter = samples[i];
+    ASSERT_TRUE(job.Run());
+    for (int j = 0; j < 5; ++j) {
+      EXPECT_FLOAT_EQ(weights[j], i == j ? 1.f : 0.f);
+    }
+  }
+
+  {  // Symmetric parameter gives symmetric weights.
+    job.parameter = ozz::math::Float2(.5f, .5f);
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(weights[1], weights[2]);
+    EXPECT_FLOAT_EQ(weights[3], 0.f);
+    EXPECT_FLOAT_EQ(weights[4], 0.f);
+    EXPECT_FLOAT_EQ(weights[0] + weights[1] + weights[2], 1.f);
+  }
+
+  {  // Weights are always normalized.
+    for (float x = -2.f; x <= 2.f; x += .1f) {
+      for (float y = -2.f; y <= 2.f; y += .1f) {
+        job.parameter = ozz::math::Float2(x, y);
+        ASSERT_TRUE(job.Run());
+        float sum = 0.f;
+        for (int j = 0; j < 5; ++j) {
+          EXPECT_GE(weights[j], 0.f);
+          sum += weights[j];
+        }
+        EXPECT_NEAR(sum, 1.f, 1e-5f);
+      }
+    }
+  }
+}
+
+TEST(Threshold, BlendSpaceJob) {
+  const ozz::math::Float2 samples[3] = {ozz::math::Float2(0.f, 0.f),
+                                        ozz::math::Float2(1.f, 0.f),
+                                        ozz::math::Float2(2.f, 0.f)};
+  const float durations[3] = {1.f, 2.f, 3.f};
+  float weights[3];
+  float duration;
+
+  BlendSpaceJob job;
+  job.samples = samples;
+  job.weights = weights;
+  job.durations = durations;
+  job.duration = &duration;
+  job.parameter = ozz::math::Float2(.1f, 0.f);
+
+  {  // No culling.
+    job.threshold = 0.f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(weights[0], .9f);
+    EXPECT_FLOAT_EQ(weights[1], .1f);
+    EXPECT_FLOAT_EQ(weights[2], 0.f);
+    EXPECT_FLOAT_EQ(duration, 1.1f);
+  }
+
+  {  // Threshold lower than the smallest weight.
+    job.threshold = .09f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(weights[0], .9f);
+    EXPECT_FLOAT_EQ(weights[1], .1f);
+    EXPECT_FLOAT_EQ(weights[2], 0.f);
+  }
+
+  {  // Culls the smallest weight.
+    job.threshold = .11f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(weights[0], 1.f);
+    EXPECT_FLOAT_EQ(weights[1], 0.f);
+    EXPECT_FLOAT_EQ(weights[2], 0.f);
+    EXPECT_FLOAT_EQ(duration, 1.f);
+  }
+
+  {  // Highest weight is never culled.
+    job.parameter = ozz::math::Float2(.5f, 0.f);
+    job.threshold = .99f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT_EQ(weights[0] + weights[1], 1.f);
+    EXPECT_FLOAT_EQ(weights[2], 0.f);
+  }
+}
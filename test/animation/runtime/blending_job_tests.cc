@@ -869,3 +869,78 @@ TEST(AdditiveJointWeight, BlendingJob) {
                             1.f / 20.f, 1.f / 11.f, 1.f, 1.f);
   }
 }
+
+TEST(Dirty, BlendingJob) {
+  // Uses more soa transforms than blending chunk size.
+  const size_t kNumSoa = 20;
+  const ozz::math::SoaTransform identity = ozz::math::SoaTransform::identity();
+  ozz::math::SoaTransform input_transforms[2][kNumSoa];
+  ozz::math::SoaTransform bind_poses[kNumSoa];
+  ozz::math::SimdFloat4 joint_weights[kNumSoa];
+  for (size_t i = 0; i < kNumSoa; ++i) {
+    const float f = static_cast<float>(i);
+    input_transforms[0][i] = identity;
+    input_transforms[0][i].translation = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(f, 1.f, 2.f, 3.f),
+        ozz::math::simd_float4::Load(4.f, f, 6.f, 7.f),
+        ozz::math::simd_float4::Load(8.f, 9.f, f, 11.f));
+    input_transforms[1][i] = identity;
+    input_transforms[1][i].translation = -input_transforms[0][i].translation;
+    bind_poses[i] = identity;
+    joint_weights[i] = ozz::math::simd_float4::zero();
+  }
+
+  BlendingJob::Layer layers[2];
+  layers[0].transform = input_transforms[0];
+  layers[0].weight = 1.f;
+  layers[1].transform = input_transforms[1];
+  layers[1].joint_weights = joint_weights;
+  layers[1].weight = 1.f;
+
+  ozz::math::SoaTransform expected[kNumSoa];
+  BlendingJob ref_job;
+  ref_job.layers = layers;
+  ref_job.bind_pose = bind_poses;
+  ref_job.output = expected;
+  ASSERT_TRUE(ref_job.Run());
+
+  ozz::math::SoaTransform output[kNumSoa];
+  memset(output, 0, sizeof(output));
+  uint8_t dirty[3] = {0, 0, 0};
+
+  BlendingJob job;
+  job.layers = layers;
+  job.bind_pose = bind_poses;
+  job.output = output;
+
+  // Dirty range is too small.
+  job.dirty = ozz::span<uint8_t>(dirty, 2);
+  EXPECT_FALSE(job.Validate());
+
+  job.dirty = dirty;
+  EXPECT_TRUE(job.Validate());
+
+  // All outputs change the first time.
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(dirty[0], 0xff);
+  EXPECT_EQ(dirty[1], 0xff);
+  EXPECT_EQ(dirty[2], 0x0f);
+  EXPECT_EQ(memcmp(output, expected, sizeof(output)), 0);
+
+  // Nothing changes when inputs are the same.
+  dirty[0] = dirty[1] = dirty[2] = 0;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(dirty[0], 0);
+  EXPECT_EQ(dirty[1], 0);
+  EXPECT_EQ(dirty[2], 0);
+
+  // Changes weights of 2 soa transforms, in different chunks.
+  joint_weights[3] = ozz::math::simd_float4::Load(0.f, 0.f, 1.f, 0.f);
+  joint_weights[17] = ozz::math::simd_float4::one();
+  ASSERT_TRUE(ref_job.Run());
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(dirty[0], 0x08);
+  EXPECT_EQ(dirty[1], 0);
+  EXPECT_EQ(dirty[2], 0x02);
+  EXPECT_EQ(memcmp(output, expected, sizeof(output)), 0);
+}
@@ -0,0 +1,391 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/inertialization_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/soa_transform.h"
+
+using ozz::animation::InertializationCaptureJob;
+using ozz::animation::InertializationJob;
+using ozz::animation::SoaInertializationOffset;
+
+TEST(JobValidity, InertializationCaptureJob) {
+  const ozz::math::SoaTransform transforms[2] = {
+      ozz::math::SoaTransform::identity(), ozz::math::SoaTransform::identity()};
+  SoaInertializationOffset offsets[2];
+
+  {  // Default job.
+    InertializationCaptureJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid delta time.
+    InertializationCaptureJob job;
+    job.source = transforms;
+    job.previous_source = transforms;
+    job.target = transforms;
+    job.offsets = offsets;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+    job.delta_time = -1.f;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Empty target.
+    InertializationCaptureJob job;
+    job.delta_time = 1.f / 30.f;
+    job.source = transforms;
+    job.previous_source = transforms;
+    job.offsets = offsets;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Source too small.
+    InertializationCaptureJob job;
+    job.delta_time = 1.f / 30.f;
+    job.source = {transforms, 1};
+    job.previous_source = transforms;
+    job.target = transforms;
+    job.offsets = offsets;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Previous source too small.
+    InertializationCaptureJob job;
+    job.delta_time = 1.f / 30.f;
+    job.source = transforms;
+    job.previous_source = {transforms, 1};
+    job.target = transforms;
+    job.offsets = offsets;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Previous target too small.
+    InertializationCaptureJob job;
+    job.delta_time = 1.f / 30.f;
+    job.source = transforms;
+    job.previous_source = transforms;
+    job.target = transforms;
+    job.previous_target = {transforms, 1};
+    job.offsets = offsets;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Offsets too small.
+    InertializationCaptureJob job;
+    job.delta_time = 1.f / 30.f;
+    job.source = transforms;
+    job.previous_source = transforms;
+    job.target = transforms;
+    job.offsets = {offsets, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid job.
+    InertializationCaptureJob job;
+    job.delta_time = 1.f / 30.f;
+    job.source = transforms;
+    job.previous_source = transforms;
+    job.target = transforms;
+    job.offsets = offsets;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid job with previous target.
+    InertializationCaptureJob job;
+    job.delta_time = 1.f / 30.f;
+    job.source = transforms;
+    job.previous_source = transforms;
+    job.target = transforms;
+    job.previous_target = transforms;
+    job.offsets = offsets;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid job, smaller target.
+    InertializationCaptureJob job;
+    job.delta_time = 1.f / 30.f;
+    job.source = transforms;
+    job.previous_source = transforms;
+    job.target = {transforms, 1};
+    job.offsets = offsets;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(JobValidity, InertializationJob) {
+  const ozz::math::SoaTransform transforms[2] = {
+      ozz::math::SoaTransform::identity(), ozz::math::SoaTransform::identity()};
+  const SoaInertializationOffset offsets[2] = {};
+  ozz::math::SoaTransform output[2];
+
+  {  // Default job.
+    InertializationJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid halflife.
+    InertializationJob job;
+    job.halflife = 0.f;
+    job.offsets = offsets;
+    job.target = transforms;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid time.
+    InertializationJob job;
+    job.time = -1.f;
+    job.offsets = offsets;
+    job.target = transforms;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Offsets too small.
+    InertializationJob job;
+    job.offsets = {offsets, 1};
+    job.target = transforms;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Output too small.
+    InertializationJob job;
+    job.offsets = offsets;
+    job.target = transforms;
+    job.output = {output, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid job.
+    InertializationJob job;
+    job.time = 1.f;
+    job.offsets = offsets;
+    job.target = transforms;
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid job, smaller target.
+    InertializationJob job;
+    job.offsets = offsets;
+    job.target = {transforms, 1};
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+namespace {
+// Rotation of .1 radian around y axis per frame, for the 1st joint only.
+const float kSin = .04997917f;  // sin(.1/2)
+const float kCos = .99875026f;  // cos(.1/2)
+}  // namespace
+
+TEST(Capture, InertializationJob) {
+  const ozz::math::SimdFloat4 zero = ozz::math::simd_float4::zero();
+  const ozz::math::SimdFloat4 one = ozz::math::simd_float4::one();
+
+  ozz::math::SoaTransform previous_source = {
+      {ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 3.f), zero, zero},
+      ozz::math::SoaQuaternion::identity(),
+      {one, one, ozz::math::simd_float4::Load(1.f, 1.f, 2.f, 1.f)}};
+  ozz::math::SoaTransform source = {
+      {ozz::math::simd_float4::Load(1.f, 1.f, 2.f, 3.f), zero, zero},
+      {zero, ozz::math::simd_float4::Load(kSin, 0.f, 0.f, 0.f), zero,
+       ozz::math::simd_float4::Load(kCos, 1.f, 1.f, 1.f)},
+      {one, one, ozz::math::simd_float4::Load(1.f, 1.f, 3.f, 1.f)}};
+  ozz::math::SoaTransform target = {
+      {zero, ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 5.f), zero},
+      ozz::math::SoaQuaternion::identity(),
+      ozz::math::SoaFloat3::one()};
+
+  SoaInertializationOffset offsets[1];
+
+  InertializationCaptureJob job;
+  job.delta_time = .5f;
+  job.source = {&source, 1};
+  job.previous_source = {&previous_source, 1};
+  job.target = {&target, 1};
+  job.offsets = offsets;
+  ASSERT_TRUE(job.Run());
+
+  EXPECT_SOAFLOAT3_EQ(offsets[0].translation, 1.f, 1.f, 2.f, 3.f, 0.f, 0.f,
+                      0.f, -5.f, 0.f, 0.f, 0.f, 0.f);
+  EXPECT_SOAFLOAT3_EQ(offsets[0].translation_velocity, 2.f, 0.f, 0.f, 0.f, 0.f,
+                      0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+  EXPECT_SOAFLOAT3_EQ(offsets[0].rotation, 0.f, 0.f, 0.f, 0.f, kSin, 0.f, 0.f,
+                      0.f, 0.f, 0.f, 0.f, 0.f);
+  EXPECT_SOAFLOAT3_EQ(offsets[0].rotation_velocity, 0.f, 0.f, 0.f, 0.f,
+                      kSin * 2.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+  EXPECT_SOAFLOAT3_EQ(offsets[0].scale, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                      0.f, 0.f, 2.f, 0.f);
+  EXPECT_SOAFLOAT3_EQ(offsets[0].scale_velocity, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                      0.f, 0.f, 0.f, 0.f, 2.f, 0.f);
+
+  // Target moving with the same velocity as the source.
+  job.previous_target = {&previous_source, 1};
+  job.target = {&source, 1};
+  ASSERT_TRUE(job.Run());
+
+  EXPECT_SOAFLOAT3_EQ(offsets[0].translation_velocity, 0.f, 0.f, 0.f, 0.f, 0.f,
+                      0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+  EXPECT_SOAFLOAT3_EQ(offsets[0].rotation_velocity, 0.f, 0.f, 0.f, 0.f, 0.f,
+                      0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+  EXPECT_SOAFLOAT3_EQ(offsets[0].scale_velocity, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                      0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+}
+
+TEST(CaptureShortestPath, InertializationJob) {
+  // Source and target are the same rotation, but with opposed quaternions.
+  ozz::math::SoaTransform source = ozz::math::SoaTransform::identity();
+  source.rotation.y = ozz::math::simd_float4::Load1(-kSin);
+  source.rotation.w = ozz::math::simd_float4::Load1(-kCos);
+  ozz::math::SoaTransform target = ozz::math::SoaTransform::identity();
+  target.rotation.y = ozz::math::simd_float4::Load1(kSin);
+  target.rotation.w = ozz::math::simd_float4::Load1(kCos);
+
+  SoaInertializationOffset offsets[1];
+
+  InertializationCaptureJob job;
+  job.delta_time = 1.f;
+  job.source = {&source, 1};
+  job.previous_source = {&source, 1};
+  job.target = {&target, 1};
+  job.offsets = offsets;
+  ASSERT_TRUE(job.Run());
+
+  EXPECT_SOAFLOAT3_EQ(offsets[0].rotation, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                      0.f, 0.f, 0.f, 0.f, 0.f);
+}
+
+TEST(Decay, InertializationJob) {
+  const ozz::math::SimdFloat4 zero = ozz::math::simd_float4::zero();
+  const ozz::math::SimdFloat4 one = ozz::math::simd_float4::one();
+
+  // Source is moving along x, rotating around y and scaling along z.
+  ozz::math::SoaTransform previous_source = {
+      {ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 3.f), zero, zero},
+      ozz::math::SoaQuaternion::identity(),
+      ozz::math::SoaFloat3::one()};
+  ozz::math::SoaTransform source = {
+      {ozz::math::simd_float4::Load(.01f, 1.f, 2.f, 3.f), zero, zero},
+      {zero, ozz::math::simd_float4::Load(kSin, 0.f, 0.f, 0.f), zero,
+       ozz::math::simd_float4::Load(kCos, 1.f, 1.f, 1.f)},
+      {one, one, ozz::math::simd_float4::Load(1.f, 1.f, 3.f, 1.f)}};
+  const ozz::math::SoaTransform target = {
+      {zero, ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 5.f), zero},
+      ozz::math::SoaQuaternion::identity(),
+      ozz::math::SoaFloat3::one()};
+
+  SoaInertializationOffset offsets[1];
+  InertializationCaptureJob capture;
+  capture.delta_time = 1.f / 30.f;
+  capture.source = {&source, 1};
+  capture.previous_source = {&previous_source, 1};
+  capture.target = {&target, 1};
+  capture.offsets = offsets;
+  ASSERT_TRUE(capture.Run());
+
+  ozz::math::SoaTransform output[1];
+  InertializationJob job;
+  job.halflife = .2f;
+  job.offsets = offsets;
+  job.target = {&target, 1};
+  job.output = output;
+
+  {  // Source pose is restored at the beginning of the transition.
+    job.time = 0.f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ(output[0].translation, .01f, 1.f, 2.f, 3.f, 0.f, 0.f,
+                        0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAQUATERNION_EQ_EST(output[0].rotation, 0.f, 0.f, 0.f, 0.f, kSin,
+                                0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, kCos, 1.f,
+                                1.f, 1.f);
+    EXPECT_SOAFLOAT3_EQ(output[0].scale, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f,
+                        1.f, 1.f, 1.f, 3.f, 1.f);
+  }
+
+  {  // Source velocity is preserved at the beginning of the transition.
+    job.time = 1e-3f;
+    ASSERT_TRUE(job.Run());
+    const float x = ozz::math::GetX(output[0].translation.x);
+    EXPECT_NEAR(x, .01f + .3f * 1e-3f, 1e-5f);
+  }
+
+  {  // Offsets without velocity are halved after halflife.
+    job.time = job.halflife;
+    ASSERT_TRUE(job.Run());
+    ExpectFloatNear(ozz::math::GetY(output[0].translation.x), .5f);
+    ExpectFloatNear(ozz::math::GetZ(output[0].translation.x), 1.f);
+    ExpectFloatNear(ozz::math::GetW(output[0].translation.x), 1.5f);
+    ExpectFloatNear(ozz::math::GetW(output[0].translation.y), 2.5f);
+  }
+
+  {  // Target pose is reached after a while.
+    job.time = 20.f * job.halflife;
+    ASSERT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ(output[0].translation, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                        0.f, 5.f, 0.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAQUATERNION_EQ_EST(output[0].rotation, 0.f, 0.f, 0.f, 0.f, 0.f,
+                                0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f,
+                                1.f, 1.f);
+    EXPECT_SOAFLOAT3_EQ(output[0].scale, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f,
+                        1.f, 1.f, 1.f, 1.f, 1.f);
+  }
+
+  {  // Output can be the target buffer.
+    ozz::math::SoaTransform inplace = target;
+    job.time = 0.f;
+    job.target = {&inplace, 1};
+    job.output = {&inplace, 1};
+    ASSERT_TRUE(job.Run());
+    EXPECT_SOAFLOAT3_EQ(inplace.translation, .01f, 1.f, 2.f, 3.f, 0.f, 0.f,
+                        0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAFLOAT3_EQ(inplace.scale, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f,
+                        1.f, 1.f, 3.f, 1.f);
+  }
+}
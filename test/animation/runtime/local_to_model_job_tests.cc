@@ -25,12 +25,16 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <cmath>
+#include <string>
+
 #include "gtest/gtest.h"
 #include "ozz/animation/offline/raw_skeleton.h"
 #include "ozz/animation/offline/skeleton_builder.h"
 #include "ozz/animation/runtime/local_to_model_job.h"
 #include "ozz/animation/runtime/skeleton.h"
 #include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/soa_float4x4.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/unique_ptr.h"
 
@@ -127,6 +131,37 @@ TEST(JobValidity, LocalToModel) {
     EXPECT_TRUE(job.Validate());
     EXPECT_TRUE(job.Run());
   }
+  // Valid job with soa output only.
+  {
+    ozz::math::SoaFloat4x4 soa_output[1];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.soa_output = soa_output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  // Valid job with affine output only.
+  {
+    ozz::math::Float3x4 affine_output[2];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.affine_output = affine_output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  // Invalid affine output.
+  {
+    ozz::math::Float3x4 affine_output[1];
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = {output, output + 2};
+    job.affine_output = affine_output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
   // Valid job with root matrix.
   {
     LocalToModelJob job;
@@ -1026,3 +1061,328 @@ TEST(Empty, LocalToModel) {
     EXPECT_TRUE(job.Run());
   }
 }
+
+TEST(AlternativeOutputs, LocalToModel) {
+  // Builds a skeleton with both wide and deep parts, so that soa elements are
+  // computed at once or joint by joint. Joints are indexed in depth-first
+  // order.
+  /*
+   14 joints
+            *
+        /       \
+      j0         j13
+   /  / ... \
+  j1 j2 ... j8
+             |
+            j9
+             |
+            j10
+            / \
+          j11 j12
+  */
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(2);
+  RawSkeleton::Joint& j0 = raw_skeleton.roots[0];
+  j0.name = "j0";
+  raw_skeleton.roots[1].name = "j13";
+  j0.children.resize(8);
+  for (int i = 0; i < 8; ++i) {
+    j0.children[i].name = ("j" + std::to_string(i + 1)).c_str();
+  }
+  j0.children[7].children.resize(1);
+  RawSkeleton::Joint& j9 = j0.children[7].children[0];
+  j9.name = "j9";
+  j9.children.resize(1);
+  RawSkeleton::Joint& j10 = j9.children[0];
+  j10.name = "j10";
+  j10.children.resize(2);
+  j10.children[0].name = "j11";
+  j10.children[1].name = "j12";
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 14);
+  ASSERT_EQ(skeleton->num_soa_joints(), 4);
+
+  // Initializes input transformations with different values for each joint.
+  float translations[3][16];
+  float rotations[4][16];
+  float scales[16];
+  for (int i = 0; i < 16; ++i) {
+    const float angle = i * .3f;
+    const ozz::math::Float3 axis = Normalize(ozz::math::Float3(1.f, i, 2.f));
+    translations[0][i] = i * 1.f;
+    translations[1][i] = i * 2.f;
+    translations[2][i] = -i * 1.f;
+    rotations[0][i] = axis.x * std::sin(angle * .5f);
+    rotations[1][i] = axis.y * std::sin(angle * .5f);
+    rotations[2][i] = axis.z * std::sin(angle * .5f);
+    rotations[3][i] = std::cos(angle * .5f);
+    scales[i] = 1.f + i * .1f;
+  }
+  ozz::math::SoaTransform input[4];
+  for (int i = 0; i < 4; ++i) {
+    for (int c = 0; c < 3; ++c) {
+      (&input[i].translation.x)[c] =
+          ozz::math::simd_float4::LoadPtrU(&translations[c][i * 4]);
+      (&input[i].scale.x)[c] = ozz::math::simd_float4::LoadPtrU(&scales[i * 4]);
+    }
+    for (int c = 0; c < 4; ++c) {
+      (&input[i].rotation.x)[c] =
+          ozz::math::simd_float4::LoadPtrU(&rotations[c][i * 4]);
+    }
+  }
+
+  const ozz::math::Float4x4 world = ozz::math::Float4x4::Translation(
+      ozz::math::simd_float4::Load(4.f, 3.f, 2.f, 1.f));
+
+  // Compares soa, affine and depth ordered outputs to aos output, for
+  // different update ranges.
+  const int froms[] = {Skeleton::kNoParent, 0, 3, 8, 9, 13};
+  const int tos[] = {Skeleton::kMaxJoints, 0, 5, 10, 12};
+  for (const int from : froms) {
+    for (const int to : tos) {
+      for (int excluded = 0; excluded < 2; ++excluded) {
+        ozz::math::Float4x4 output[14];
+        ozz::math::SoaFloat4x4 soa_output[4];
+        ozz::math::Float3x4 affine_output[14];
+        for (int i = 0; i < 14; ++i) {
+          output[i] = ozz::math::Float4x4::identity();
+          affine_output[i] = ozz::math::Float3x4::identity();
+        }
+        for (int i = 0; i < 4; ++i) {
+          soa_output[i] = ozz::math::SoaFloat4x4::identity();
+        }
+
+        LocalToModelJob job;
+        job.skeleton = skeleton.get();
+        job.root = &world;
+        job.from = from;
+        job.to = to;
+        job.from_excluded = excluded != 0;
+        job.input = input;
+        job.output = output;
+        ASSERT_TRUE(job.Run());
+
+        ozz::math::Float4x4 depth_output[14];
+        for (int i = 0; i < 14; ++i) {
+          depth_output[i] = ozz::math::Float4x4::identity();
+        }
+        LocalToModelJob depth_job = job;
+        depth_job.depth_ordered = true;
+        depth_job.output = depth_output;
+        ASSERT_TRUE(depth_job.Run());
+
+        job.affine_output = affine_output;
+        ASSERT_TRUE(job.Run());
+
+        job.soa_output = soa_output;
+        ASSERT_TRUE(job.Run());
+
+        for (int i = 0; i < 14; ++i) {
+          const float* soa =
+              reinterpret_cast<const float*>(soa_output[i / 4].cols) + (i & 3);
+          const float* aos = reinterpret_cast<const float*>(output[i].cols);
+          for (int e = 0; e < 16; ++e) {
+            EXPECT_NEAR(soa[e * 4], aos[e], 1e-4f)
+                << "from " << from << ", to " << to << ", excluded "
+                << excluded << ", joint " << i;
+          }
+          const float* depth =
+              reinterpret_cast<const float*>(depth_output[i].cols);
+          for (int e = 0; e < 16; ++e) {
+            EXPECT_NEAR(depth[e], aos[e], 1e-4f)
+                << "from " << from << ", to " << to << ", excluded "
+                << excluded << ", joint " << i;
+          }
+          const ozz::math::Float4x4 affine = ToFloat4x4(affine_output[i]);
+          const float* aff = reinterpret_cast<const float*>(affine.cols);
+          for (int e = 0; e < 16; ++e) {
+            EXPECT_NEAR(aff[e], aos[e], 1e-4f)
+                << "from " << from << ", to " << to << ", excluded "
+                << excluded << ", joint " << i;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(DepthOrdered, LocalToModel) {
+  // Builds a skeleton whose levels mix joints with different parents, and
+  // contains a chain.
+  /*
+   10 joints
+          *
+       /     \
+      j0      j4
+    / | \   / | \
+   j1 j2 j3 j5 j6 j7
+                  |
+                  j8
+                  |
+                  j9
+  */
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(2);
+  for (int r = 0; r < 2; ++r) {
+    RawSkeleton::Joint& root = raw_skeleton.roots[r];
+    root.name = ("j" + std::to_string(r * 4)).c_str();
+    root.children.resize(3);
+    for (int i = 0; i < 3; ++i) {
+      root.children[i].name = ("j" + std::to_string(r * 4 + i + 1)).c_str();
+    }
+  }
+  RawSkeleton::Joint& j7 = raw_skeleton.roots[1].children[2];
+  j7.children.resize(1);
+  j7.children[0].name = "j8";
+  j7.children[0].children.resize(1);
+  j7.children[0].children[0].name = "j9";
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 10);
+  EXPECT_EQ(skeleton->depth_offsets().size(), 5u);
+
+  // Initializes input transformations with different values for each joint.
+  ozz::math::SoaTransform input[3];
+  for (int i = 0; i < 3; ++i) {
+    const float f = i * 4.f;
+    input[i].translation = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(f, f + 1.f, f + 2.f, f + 3.f),
+        ozz::math::simd_float4::Load(1.f, -2.f, 3.f, -4.f),
+        ozz::math::simd_float4::Load(-f, 0.f, f, 1.f));
+    input[i].rotation = ozz::math::SoaQuaternion::Load(
+        ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, .5f),
+        ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, .5f),
+        ozz::math::simd_float4::Load(0.f, 0.f, .70710677f, .5f),
+        ozz::math::simd_float4::Load(.70710677f, .70710677f, .70710677f,
+                                     .5f));
+    input[i].scale = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(1.f, 2.f, 1.f, .5f),
+        ozz::math::simd_float4::Load(1.f, 1.f, 3.f, .5f),
+        ozz::math::simd_float4::Load(1.f, -1.f, 1.f, .5f));
+  }
+
+  const ozz::math::Float4x4 world = ozz::math::Float4x4::Translation(
+      ozz::math::simd_float4::Load(4.f, 3.f, 2.f, 1.f));
+
+  ozz::math::Float4x4 output[10];
+  ozz::math::Float4x4 depth_output[10];
+  LocalToModelJob job;
+  job.skeleton = skeleton.get();
+  job.root = &world;
+  job.input = input;
+  job.output = output;
+  ASSERT_TRUE(job.Run());
+
+  job.depth_ordered = true;
+  job.output = depth_output;
+  ASSERT_TRUE(job.Run());
+
+  for (int i = 0; i < 10; ++i) {
+    const float* expected = reinterpret_cast<const float*>(output[i].cols);
+    const float* depth = reinterpret_cast<const float*>(depth_output[i].cols);
+    for (int e = 0; e < 16; ++e) {
+      EXPECT_NEAR(depth[e], expected[e], 1e-4f) << "joint " << i;
+    }
+  }
+}
+
+TEST(Dirty, LocalToModel) {
+  /*
+    8 joints
+         *
+       /   \
+      j0    j6
+    / | \    \
+   j1 j3 j4   j7
+   |      |
+   j2     j5
+  */
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(2);
+  RawSkeleton::Joint& j0 = raw_skeleton.roots[0];
+  j0.name = "j0";
+  j0.children.resize(3);
+  j0.children[0].name = "j1";
+  j0.children[0].children.resize(1);
+  j0.children[0].children[0].name = "j2";
+  j0.children[1].name = "j3";
+  j0.children[2].name = "j4";
+  j0.children[2].children.resize(1);
+  j0.children[2].children[0].name = "j5";
+  RawSkeleton::Joint& j6 = raw_skeleton.roots[1];
+  j6.name = "j6";
+  j6.children.resize(1);
+  j6.children[0].name = "j7";
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 8);
+
+  ozz::math::SoaTransform input[2] = {ozz::math::SoaTransform::identity(),
+                                      ozz::math::SoaTransform::identity()};
+  input[0].translation = ozz::math::SoaFloat3::Load(
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 4.f),
+      ozz::math::simd_float4::zero(), ozz::math::simd_float4::zero());
+  input[1].translation = ozz::math::SoaFloat3::Load(
+      ozz::math::simd_float4::zero(),
+      ozz::math::simd_float4::Load(5.f, 6.f, 7.f, 8.f),
+      ozz::math::simd_float4::zero());
+
+  ozz::math::Float4x4 expected[8];
+  LocalToModelJob ref_job;
+  ref_job.skeleton = skeleton.get();
+  ref_job.input = input;
+  ref_job.output = expected;
+  ASSERT_TRUE(ref_job.Run());
+
+  ozz::math::Float4x4 output[8];
+  memset(output, 0xde, sizeof(output));
+  uint8_t dirty[1] = {0x03};
+
+  LocalToModelJob job;
+  job.skeleton = skeleton.get();
+  job.input = input;
+  job.output = output;
+
+  job.dirty = dirty;
+  EXPECT_TRUE(job.Validate());
+
+  // All joints are updated.
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(memcmp(output, expected, sizeof(output)), 0);
+
+  // Nothing is dirty, nothing is updated.
+  const ozz::math::Float4x4 sentinel =
+      ozz::math::Float4x4::Scaling(ozz::math::simd_float4::Load1(46.f));
+  output[2] = sentinel;
+  output[7] = sentinel;
+  dirty[0] = 0;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(memcmp(&output[2], &sentinel, sizeof(sentinel)), 0);
+  EXPECT_EQ(memcmp(&output[7], &sentinel, sizeof(sentinel)), 0);
+
+  // Changes j0 local transform, which affects the first soa element, and j4
+  // and j5 in the second one, but not j6 and j7.
+  input[0].translation.y = ozz::math::simd_float4::Load(9.f, 0.f, 0.f, 0.f);
+  ASSERT_TRUE(ref_job.Run());
+  output[6] = sentinel;
+  dirty[0] = 0x01;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(memcmp(output, expected, sizeof(ozz::math::Float4x4) * 6), 0);
+  EXPECT_EQ(memcmp(&output[6], &sentinel, sizeof(sentinel)), 0);
+  EXPECT_EQ(memcmp(&output[7], &sentinel, sizeof(sentinel)), 0);
+
+  // Changes j7, only.
+  input[1].translation.x = ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 3.f);
+  ASSERT_TRUE(ref_job.Run());
+  output[6] = expected[6];
+  dirty[0] = 0x02;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(memcmp(output, expected, sizeof(output)), 0);
+}
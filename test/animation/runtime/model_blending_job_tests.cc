@@ -0,0 +1,259 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/model_blending_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/math_constant.h"
+#include "ozz/base/maths/simd_math.h"
+
+using ozz::animation::ModelBlendingJob;
+
+TEST(JobValidity, ModelBlendingJob) {
+  const ozz::math::Float4x4 bind_pose[5] = {};
+  const ozz::math::Float4x4 input[5] = {};
+  const ozz::math::SimdFloat4 joint_weights[2] = {};
+  ozz::math::Float4x4 output[5];
+
+  ModelBlendingJob::Layer layers[2];
+  layers[0].transform = input;
+  layers[1].transform = input;
+
+  {  // Default job.
+    ModelBlendingJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid output.
+    ModelBlendingJob job;
+    job.bind_pose = bind_pose;
+    job.output = {output, 4};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid threshold.
+    ModelBlendingJob job;
+    job.bind_pose = bind_pose;
+    job.output = output;
+    job.threshold = 0.f;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid layer transforms.
+    ModelBlendingJob::Layer invalid_layers[1];
+    invalid_layers[0].transform = {input, 4};
+
+    ModelBlendingJob job;
+    job.bind_pose = bind_pose;
+    job.output = output;
+    job.layers = invalid_layers;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid layer joint weights.
+    ModelBlendingJob::Layer invalid_layers[1];
+    invalid_layers[0].transform = input;
+    invalid_layers[0].joint_weights = {joint_weights, 1};
+
+    ModelBlendingJob job;
+    job.bind_pose = bind_pose;
+    job.output = output;
+    job.layers = invalid_layers;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid no layer.
+    ModelBlendingJob job;
+    job.bind_pose = bind_pose;
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+  }
+
+  {  // Valid job.
+    layers[1].joint_weights = joint_weights;
+
+    ModelBlendingJob job;
+    job.bind_pose = bind_pose;
+    job.output = output;
+    job.layers = layers;
+    EXPECT_TRUE(job.Validate());
+  }
+}
+
+TEST(Empty, ModelBlendingJob) {
+  // Bind pose isn't a multiple of 4, to test remaining joints.
+  ozz::math::Float4x4 bind_pose[5];
+  for (int i = 0; i < 5; ++i) {
+    bind_pose[i] = ozz::math::Float4x4::Translation(
+        ozz::math::simd_float4::Load(i * 1.f, 0.f, 0.f, 0.f));
+  }
+  bind_pose[4] = bind_pose[4] * ozz::math::Float4x4::Scaling(
+                                    ozz::math::simd_float4::Load1(2.f));
+
+  ozz::math::Float4x4 output[5];
+
+  ModelBlendingJob job;
+  job.bind_pose = bind_pose;
+  job.output = output;
+  ASSERT_TRUE(job.Run());
+
+  EXPECT_FLOAT4x4_EQ(output[0], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[3], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 3.f, 0.f, 0.f, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[4], 2.f, 0.f, 0.f, 0.f, 0.f, 2.f, 0.f, 0.f, 0.f,
+                     0.f, 2.f, 0.f, 4.f, 0.f, 0.f, 1.f);
+}
+
+TEST(Weight, ModelBlendingJob) {
+  const ozz::math::Float4x4 bind_pose[5] = {
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::identity()};
+
+  // Layer 0 translates along x, layer 1 rotates along y and scales.
+  ozz::math::Float4x4 input0[5];
+  ozz::math::Float4x4 input1[5];
+  for (int i = 0; i < 5; ++i) {
+    input0[i] = ozz::math::Float4x4::Translation(
+        ozz::math::simd_float4::Load(2.f, 0.f, i * 1.f, 0.f));
+    input1[i] = ozz::math::Float4x4::FromAffine(
+        ozz::math::simd_float4::zero(),
+        ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, .70710677f),
+        ozz::math::simd_float4::Load1(3.f));
+  }
+
+  ozz::math::Float4x4 output[5];
+
+  ModelBlendingJob::Layer layers[2];
+  layers[0].transform = input0;
+  layers[1].transform = input1;
+
+  ModelBlendingJob job;
+  job.bind_pose = bind_pose;
+  job.layers = layers;
+  job.output = output;
+
+  {  // Layer 0 only.
+    layers[0].weight = 1.f;
+    layers[1].weight = 0.f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT4x4_EQ(output[0], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                       0.f, 1.f, 0.f, 2.f, 0.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(output[4], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                       0.f, 1.f, 0.f, 2.f, 0.f, 4.f, 1.f);
+  }
+
+  {  // Layer 1 only.
+    layers[0].weight = 0.f;
+    layers[1].weight = 1.f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT4x4_EQ(output[1], 0.f, 0.f, -3.f, 0.f, 0.f, 3.f, 0.f, 0.f, 3.f,
+                       0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f);
+  }
+
+  {  // Both layers, rotations are interpolated.
+    layers[0].weight = .5f;
+    layers[1].weight = .5f;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_FLOAT4x4_EQ(output[i], 1.4142135f, 0.f, -1.4142135f, 0.f, 0.f,
+                         2.f, 0.f, 0.f, 1.4142135f, 0.f, 1.4142135f, 0.f, 1.f,
+                         0.f, i * .5f, 1.f);
+    }
+  }
+
+  {  // Weights are normalized.
+    layers[0].weight = 2.f;
+    layers[1].weight = 2.f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT4x4_EQ(output[3], 1.4142135f, 0.f, -1.4142135f, 0.f, 0.f, 2.f,
+                       0.f, 0.f, 1.4142135f, 0.f, 1.4142135f, 0.f, 1.f, 0.f,
+                       1.5f, 1.f);
+  }
+
+  {  // Accumulated weight is lower than the threshold, bind pose is blended.
+    layers[0].weight = .05f;
+    layers[1].weight = 0.f;
+    job.threshold = .1f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT4x4_EQ(output[2], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                       0.f, 1.f, 0.f, 1.f, 0.f, 1.f, 1.f);
+  }
+}
+
+TEST(JointWeights, ModelBlendingJob) {
+  const ozz::math::Float4x4 bind_pose[5] = {
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::identity()};
+
+  ozz::math::Float4x4 input0[5];
+  ozz::math::Float4x4 input1[5];
+  for (int i = 0; i < 5; ++i) {
+    input0[i] = ozz::math::Float4x4::Translation(
+        ozz::math::simd_float4::Load(2.f, 0.f, 0.f, 0.f));
+    input1[i] = ozz::math::Float4x4::Translation(
+        ozz::math::simd_float4::Load(0.f, 4.f, 0.f, 0.f));
+  }
+  const ozz::math::SimdFloat4 joint_weights[2] = {
+      ozz::math::simd_float4::Load(1.f, 0.f, .5f, .02f),
+      ozz::math::simd_float4::Load(-1.f, 0.f, 0.f, 0.f)};
+
+  ozz::math::Float4x4 output[5];
+
+  ModelBlendingJob::Layer layers[2];
+  layers[0].weight = .5f;
+  layers[0].transform = input0;
+  layers[0].joint_weights = joint_weights;
+  layers[1].weight = .5f;
+  layers[1].transform = input1;
+
+  ModelBlendingJob job;
+  job.bind_pose = bind_pose;
+  job.layers = layers;
+  job.output = output;
+  ASSERT_TRUE(job.Run());
+
+  EXPECT_FLOAT4x4_EQ(output[0], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 1.f, 2.f, 0.f, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[1], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 0.f, 4.f, 0.f, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[2], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 2.f / 3.f, 8.f / 3.f, 0.f, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[3], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, .02f / .51f, 2.f / .51f, 0.f, 1.f);
+  // Negative joint weights are considered as 0.
+  EXPECT_FLOAT4x4_EQ(output[4], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 0.f, 4.f, 0.f, 1.f);
+}
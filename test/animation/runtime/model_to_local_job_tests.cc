@@ -0,0 +1,204 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/model_to_local_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::LocalToModelJob;
+using ozz::animation::ModelToLocalJob;
+using ozz::animation::Skeleton;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+
+TEST(JobValidity, ModelToLocalJob) {
+  RawSkeleton raw_skeleton;
+  SkeletonBuilder builder;
+
+  // Adds 5 joints.
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.name = "root";
+  root.children.resize(4);
+
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+
+  const ozz::math::Float4x4 input[5] = {
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::identity()};
+  ozz::math::SoaTransform output[2];
+
+  {  // Default job.
+    ModelToLocalJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Null skeleton.
+    ModelToLocalJob job;
+    job.input = input;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid input range: too small.
+    ModelToLocalJob job;
+    job.skeleton = skeleton.get();
+    job.input = {input, 4};
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid output range: too small.
+    ModelToLocalJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = {output, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid job.
+    ModelToLocalJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Transform, ModelToLocalJob) {
+  // Builds the following skeleton (6 joints):
+  // j0 ----- j1 -- j2 -- j3
+  //  |        |
+  //  |        \--- j4
+  //  \-- j5
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& j0 = raw_skeleton.roots[0];
+  j0.name = "j0";
+  j0.children.resize(2);
+  j0.children[0].name = "j1";
+  j0.children[1].name = "j5";
+  j0.children[0].children.resize(2);
+  j0.children[0].children[0].name = "j2";
+  j0.children[0].children[1].name = "j4";
+  j0.children[0].children[0].children.resize(1);
+  j0.children[0].children[0].children[0].name = "j3";
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 6);
+
+  // Local transforms, with uniform scales only such that there's no shearing
+  // in model-space.
+  const ozz::math::SoaTransform input[2] = {
+      {ozz::math::SoaFloat3::Load(
+           ozz::math::simd_float4::Load(2.f, 0.f, 1.f, -2.f),
+           ozz::math::simd_float4::Load(2.f, 46.f, 1.f, 3.f),
+           ozz::math::simd_float4::Load(2.f, 0.f, -7.f, 4.f)),
+       ozz::math::SoaQuaternion::Load(
+           ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, 0.f),
+           ozz::math::simd_float4::Load(0.f, 0.f, .38268343f, .5f),
+           ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, .5f),
+           ozz::math::simd_float4::Load(.70710677f, .70710677f, .9238795f,
+                                        .70710677f)),
+       ozz::math::SoaFloat3::Load(
+           ozz::math::simd_float4::Load(1.f, 2.f, .5f, 3.f),
+           ozz::math::simd_float4::Load(1.f, 2.f, .5f, 3.f),
+           ozz::math::simd_float4::Load(1.f, 2.f, .5f, 3.f))},
+      {ozz::math::SoaFloat3::Load(
+           ozz::math::simd_float4::Load(12.f, 0.f, 0.f, 0.f),
+           ozz::math::simd_float4::Load(-6.f, 1.f, 0.f, 0.f),
+           ozz::math::simd_float4::Load(3.f, 0.f, 0.f, 0.f)),
+       ozz::math::SoaQuaternion::Load(
+           ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 0.f),
+           ozz::math::simd_float4::Load(.38268343f, 0.f, 0.f, 0.f),
+           ozz::math::simd_float4::Load(0.f, 0.f, 0.f, 0.f),
+           ozz::math::simd_float4::Load(.9238795f, 1.f, 1.f, 1.f)),
+       ozz::math::SoaFloat3::Load(
+           ozz::math::simd_float4::Load(1.f, .1f, 1.f, 1.f),
+           ozz::math::simd_float4::Load(1.f, .1f, 1.f, 1.f),
+           ozz::math::simd_float4::Load(1.f, .1f, 1.f, 1.f))}};
+
+  const ozz::math::Float4x4 world =
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(4.f, 3.f, 2.f, 1.f)) *
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(.5f, 0.f, 1.f, 0.f));
+
+  for (int with_root = 0; with_root < 2; ++with_root) {
+    // Computes model-space matrices.
+    ozz::math::Float4x4 models[6];
+    LocalToModelJob ltm_job;
+    ltm_job.skeleton = skeleton.get();
+    ltm_job.root = with_root ? &world : nullptr;
+    ltm_job.input = input;
+    ltm_job.output = models;
+    ASSERT_TRUE(ltm_job.Run());
+
+    // Converts back to local-space.
+    ozz::math::SoaTransform output[2];
+    ModelToLocalJob job;
+    job.skeleton = skeleton.get();
+    job.root = with_root ? &world : nullptr;
+    job.input = models;
+    job.output = output;
+    ASSERT_TRUE(job.Run());
+
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 2.f, 0.f, 1.f, -2.f, 2.f,
+                            46.f, 1.f, 3.f, 2.f, 0.f, -7.f, 4.f);
+    EXPECT_SOAQUATERNION_EQ_EST(output[0].rotation, 0.f, .70710677f, 0.f, 0.f,
+                                0.f, 0.f, .38268343f, .5f, .70710677f, 0.f,
+                                0.f, .5f, .70710677f, .70710677f, .9238795f,
+                                .70710677f);
+    EXPECT_SOAFLOAT3_EQ_EST(output[0].scale, 1.f, 2.f, .5f, 3.f, 1.f, 2.f, .5f,
+                            3.f, 1.f, 2.f, .5f, 3.f);
+
+    // Last 2 joints of the 2nd soa element are padding, output identity.
+    EXPECT_SOAFLOAT3_EQ_EST(output[1].translation, 12.f, 0.f, 0.f, 0.f, -6.f,
+                            1.f, 0.f, 0.f, 3.f, 0.f, 0.f, 0.f);
+    EXPECT_SOAQUATERNION_EQ_EST(output[1].rotation, 0.f, 0.f, 0.f, 0.f,
+                                .38268343f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                                .9238795f, 1.f, 1.f, 1.f);
+    EXPECT_SOAFLOAT3_EQ_EST(output[1].scale, 1.f, .1f, 1.f, 1.f, 1.f, .1f, 1.f,
+                            1.f, 1.f, .1f, 1.f, 1.f);
+  }
+}
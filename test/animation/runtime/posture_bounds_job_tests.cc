@@ -0,0 +1,215 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/posture_bounds_job.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/box.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::LocalToModelJob;
+using ozz::animation::PostureBoundsJob;
+using ozz::animation::Skeleton;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+
+namespace {
+// Builds a skeleton with _num_joints joints, all children of the first one.
+ozz::unique_ptr<Skeleton> BuildSkeleton(int _num_joints) {
+  RawSkeleton raw_skeleton;
+  if (_num_joints > 0) {
+    raw_skeleton.roots.resize(1);
+    raw_skeleton.roots[0].name = "root";
+    raw_skeleton.roots[0].children.resize(_num_joints - 1);
+    for (int i = 1; i < _num_joints; ++i) {
+      raw_skeleton.roots[0].children[i - 1].name =
+          ("joint" + std::to_string(i)).c_str();
+    }
+  }
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+}  // namespace
+
+TEST(JobValidity, PostureBoundsJob) {
+  const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton(5);
+  ASSERT_TRUE(skeleton);
+
+  const ozz::math::Float4x4 input[5] = {
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::identity(), ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::identity()};
+  const ozz::math::SoaFloat4x4 soa_input[2] = {
+      ozz::math::SoaFloat4x4::identity(), ozz::math::SoaFloat4x4::identity()};
+  ozz::math::Box box;
+
+  {  // Default job.
+    PostureBoundsJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // No output.
+    PostureBoundsJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Input too small.
+    PostureBoundsJob job;
+    job.skeleton = skeleton.get();
+    job.input = {input, 4};
+    job.output = &box;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Soa input too small.
+    PostureBoundsJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.soa_input = {soa_input, 1};
+    job.output = &box;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid job.
+    PostureBoundsJob job;
+    job.skeleton = skeleton.get();
+    job.input = input;
+    job.output = &box;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Valid soa job.
+    PostureBoundsJob job;
+    job.skeleton = skeleton.get();
+    job.soa_input = soa_input;
+    job.output = &box;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Empty, PostureBoundsJob) {
+  const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton(0);
+  ASSERT_TRUE(skeleton);
+
+  ozz::math::Box box(ozz::math::Float3(0.f));
+  PostureBoundsJob job;
+  job.skeleton = skeleton.get();
+  job.output = &box;
+  ASSERT_TRUE(job.Run());
+  EXPECT_FALSE(box.is_valid());
+}
+
+TEST(Bounds, PostureBoundsJob) {
+  // Tests all padding configurations.
+  for (int num_joints = 1; num_joints <= 9; ++num_joints) {
+    const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton(num_joints);
+    ASSERT_TRUE(skeleton);
+
+    // Root is at (1, 2, 3). Children are offset from root.
+    float translations[3][12] = {};
+    for (int i = 1; i < num_joints; ++i) {
+      translations[0][i] = i * 1.f;
+      translations[1][i] = -i * 2.f;
+      translations[2][i] = (i & 1) ? 10.f : -10.f;
+    }
+    translations[0][0] = 1.f;
+    translations[1][0] = 2.f;
+    translations[2][0] = 3.f;
+
+    // Padding joints have extreme values that must be ignored.
+    for (int i = num_joints; i < 12; ++i) {
+      translations[0][i] = 1000.f;
+      translations[1][i] = -1000.f;
+      translations[2][i] = 1000.f;
+    }
+
+    ozz::math::SoaTransform input[3];
+    for (int i = 0; i < 3; ++i) {
+      input[i] = ozz::math::SoaTransform::identity();
+      input[i].translation.x =
+          ozz::math::simd_float4::LoadPtrU(&translations[0][i * 4]);
+      input[i].translation.y =
+          ozz::math::simd_float4::LoadPtrU(&translations[1][i * 4]);
+      input[i].translation.z =
+          ozz::math::simd_float4::LoadPtrU(&translations[2][i * 4]);
+    }
+
+    ozz::math::Float4x4 models[9];
+    ozz::math::SoaFloat4x4 soa_models[3];
+    for (int i = 0; i < 3; ++i) {
+      soa_models[i] = ozz::math::SoaFloat4x4::FromAffine(
+          input[i].translation, input[i].rotation, input[i].scale);
+    }
+
+    LocalToModelJob ltm_job;
+    ltm_job.skeleton = skeleton.get();
+    ltm_job.input = input;
+    ltm_job.output = models;
+    ASSERT_TRUE(ltm_job.Run());
+    ltm_job.soa_output = soa_models;
+    ASSERT_TRUE(ltm_job.Run());
+
+    // Expected bounds.
+    const float x_max = 1.f + (num_joints - 1);
+    const float y_min = num_joints > 1 ? 2.f - 2.f * (num_joints - 1) : 2.f;
+    const float z_min = num_joints > 2 ? -7.f : 3.f;
+    const float z_max = num_joints > 1 ? 13.f : 3.f;
+
+    ozz::math::Box box;
+    PostureBoundsJob job;
+    job.skeleton = skeleton.get();
+    job.input = models;
+    job.output = &box;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT3_EQ(box.min, 1.f, y_min, z_min);
+    EXPECT_FLOAT3_EQ(box.max, x_max, 2.f, z_max);
+
+    ozz::math::Box soa_box;
+    job.soa_input = soa_models;
+    job.output = &soa_box;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FLOAT3_EQ(soa_box.min, 1.f, y_min, z_min);
+    EXPECT_FLOAT3_EQ(soa_box.max, x_max, 2.f, z_max);
+  }
+}
@@ -638,3 +638,70 @@ TEST(CacheResize, SamplingJob) {
   cache.Resize(1);
   EXPECT_FALSE(job.Validate());
 }
+
+TEST(Dirty, SamplingJob) {
+  // 9 soa tracks, only the first and the last ones are animated.
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(36);
+
+  const RawAnimation::TranslationKey tkey0 = {0.f,
+                                              ozz::math::Float3(1.f, 2.f, 4.f)};
+  const RawAnimation::TranslationKey tkey1 = {1.f,
+                                              ozz::math::Float3(2.f, 4.f, 8.f)};
+  raw_animation.tracks[0].translations.push_back(tkey0);
+  raw_animation.tracks[0].translations.push_back(tkey1);
+  const RawAnimation::ScaleKey skey0 = {0.f, ozz::math::Float3(1.f, 1.f, 1.f)};
+  const RawAnimation::ScaleKey skey1 = {1.f, ozz::math::Float3(2.f, 2.f, 2.f)};
+  raw_animation.tracks[35].scales.push_back(skey0);
+  raw_animation.tracks[35].scales.push_back(skey1);
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+
+  SamplingCache cache(36);
+  ozz::math::SoaTransform output[9];
+  memset(output, 0xde, sizeof(output));
+  uint8_t dirty[2] = {0, 0};
+
+  SamplingJob job;
+  job.animation = animation.get();
+  job.cache = &cache;
+  job.output = output;
+
+  // Dirty range is too small.
+  job.dirty = ozz::span<uint8_t>(dirty, 1);
+  EXPECT_FALSE(job.Validate());
+
+  job.dirty = dirty;
+  EXPECT_TRUE(job.Validate());
+
+  // All outputs change the first time.
+  job.ratio = 0.f;
+  EXPECT_TRUE(job.Run());
+  EXPECT_EQ(dirty[0], 0xff);
+  EXPECT_EQ(dirty[1], 0x01);
+
+  // Nothing changes if the same time is sampled again.
+  dirty[0] = dirty[1] = 0;
+  EXPECT_TRUE(job.Run());
+  EXPECT_EQ(dirty[0], 0);
+  EXPECT_EQ(dirty[1], 0);
+
+  // Only animated tracks change.
+  job.ratio = .5f;
+  EXPECT_TRUE(job.Run());
+  EXPECT_EQ(dirty[0], 0x01);
+  EXPECT_EQ(dirty[1], 0x01);
+  EXPECT_SOAFLOAT3_EQ_EST(output[0].translation, 1.5f, 0.f, 0.f, 0.f, 3.f, 0.f,
+                          0.f, 0.f, 6.f, 0.f, 0.f, 0.f);
+
+  // Bits are accumulated.
+  dirty[0] = 0x80;
+  dirty[1] = 0;
+  job.ratio = .6f;
+  EXPECT_TRUE(job.Run());
+  EXPECT_EQ(dirty[0], 0x81);
+  EXPECT_EQ(dirty[1], 0x01);
+}
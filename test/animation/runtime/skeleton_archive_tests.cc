@@ -112,6 +112,13 @@ TEST(Filled, SkeletonSerialize) {
       EXPECT_EQ(i_skeleton.joint_parents()[i],
                 o_skeleton->joint_parents()[i]);
       EXPECT_STREQ(i_skeleton.joint_names()[i], o_skeleton->joint_names()[i]);
+      EXPECT_EQ(i_skeleton.joints_by_depth()[i],
+                o_skeleton->joints_by_depth()[i]);
+    }
+    ASSERT_EQ(i_skeleton.depth_offsets().size(),
+              o_skeleton->depth_offsets().size());
+    for (size_t i = 0; i < i_skeleton.depth_offsets().size(); ++i) {
+      EXPECT_EQ(i_skeleton.depth_offsets()[i], o_skeleton->depth_offsets()[i]);
     }
     for (int i = 0; i < (i_skeleton.num_joints() + 3) / 4; ++i) {
       EXPECT_TRUE(ozz::math::AreAllTrue(
@@ -34,7 +34,9 @@
 #include "gtest/gtest.h"
 #include "ozz/base/gtest_helper.h"
 #include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_math.h"
 
+#include "ozz/animation/runtime/local_to_model_job.h"
 #include "ozz/animation/runtime/skeleton.h"
 #include "ozz/animation/runtime/skeleton_utils.h"
 #include "ozz/base/memory/unique_ptr.h"
@@ -415,3 +417,110 @@ TEST(IsLeaf, SkeletonUtils) {
   EXPECT_FALSE(IsLeaf(*skeleton, 8));
   EXPECT_TRUE(IsLeaf(*skeleton, 9));
 }
+
+TEST(PartitionHierarchy, SkeletonUtils) {
+  // Builds a millipede like hierarchy, with a wide head.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint* segment = &raw_skeleton.roots[0];
+  segment->name = "root";
+  segment->transform = ozz::math::Transform::identity();
+  int name = 0;
+  for (int s = 0; s < 10; ++s) {
+    segment->children.resize(3);
+    for (int l = 1; l < 3; ++l) {
+      RawSkeleton::Joint* joint = &segment->children[l];
+      for (int j = 0; j < 3; ++j) {
+        joint->name = std::to_string(name++).c_str();
+        joint->transform = ozz::math::Transform::identity();
+        joint->transform.translation.x = l == 1 ? 1.f : -1.f;
+        if (j != 2) {
+          joint->children.resize(1);
+          joint = &joint->children[0];
+        }
+      }
+    }
+    segment = &segment->children[0];
+    segment->name = std::to_string(name++).c_str();
+    segment->transform = ozz::math::Transform::identity();
+    segment->transform.translation.z = 1.f;
+  }
+  segment->children.resize(20);
+  for (RawSkeleton::Joint& joint : segment->children) {
+    joint.name = std::to_string(name++).c_str();
+    joint.transform = ozz::math::Transform::identity();
+    joint.transform.translation.y = 1.f;
+  }
+
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  const int num_joints = skeleton->num_joints();
+  ASSERT_EQ(num_joints, 91);
+
+  // Reference update of the whole hierarchy.
+  ozz::vector<ozz::math::Float4x4> expected(num_joints);
+  ozz::animation::LocalToModelJob job;
+  job.skeleton = skeleton.get();
+  job.input = skeleton->joint_bind_poses();
+  job.output = ozz::make_span(expected);
+  ASSERT_TRUE(job.Run());
+
+  for (int num_tasks = 1; num_tasks < 12; ++num_tasks) {
+    ozz::animation::HierarchyPartition partition;
+    ozz::animation::PartitionHierarchy(*skeleton, num_tasks, &partition);
+
+    // Every joint belongs to a single range.
+    ozz::vector<int> counts(num_joints, 0);
+    for (const ozz::animation::JointRange& range : partition.ancestors) {
+      for (int i = range.from; i <= range.to; ++i) {
+        ++counts[i];
+      }
+    }
+    for (const ozz::animation::JointRange& range : partition.subtrees) {
+      for (int i = range.from; i <= range.to; ++i) {
+        ++counts[i];
+      }
+    }
+    EXPECT_EQ(std::count(counts.begin(), counts.end(), 1), num_joints);
+
+    // Tasks cover all subtrees.
+    ASSERT_GE(partition.tasks.size(), 2u);
+    EXPECT_EQ(partition.tasks.front(), 0);
+    EXPECT_EQ(partition.tasks.back(),
+              static_cast<int>(partition.subtrees.size()));
+    EXPECT_LE(partition.tasks.size(), static_cast<size_t>(num_tasks * 2 + 1));
+    if (num_tasks == 1) {
+      EXPECT_EQ(partition.ancestors.size(), 0u);
+      EXPECT_EQ(partition.subtrees.size(), 1u);
+    }
+
+    // Updates ancestors, then tasks in reverse order.
+    ozz::vector<ozz::math::Float4x4> output(num_joints);
+    memset(output.data(), 0xde, output.size() * sizeof(ozz::math::Float4x4));
+    job.output = ozz::make_span(output);
+    for (const ozz::animation::JointRange& range : partition.ancestors) {
+      job.from = range.from;
+      job.to = range.to;
+      ASSERT_TRUE(job.Run());
+    }
+    for (size_t t = partition.tasks.size() - 1; t > 0; --t) {
+      for (int i = partition.tasks[t - 1]; i < partition.tasks[t]; ++i) {
+        job.from = partition.subtrees[i].from;
+        job.to = partition.subtrees[i].to;
+        ASSERT_TRUE(job.Run());
+      }
+    }
+    EXPECT_EQ(memcmp(output.data(), expected.data(),
+                     output.size() * sizeof(ozz::math::Float4x4)),
+              0);
+  }
+
+  // Empty skeleton.
+  ozz::unique_ptr<Skeleton> empty(builder(RawSkeleton()));
+  ozz::animation::HierarchyPartition partition;
+  ozz::animation::PartitionHierarchy(*empty, 4, &partition);
+  EXPECT_EQ(partition.ancestors.size(), 0u);
+  EXPECT_EQ(partition.subtrees.size(), 0u);
+  EXPECT_EQ(partition.tasks.size(), 1u);
+}
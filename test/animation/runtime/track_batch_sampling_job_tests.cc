@@ -0,0 +1,317 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/track_batch_sampling_job.h"
+
+#include "gtest/gtest.h"
+
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/track_builder.h"
+
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_sampling_job.h"
+
+using ozz::animation::FloatTrack;
+using ozz::animation::Float3Track;
+using ozz::animation::FloatTrackSamplingJob;
+using ozz::animation::Float3TrackSamplingJob;
+using ozz::animation::FloatTrackBatchSamplingJob;
+using ozz::animation::Float3TrackBatchSamplingJob;
+using ozz::animation::FloatTrackMultiSamplingJob;
+using ozz::animation::Float3TrackMultiSamplingJob;
+using ozz::animation::TrackSamplingCache;
+using ozz::animation::offline::RawFloatTrack;
+using ozz::animation::offline::RawFloat3Track;
+using ozz::animation::offline::TrackBuilder;
+using ozz::animation::offline::RawTrackInterpolation;
+
+namespace {
+// Builds a float track with _keys keyframes, some of them being steps. A
+// track with no keyframe is a default track.
+ozz::unique_ptr<FloatTrack> BuildBatchFloatTrack(int _keys, int _seed) {
+  RawFloatTrack raw_track;
+  for (int i = 0; i < _keys; ++i) {
+    const RawFloatTrack::Keyframe key = {
+        (i + _seed) % 5 == 2 ? RawTrackInterpolation::kStep
+                             : RawTrackInterpolation::kLinear,
+        _keys == 1 ? .5f : static_cast<float>(i) / (_keys - 1),
+        ((i + _seed) * 13 % 11) * .5f - _seed};
+    raw_track.keyframes.push_back(key);
+  }
+  TrackBuilder builder;
+  return builder(raw_track);
+}
+
+ozz::unique_ptr<Float3Track> BuildBatchFloat3Track(int _keys, int _seed) {
+  RawFloat3Track raw_track;
+  for (int i = 0; i < _keys; ++i) {
+    const float value = ((i + _seed) * 13 % 11) * .5f - _seed;
+    const RawFloat3Track::Keyframe key = {
+        (i + _seed) % 5 == 2 ? RawTrackInterpolation::kStep
+                             : RawTrackInterpolation::kLinear,
+        _keys == 1 ? .5f : static_cast<float>(i) / (_keys - 1),
+        ozz::math::Float3(value, -value * 2.f, value + 1.f)};
+    raw_track.keyframes.push_back(key);
+  }
+  TrackBuilder builder;
+  return builder(raw_track);
+}
+}  // namespace
+
+TEST(JobValidity, TrackBatchSamplingJob) {
+  ozz::unique_ptr<FloatTrack> track = BuildBatchFloatTrack(3, 0);
+  ASSERT_TRUE(track);
+  const FloatTrack* tracks[] = {track.get(), track.get()};
+  const FloatTrack* null_tracks[] = {track.get(), nullptr};
+  float results[2];
+  TrackSamplingCache caches[2];
+
+  {  // Empty/default job.
+    FloatTrackBatchSamplingJob job;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Invalid track.
+    FloatTrackBatchSamplingJob job;
+    job.tracks = null_tracks;
+    job.results = results;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Results too small.
+    FloatTrackBatchSamplingJob job;
+    job.tracks = tracks;
+    job.results = {results, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Caches too small.
+    FloatTrackBatchSamplingJob job;
+    job.tracks = tracks;
+    job.caches = {caches, 1};
+    job.results = results;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid.
+    FloatTrackBatchSamplingJob job;
+    job.tracks = tracks;
+    job.results = results;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+
+    job.caches = caches;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(JobValidity, TrackMultiSamplingJob) {
+  ozz::unique_ptr<FloatTrack> track = BuildBatchFloatTrack(3, 0);
+  ASSERT_TRUE(track);
+  const float ratios[] = {0.f, .5f};
+  float results[2];
+
+  {  // Empty/default job.
+    FloatTrackMultiSamplingJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // No ratio.
+    FloatTrackMultiSamplingJob job;
+    job.track = track.get();
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Results too small.
+    FloatTrackMultiSamplingJob job;
+    job.track = track.get();
+    job.ratios = ratios;
+    job.results = {results, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid.
+    FloatTrackMultiSamplingJob job;
+    job.track = track.get();
+    job.ratios = ratios;
+    job.results = results;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Float, TrackBatchSamplingJob) {
+  // A number of tracks that isn't a multiple of SIMD lanes, including a
+  // default track and a single key track.
+  ozz::unique_ptr<FloatTrack> tracks[7];
+  const FloatTrack* track_ptrs[7];
+  for (int t = 0; t < 7; ++t) {
+    tracks[t] = BuildBatchFloatTrack(t == 0 ? 0 : t * 5 - 4, t);
+    ASSERT_TRUE(tracks[t]);
+    track_ptrs[t] = tracks[t].get();
+  }
+
+  TrackSamplingCache caches[7];
+  const float ratios[] = {-1.f, 0.f,  .01f, .1f, .2f,  .25f, .33f,
+                          .5f,  .45f, .7f,  .9f, .99f, 1.f,  2.f};
+  for (const float ratio : ratios) {
+    float results[7];
+    FloatTrackBatchSamplingJob job;
+    job.ratio = ratio;
+    job.tracks = track_ptrs;
+    job.results = results;
+    ASSERT_TRUE(job.Run());
+
+    float cached_results[7];
+    job.caches = caches;
+    job.results = cached_results;
+    ASSERT_TRUE(job.Run());
+
+    for (int t = 0; t < 7; ++t) {
+      float expected;
+      FloatTrackSamplingJob single_job;
+      single_job.ratio = ratio;
+      single_job.track = tracks[t].get();
+      single_job.result = &expected;
+      ASSERT_TRUE(single_job.Run());
+
+      EXPECT_FLOAT_EQ(results[t], expected);
+      EXPECT_FLOAT_EQ(cached_results[t], expected);
+    }
+  }
+}
+
+TEST(Float3, TrackBatchSamplingJob) {
+  ozz::unique_ptr<Float3Track> tracks[5];
+  const Float3Track* track_ptrs[5];
+  for (int t = 0; t < 5; ++t) {
+    tracks[t] = BuildBatchFloat3Track(t * 4, t);
+    ASSERT_TRUE(tracks[t]);
+    track_ptrs[t] = tracks[t].get();
+  }
+
+  const float ratios[] = {0.f, .13f, .4f, .41f, .77f, 1.f};
+  for (const float ratio : ratios) {
+    ozz::math::Float3 results[5];
+    Float3TrackBatchSamplingJob job;
+    job.ratio = ratio;
+    job.tracks = track_ptrs;
+    job.results = results;
+    ASSERT_TRUE(job.Run());
+
+    for (int t = 0; t < 5; ++t) {
+      ozz::math::Float3 expected;
+      Float3TrackSamplingJob single_job;
+      single_job.ratio = ratio;
+      single_job.track = tracks[t].get();
+      single_job.result = &expected;
+      ASSERT_TRUE(single_job.Run());
+
+      EXPECT_FLOAT3_EQ(results[t], expected.x, expected.y, expected.z);
+    }
+  }
+}
+
+TEST(Float, TrackMultiSamplingJob) {
+  ozz::unique_ptr<FloatTrack> track = BuildBatchFloatTrack(23, 3);
+  ASSERT_TRUE(track);
+
+  // Unsorted and out of range ratios, not a multiple of SIMD lanes.
+  const float ratios[] = {.5f,  .1f, -1.f, .99f, 0.f, 1.f, .5f,  .3f, .31f,
+                          .05f, 2.f, .7f,  .65f, .2f, .8f, .42f, .9f};
+  const size_t kCount = OZZ_ARRAY_SIZE(ratios);
+  float results[kCount];
+
+  FloatTrackMultiSamplingJob job;
+  job.track = track.get();
+  job.ratios = ratios;
+  job.results = results;
+  ASSERT_TRUE(job.Run());
+
+  for (size_t i = 0; i < kCount; ++i) {
+    float expected;
+    FloatTrackSamplingJob single_job;
+    single_job.ratio = ratios[i];
+    single_job.track = track.get();
+    single_job.result = &expected;
+    ASSERT_TRUE(single_job.Run());
+
+    EXPECT_FLOAT_EQ(results[i], expected);
+  }
+}
+
+TEST(Float3, TrackMultiSamplingJob) {
+  ozz::unique_ptr<Float3Track> track = BuildBatchFloat3Track(9, 1);
+  ASSERT_TRUE(track);
+
+  const float ratios[] = {.9f, .1f, .15f, .6f, 0.f, 1.f};
+  const size_t kCount = OZZ_ARRAY_SIZE(ratios);
+  ozz::math::Float3 results[kCount];
+
+  Float3TrackMultiSamplingJob job;
+  job.track = track.get();
+  job.ratios = ratios;
+  job.results = results;
+  ASSERT_TRUE(job.Run());
+
+  for (size_t i = 0; i < kCount; ++i) {
+    ozz::math::Float3 expected;
+    Float3TrackSamplingJob single_job;
+    single_job.ratio = ratios[i];
+    single_job.track = track.get();
+    single_job.result = &expected;
+    ASSERT_TRUE(single_job.Run());
+
+    EXPECT_FLOAT3_EQ(results[i], expected.x, expected.y, expected.z);
+  }
+}
+
+TEST(Default, TrackMultiSamplingJob) {
+  FloatTrack default_track;
+  const float ratios[] = {0.f, .5f, 1.f, .2f, .3f};
+  float results[5] = {1.f, 1.f, 1.f, 1.f, 1.f};
+
+  FloatTrackMultiSamplingJob job;
+  job.track = &default_track;
+  job.ratios = ratios;
+  job.results = results;
+  ASSERT_TRUE(job.Run());
+  for (const float result : results) {
+    EXPECT_FLOAT_EQ(result, 0.f);
+  }
+}
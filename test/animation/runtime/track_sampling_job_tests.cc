@@ -465,3 +465,76 @@ TEST(Quaternion, TrackSamplingJob) {
   ASSERT_TRUE(sampling.Run());
   EXPECT_QUATERNION_EQ(result, 0.f, 0.f, 0.f, 1.f);
 }
+
+TEST(Cache, TrackSamplingJob) {
+  TrackBuilder builder;
+
+  // Builds 2 tracks with many keys, some of them being steps.
+  ozz::unique_ptr<FloatTrack> tracks[2];
+  for (int t = 0; t < 2; ++t) {
+    RawFloatTrack raw_float_track;
+    const int kKeys = 50 + t * 13;
+    for (int i = 0; i < kKeys; ++i) {
+      const RawFloatTrack::Keyframe key = {
+          i % 7 == 3 ? RawTrackInterpolation::kStep
+                     : RawTrackInterpolation::kLinear,
+          static_cast<float>(i) / (kKeys - 1), (i * 13 % 11) * .5f - t};
+      raw_float_track.keyframes.push_back(key);
+    }
+    tracks[t] = builder(raw_float_track);
+    ASSERT_TRUE(tracks[t]);
+  }
+
+  // Forward small and big steps, repeated ratio, backward, out of range
+  // ratios, and jumps across tracks.
+  const struct {
+    int track;
+    float ratio;
+  } samples[] = {{0, 0.f},  {0, .001f}, {0, .01f},  {0, .03f},  {0, .03f},
+                 {0, .1f},  {0, .5f},   {0, .49f},  {0, .51f},  {0, .52f},
+                 {1, .52f}, {1, .53f},  {0, .54f},  {0, 1.f},   {0, 2.f},
+                 {0, -1.f}, {0, .0f},   {1, .99f},  {1, 1.f},   {1, .2f},
+                 {1, .21f}, {1, .22f},  {1, .237f}, {1, .251f}, {1, .8f}};
+
+  ozz::animation::TrackSamplingCache cache;
+  for (const auto& sample : samples) {
+    float expected_result, result;
+    FloatTrackSamplingJob job;
+    job.track = tracks[sample.track].get();
+    job.ratio = sample.ratio;
+    job.result = &expected_result;
+    ASSERT_TRUE(job.Run());
+
+    job.cache = &cache;
+    job.result = &result;
+    ASSERT_TRUE(job.Run());
+    EXPECT_EQ(result, expected_result)
+        << "track " << sample.track << ", ratio " << sample.ratio;
+  }
+
+  // Forward sampling over the whole track.
+  cache.Invalidate();
+  for (int i = 0; i <= 1000; ++i) {
+    float expected_result, result;
+    FloatTrackSamplingJob job;
+    job.track = tracks[1].get();
+    job.ratio = i / 1000.f;
+    job.result = &expected_result;
+    ASSERT_TRUE(job.Run());
+
+    job.cache = &cache;
+    job.result = &result;
+    ASSERT_TRUE(job.Run());
+    EXPECT_EQ(result, expected_result) << "ratio " << job.ratio;
+  }
+
+  // Cache works with default tracks.
+  FloatTrack default_track;
+  FloatTrackSamplingJob job;
+  job.track = &default_track;
+  job.cache = &cache;
+  float result = 1.f;
+  job.result = &result;
+  EXPECT_TRUE(job.Run());
+  EXPECT_FLOAT_EQ(result, 0.f);
+}
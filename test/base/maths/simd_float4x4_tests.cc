@@ -486,3 +486,73 @@ TEST(Float4x4ToAffine, ozz_simd_math) {
   EXPECT_SIMDFLOAT_EQ(rotate, 0.f, 0.f, 0.f, 1.f);
   EXPECT_SIMDFLOAT_EQ(scale, .000907520065f, .000959928846f, .0159599986f, 1.f);
 }
+
+TEST(Float3x4Constant, ozz_simd_math) {
+  const ozz::math::Float3x4 identity = ozz::math::Float3x4::identity();
+  EXPECT_FLOAT3x4_EQ(identity, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f,
+                     1.f, 0.f);
+}
+
+TEST(Float3x4Conversion, ozz_simd_math) {
+  const Float4x4 m = {{ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 3.f),
+                       ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 7.f),
+                       ozz::math::simd_float4::Load(8.f, 9.f, 10.f, 11.f),
+                       ozz::math::simd_float4::Load(12.f, 13.f, 14.f, 15.f)}};
+  const ozz::math::Float3x4 affine = ozz::math::Float3x4::FromFloat4x4(m);
+  EXPECT_FLOAT3x4_EQ(affine, 0.f, 4.f, 8.f, 12.f, 1.f, 5.f, 9.f, 13.f, 2.f, 6.f,
+                     10.f, 14.f);
+
+  // Last row is restored to [0 0 0 1].
+  const Float4x4 back = ToFloat4x4(affine);
+  EXPECT_FLOAT4x4_EQ(back, 0.f, 1.f, 2.f, 0.f, 4.f, 5.f, 6.f, 0.f, 8.f, 9.f,
+                     10.f, 0.f, 12.f, 13.f, 14.f, 1.f);
+
+  const ozz::math::Float3x4 identity =
+      ozz::math::Float3x4::FromFloat4x4(Float4x4::identity());
+  EXPECT_FLOAT3x4_EQ(identity, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f,
+                     1.f, 0.f);
+}
+
+TEST(Float3x4Arithmetic, ozz_simd_math) {
+  const ozz::math::Float3x4 a = {
+      {ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 4.f),
+       ozz::math::simd_float4::Load(5.f, 6.f, 7.f, 8.f),
+       ozz::math::simd_float4::Load(9.f, 10.f, 11.f, 12.f)}};
+  const ozz::math::Float3x4 b = {
+      {ozz::math::simd_float4::Load(-1.f, 0.f, 2.f, 1.f),
+       ozz::math::simd_float4::Load(0.f, 1.f, -1.f, 2.f),
+       ozz::math::simd_float4::Load(3.f, 0.f, 1.f, -3.f)}};
+  const SimdFloat4 v = ozz::math::simd_float4::Load(-1.f, 2.f, -3.f, 7.f);
+
+  const SimdFloat4 transform_point = TransformPoint(a, v);
+  EXPECT_SIMDFLOAT_EQ(transform_point, -2.f, -6.f, -10.f, 1.f);
+
+  const SimdFloat4 transform_vector = TransformVector(a, v);
+  EXPECT_SIMDFLOAT_EQ(transform_vector, -6.f, -14.f, -22.f, 0.f);
+
+  const ozz::math::Float3x4 mul_mat = a * b;
+  EXPECT_FLOAT3x4_EQ(mul_mat, 8.f, 2.f, 3.f, 0.f, 16.f, 6.f, 11.f, 4.f, 24.f,
+                     10.f, 19.f, 8.f);
+
+  // Matches 4x4 matrices multiplication.
+  const ozz::math::Float3x4 mul_mat44 =
+      ozz::math::Float3x4::FromFloat4x4(ToFloat4x4(a) * ToFloat4x4(b));
+  EXPECT_FLOAT3x4_EQ(mul_mat44, 8.f, 2.f, 3.f, 0.f, 16.f, 6.f, 11.f, 4.f, 24.f,
+                     10.f, 19.f, 8.f);
+
+  const SimdFloat4 transform_point44 = TransformPoint(ToFloat4x4(a), v);
+  EXPECT_SIMDFLOAT_EQ(transform_point44, -2.f, -6.f, -10.f, 1.f);
+
+  const ozz::math::Float3x4 add_mat = a + b;
+  EXPECT_FLOAT3x4_EQ(add_mat, 0.f, 2.f, 5.f, 5.f, 5.f, 7.f, 6.f, 10.f, 12.f,
+                     10.f, 12.f, 9.f);
+
+  const ozz::math::Float3x4 sub_mat = a - b;
+  EXPECT_FLOAT3x4_EQ(sub_mat, 2.f, 2.f, 1.f, 3.f, 5.f, 5.f, 8.f, 6.f, 6.f, 10.f,
+                     10.f, 15.f);
+
+  const ozz::math::Float3x4 row_multiply =
+      RowMultiply(a, ozz::math::simd_float4::Load(2.f, -1.f, 0.f, 1.f));
+  EXPECT_FLOAT3x4_EQ(row_multiply, 2.f, -2.f, 0.f, 4.f, 10.f, -6.f, 0.f, 8.f,
+                     18.f, -10.f, 0.f, 12.f);
+}
@@ -458,3 +458,46 @@ TEST(QuaternionTransformVector, ozz_simd_math) {
               ozz::math::simd_float4::Load1(2.f)),
       0, 2, 0);
 }
+
+TEST(DualQuaternion, ozz_simd_math) {
+  using ozz::math::SimdDualQuaternion;
+  const ozz::math::SimdFloat4 pi_2 =
+      ozz::math::simd_float4::LoadX(ozz::math::kPi_2);
+  const ozz::math::SimdFloat4 point =
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 1.f);
+  const ozz::math::SimdFloat4 translation =
+      ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 7.f);
+
+  // Identity
+  const SimdDualQuaternion identity = SimdDualQuaternion::identity();
+  EXPECT_SIMDQUATERNION_EQ(identity.real, 0.f, 0.f, 0.f, 1.f);
+  EXPECT_SIMDQUATERNION_EQ(identity.dual, 0.f, 0.f, 0.f, 0.f);
+  EXPECT_SIMDFLOAT3_EQ(TransformPoint(identity, point), 1.f, 2.f, 3.f);
+  EXPECT_SIMDFLOAT3_EQ(TransformVector(identity, point), 1.f, 2.f, 3.f);
+
+  // Translation only
+  const SimdDualQuaternion t =
+      SimdDualQuaternion::FromAffine(translation, SimdQuaternion::identity());
+  EXPECT_SIMDQUATERNION_EQ(t.real, 0.f, 0.f, 0.f, 1.f);
+  EXPECT_SIMDQUATERNION_EQ(t.dual, 2.f, 2.5f, 3.f, 0.f);
+  EXPECT_SIMDFLOAT3_EQ(TransformPoint(t, point), 5.f, 7.f, 9.f);
+  EXPECT_SIMDFLOAT3_EQ(TransformVector(t, point), 1.f, 2.f, 3.f);
+
+  // Rotation and translation
+  const SimdDualQuaternion rt = SimdDualQuaternion::FromAffine(
+      translation,
+      SimdQuaternion::FromAxisAngle(ozz::math::simd_float4::y_axis(), pi_2));
+  EXPECT_SIMDFLOAT3_EQ(TransformPoint(rt, point), 7.f, 7.f, 5.f);
+  EXPECT_SIMDFLOAT3_EQ(TransformVector(rt, point), 3.f, 2.f, -1.f);
+
+  // Non normalized
+  const SimdDualQuaternion scaled = rt + rt + rt;
+  EXPECT_SIMDFLOAT3_EQ(TransformPoint(scaled, point), 7.f, 7.f, 5.f);
+  EXPECT_SIMDFLOAT3_EQ(TransformVector(scaled, point), 3.f, 2.f, -1.f);
+
+  // Blending
+  const SimdDualQuaternion blend = t + SimdDualQuaternion::FromAffine(
+                                           -translation,
+                                           SimdQuaternion::identity());
+  EXPECT_SIMDFLOAT3_EQ(TransformPoint(blend, point), 1.f, 2.f, 3.f);
+}
@@ -303,4 +303,96 @@ TEST(SoaFloat4x4Affine, ozz_soa_math) {
       0.f, -.0707106f, 0.f, 0.f, 0.f, 0.f, 1.f, 3.f, 0.f, 0.f, 0.f, 0.f, 0.f,
       .0707106f, 0.f, 0.f, -1.f, .0707106f, 0.f, 0.f, 0.f, 0.f, 0.f, 46.f, 7.f,
       -12.f, 0.f, 12.f, 7.f, -46.f, 0.f, 0.f, 7.f, 46.f, 1.f, 1.f, 1.f, 1.f);
+
+  // Unit scale version.
+  const SoaFloat4x4 rigid = SoaFloat4x4::FromAffine(translation, quaternion);
+  EXPECT_SOAFLOAT4x4_EQ(
+      rigid, 0.f, 0.f, 1.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, -1.f, 0.f, 0.f, 0.f,
+      0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, -1.f, 1.f, 1.f, .70710677f, 0.f, 0.f,
+      0.f, -.70710677f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+      .70710677f, 0.f, 0.f, 1.f, .70710677f, 0.f, 0.f, 0.f, 0.f, 0.f, 46.f, 7.f,
+      -12.f, 0.f, 12.f, 7.f, -46.f, 0.f, 0.f, 7.f, 46.f, 1.f, 1.f, 1.f, 1.f);
+  const SoaFloat4x4 unit_scale =
+      SoaFloat4x4::FromAffine(translation, quaternion, SoaFloat3::one());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_SIMDINT_EQ(rigid.cols[i] == unit_scale.cols[i], 0xffffffff,
+                      0xffffffff, 0xffffffff, 0xffffffff);
+  }
+}
+
+TEST(SoaFloat4x4Decompose, ozz_soa_math) {
+  const SoaFloat3 translation =
+      SoaFloat3::Load(ozz::math::simd_float4::Load(0.f, 46.f, 7.f, -12.f),
+                      ozz::math::simd_float4::Load(0.f, 12.f, 7.f, -46.f),
+                      ozz::math::simd_float4::Load(0.f, 0.f, 7.f, 46.f));
+  const SoaFloat3 scale =
+      SoaFloat3::Load(ozz::math::simd_float4::Load(1.f, 1.f, -1.f, 0.1f),
+                      ozz::math::simd_float4::Load(1.f, 2.f, -1.f, 0.1f),
+                      ozz::math::simd_float4::Load(1.f, 3.f, -1.f, 0.1f));
+  const SoaQuaternion quaternion = SoaQuaternion::Load(
+      ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, -.382683432f),
+      ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, .70710677f, 1.f, .9238795f));
+  const SoaFloat4x4 matrix =
+      SoaFloat4x4::FromAffine(translation, quaternion, scale);
+
+  {  // Quaternion extraction.
+    const SoaFloat4x4 rotation = SoaFloat4x4::FromQuaternion(quaternion);
+    EXPECT_SOAQUATERNION_EQ_EST(ToQuaternion(rotation), .70710677f, 0.f, 0.f,
+                                -.382683432f, 0.f, .70710677f, 0.f, 0.f,
+                                .70710677f, 0.f, 0.f, 0.f, 0.f, .70710677f, 1.f,
+                                .9238795f);
+  }
+
+  {  // Affine decomposition.
+    SoaFloat3 d_translation;
+    SoaQuaternion d_quaternion;
+    SoaFloat3 d_scale;
+    EXPECT_SIMDINT_EQ(
+        ToAffine(matrix, &d_translation, &d_quaternion, &d_scale), 0xffffffff,
+        0xffffffff, 0xffffffff, 0xffffffff);
+    EXPECT_SOAFLOAT3_EQ(d_translation, 0.f, 46.f, 7.f, -12.f, 0.f, 12.f, 7.f,
+                        -46.f, 0.f, 0.f, 7.f, 46.f);
+
+    // Reflexion (3rd matrix) is decomposed to a negative y scale and a half
+    // turn around y axis.
+    EXPECT_SOAFLOAT3_EQ_EST(d_scale, 1.f, 1.f, 1.f, 0.1f, 1.f, 2.f, -1.f, 0.1f,
+                            1.f, 3.f, 1.f, 0.1f);
+    EXPECT_SOAQUATERNION_EQ_EST(d_quaternion, .70710677f, 0.f, 0.f,
+                                -.382683432f, 0.f, .70710677f, 1.f, 0.f,
+                                .70710677f, 0.f, 0.f, 0.f, 0.f, .70710677f, 0.f,
+                                .9238795f);
+
+    // Rebuilds the same matrices.
+    const SoaFloat4x4 rebuilt =
+        SoaFloat4x4::FromAffine(d_translation, d_quaternion, d_scale);
+    EXPECT_SOAFLOAT4x4_EQ(
+        rebuilt, 0.f, 0.f, -1.f, .1f, 0.f, 0.f, 0.f, 0.f, 1.f, -1.f, 0.f, 0.f,
+        0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, -1.f, 2.f, -1.f, .0707106f, 0.f,
+        0.f, 0.f, -.0707106f, 0.f, 0.f, 0.f, 0.f, 1.f, 3.f, 0.f, 0.f, 0.f, 0.f,
+        0.f, .0707106f, 0.f, 0.f, -1.f, .0707106f, 0.f, 0.f, 0.f, 0.f, 0.f,
+        46.f, 7.f, -12.f, 0.f, 12.f, 7.f, -46.f, 0.f, 0.f, 7.f, 46.f, 1.f, 1.f,
+        1.f, 1.f);
+  }
+
+  {  // Non decomposable matrices.
+    const SoaFloat3 null_scale =
+        SoaFloat3::Load(ozz::math::simd_float4::Load(0.f, 1.f, 1.f, 1.f),
+                        ozz::math::simd_float4::Load(1.f, 0.f, 1.f, 1.f),
+                        ozz::math::simd_float4::Load(1.f, 1.f, 0.f, 1.f));
+    const SoaFloat4x4 degenerated =
+        SoaFloat4x4::FromAffine(translation, quaternion, null_scale);
+    SoaFloat3 d_translation;
+    SoaQuaternion d_quaternion;
+    SoaFloat3 d_scale;
+    EXPECT_SIMDINT_EQ(
+        ToAffine(degenerated, &d_translation, &d_quaternion, &d_scale), 0, 0,
+        0, 0xffffffff);
+    EXPECT_SOAFLOAT3_EQ_EST(d_scale, 0.f, 1.f, 1.f, 1.f, 1.f, 0.f, 1.f, 1.f,
+                            1.f, 1.f, 0.f, 1.f);
+    EXPECT_SOAQUATERNION_EQ_EST(d_quaternion, 0.f, 0.f, 0.f, -.382683432f, 0.f,
+                                0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f,
+                                1.f, .9238795f);
+  }
 }
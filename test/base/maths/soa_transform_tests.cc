@@ -43,3 +43,16 @@ TEST(SoaTransformConstant, ozz_soa_math) {
   EXPECT_SOAFLOAT3_EQ(SoaTransform::identity().scale, 1.f, 1.f, 1.f, 1.f, 1.f,
                       1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f);
 }
+
+TEST(SoaTransformComparison, ozz_soa_math) {
+  const SoaTransform a = SoaTransform::identity();
+  SoaTransform b = a;
+  EXPECT_SIMDINT_EQ(a == b, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff);
+  EXPECT_SIMDINT_EQ(a != b, 0, 0, 0, 0);
+
+  b.translation.y = ozz::math::simd_float4::Load(0.f, 1.f, 0.f, 0.f);
+  b.rotation.w = ozz::math::simd_float4::Load(1.f, 1.f, -1.f, 1.f);
+  b.scale.x = ozz::math::simd_float4::Load(1.f, 1.f, 1.f, 2.f);
+  EXPECT_SIMDINT_EQ(a == b, 0xffffffff, 0, 0, 0);
+  EXPECT_SIMDINT_EQ(a != b, 0, 0xffffffff, 0xffffffff, 0xffffffff);
+}
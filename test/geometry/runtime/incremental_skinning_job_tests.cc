@@ -0,0 +1,398 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/incremental_skinning_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/box.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/maths/simd_math.h"
+
+using ozz::geometry::BuildSkinningIndex;
+using ozz::geometry::IncrementalSkinningJob;
+using ozz::geometry::SkinningIndex;
+using ozz::geometry::SkinningJob;
+using ozz::geometry::VertexRange;
+
+namespace {
+// Expects joint _joint ranges of _index to be _ranges.
+void ExpectJointRanges(const SkinningIndex& _index, int _joint,
+                       std::initializer_list<VertexRange> _ranges) {
+  ASSERT_EQ(_index.joints[_joint + 1] - _index.joints[_joint],
+            static_cast<int>(_ranges.size()));
+  const VertexRange* range = &_index.ranges[_index.joints[_joint]];
+  for (const VertexRange& expected_range : _ranges) {
+    EXPECT_EQ(range->begin, expected_range.begin);
+    EXPECT_EQ(range->end, expected_range.end);
+    ++range;
+  }
+}
+}  // namespace
+
+TEST(BuildSkinningIndex, IncrementalSkinningJob) {
+  const uint16_t joint_indices[10] = {0, 0, 1, 1, 0, 2, 2, 2, 0, 1};
+  SkinningIndex index;
+
+  // Invalid arguments.
+  EXPECT_FALSE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 1, 10, 3,
+                                  0, nullptr));
+  EXPECT_FALSE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 0, 10, 3,
+                                  0, &index));
+  EXPECT_FALSE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 1, 10, 3,
+                                  -1, &index));
+  EXPECT_FALSE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 2, 10, 3,
+                                  0, &index));
+  EXPECT_FALSE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 1, 11, 3,
+                                  0, &index));
+
+  // Joint index out of range.
+  EXPECT_FALSE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 1, 10, 2,
+                                  0, &index));
+  EXPECT_TRUE(index.joints.empty());
+  EXPECT_TRUE(index.ranges.empty());
+
+  // Empty mesh.
+  EXPECT_TRUE(BuildSkinningIndex(ozz::span<const uint16_t>(), 0, 1, 0, 3, 0,
+                                 &index));
+  EXPECT_EQ(index.vertex_count, 0);
+  ASSERT_EQ(index.joints.size(), 4u);
+  EXPECT_TRUE(index.ranges.empty());
+
+  // No gap, ranges are aligned to vertex pairs.
+  EXPECT_TRUE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 1, 10, 3,
+                                 0, &index));
+  EXPECT_EQ(index.vertex_count, 10);
+  ASSERT_EQ(index.joints.size(), 4u);
+  ExpectJointRanges(index, 0, {{0, 2}, {4, 6}, {8, 10}});
+  ExpectJointRanges(index, 1, {{2, 4}, {8, 10}});
+  ExpectJointRanges(index, 2, {{4, 8}});
+
+  // Gaps of 2 vertices are merged.
+  EXPECT_TRUE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 1, 10, 3,
+                                 2, &index));
+  ExpectJointRanges(index, 0, {{0, 10}});
+  ExpectJointRanges(index, 1, {{2, 4}, {8, 10}});
+  ExpectJointRanges(index, 2, {{4, 8}});
+
+  // Odd vertex count, last range ends with the mesh.
+  EXPECT_TRUE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 1, 9, 3, 0,
+                                 &index));
+  ExpectJointRanges(index, 0, {{0, 2}, {4, 6}, {8, 9}});
+  ExpectJointRanges(index, 1, {{2, 4}});
+  ExpectJointRanges(index, 2, {{4, 8}});
+
+  // Multiple influences with stride, more than 256 joints. Contiguous ranges
+  // are merged.
+  const uint16_t multi_indices[12] = {0, 300, 99, 1, 299, 99,
+                                      1, 300, 99, 0, 300, 99};
+  EXPECT_TRUE(BuildSkinningIndex(multi_indices, sizeof(uint16_t) * 3, 2, 4,
+                                 301, 0, &index));
+  ASSERT_EQ(index.joints.size(), 302u);
+  ExpectJointRanges(index, 0, {{0, 4}});
+  ExpectJointRanges(index, 1, {{0, 4}});
+  ExpectJointRanges(index, 99, {});
+  ExpectJointRanges(index, 299, {{0, 2}});
+  ExpectJointRanges(index, 300, {{0, 4}});
+}
+
+TEST(BuildCompactSkinningIndex, IncrementalSkinningJob) {
+  // 8 bits indices, 2 influences with a padding index.
+  const uint8_t compact_indices[15] = {0, 2, 9, 1, 2, 9, 0, 0, 9,
+                                       3, 1, 9, 3, 3, 9};
+  const uint16_t indices[15] = {0, 2, 9, 1, 2, 9, 0, 0, 9,
+                                3, 1, 9, 3, 3, 9};
+  SkinningIndex index;
+
+  // Invalid arguments.
+  EXPECT_FALSE(BuildSkinningIndex(compact_indices, sizeof(uint8_t) * 3, 2, 6,
+                                  4, 0, &index));
+  EXPECT_FALSE(BuildSkinningIndex(compact_indices, sizeof(uint8_t) * 3, 2, 5,
+                                  3, 0, &index));
+
+  // Matches 16 bits indices index.
+  SkinningIndex expected;
+  EXPECT_TRUE(BuildSkinningIndex(indices, sizeof(uint16_t) * 3, 2, 5, 4, 0,
+                                 &expected));
+  EXPECT_TRUE(BuildSkinningIndex(compact_indices, sizeof(uint8_t) * 3, 2, 5, 4,
+                                 0, &index));
+  EXPECT_EQ(index.vertex_count, 5);
+  ASSERT_EQ(index.joints, expected.joints);
+  ExpectJointRanges(index, 0, {{0, 4}});
+  ExpectJointRanges(index, 1, {{0, 4}});
+  ExpectJointRanges(index, 2, {{0, 2}});
+  ExpectJointRanges(index, 3, {{2, 5}});
+}
+
+TEST(Archive, IncrementalSkinningJob) {
+  const uint16_t joint_indices[10] = {0, 0, 1, 1, 0, 2, 2, 2, 0, 1};
+  SkinningIndex o_index;
+  ASSERT_TRUE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 1, 10, 3, 0,
+                                 &o_index));
+
+  for (int e = 0; e < 2; ++e) {
+    const ozz::Endianness endianess =
+        e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << o_index;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+    ASSERT_TRUE(i.TestTag<SkinningIndex>());
+
+    SkinningIndex i_index;
+    i >> i_index;
+
+    EXPECT_EQ(i_index.vertex_count, 10);
+    ASSERT_EQ(i_index.joints, o_index.joints);
+    ExpectJointRanges(i_index, 0, {{0, 2}, {4, 6}, {8, 10}});
+    ExpectJointRanges(i_index, 1, {{2, 4}, {8, 10}});
+    ExpectJointRanges(i_index, 2, {{4, 8}});
+  }
+}
+
+TEST(JobValidity, IncrementalSkinningJob) {
+  const ozz::math::Float4x4 matrices[2] = {ozz::math::Float4x4::identity(),
+                                           ozz::math::Float4x4::identity()};
+  const uint16_t joint_indices[2] = {0, 1};
+  const float in_positions[6] = {};
+  float out_positions[6];
+  SkinningIndex index;
+  ASSERT_TRUE(BuildSkinningIndex(joint_indices, sizeof(uint16_t), 1, 2, 2, 0,
+                                 &index));
+  const uint8_t changed[1] = {1};
+  VertexRange scratch[2];
+
+  IncrementalSkinningJob job;
+  EXPECT_FALSE(job.Validate());
+  EXPECT_FALSE(job.Run());
+
+  job.job.vertex_count = 2;
+  job.job.influences_count = 1;
+  job.job.joint_matrices = matrices;
+  job.job.joint_indices = joint_indices;
+  job.job.joint_indices_stride = sizeof(uint16_t);
+  job.job.in_positions = in_positions;
+  job.job.in_positions_stride = sizeof(float) * 3;
+  job.job.out_positions = out_positions;
+  job.job.out_positions_stride = sizeof(float) * 3;
+  EXPECT_FALSE(job.Validate());
+
+  job.index = &index;
+  job.changed = changed;
+  job.scratch = scratch;
+  EXPECT_TRUE(job.Validate());
+  EXPECT_TRUE(job.Run());
+
+  // Invalid skinning job.
+  job.job.influences_count = 0;
+  EXPECT_FALSE(job.Validate());
+  job.job.influences_count = 1;
+
+  // Index doesn't match vertex count.
+  job.job.vertex_count = 1;
+  EXPECT_FALSE(job.Validate());
+  job.job.vertex_count = 2;
+
+  // Invalid changed bits.
+  job.changed = {};
+  EXPECT_FALSE(job.Validate());
+  job.changed = changed;
+
+  // Scratch too small.
+  job.scratch = {scratch, 1};
+  EXPECT_FALSE(job.Validate());
+  job.scratch = scratch;
+
+  // Bounds aren't supported.
+  ozz::math::Box bounds;
+  job.job.out_bounds = &bounds;
+  EXPECT_FALSE(job.Validate());
+  job.job.out_bounds = nullptr;
+
+  // Empty index.
+  SkinningIndex empty;
+  job.index = &empty;
+  EXPECT_FALSE(job.Validate());
+  job.index = &index;
+
+  EXPECT_TRUE(job.Validate());
+}
+
+TEST(Run, IncrementalSkinningJob) {
+  const int kJoints = 12;
+  ozz::math::Float3x4 matrices[kJoints];
+  for (int i = 0; i < kJoints; ++i) {
+    matrices[i] = ozz::math::Float3x4::FromFloat4x4(
+        ozz::math::Float4x4::Translation(
+            ozz::math::simd_float4::Load(i * .5f, -1.f, i * .2f, 0.f)) *
+        ozz::math::Float4x4::FromEuler(
+            ozz::math::simd_float4::Load(i * .3f, i * -.7f, .1f, 0.f)));
+  }
+
+  // Mesh joints are mostly sorted by vertex, like a real mesh.
+  const int kVertices = 301;
+  const int kInfluences = 2;
+  ozz::vector<uint16_t> joint_indices(kVertices * kInfluences);
+  ozz::vector<float> joint_weights(kVertices);
+  ozz::vector<float> in_positions(kVertices * 3);
+  ozz::vector<float> in_normals(kVertices * 3);
+  for (int i = 0; i < kVertices; ++i) {
+    joint_indices[i * 2 + 0] = static_cast<uint16_t>(i * kJoints / kVertices);
+    joint_indices[i * 2 + 1] = static_cast<uint16_t>((i * 7) % 5 == 0 ? 11 : 0);
+    joint_weights[i] = .3f + (i % 5) * .1f;
+    for (int k = 0; k < 3; ++k) {
+      in_positions[i * 3 + k] = i * .01f + k;
+      in_normals[i * 3 + k] = (i % 11) * .1f - k * .3f;
+    }
+  }
+
+  SkinningJob skinning;
+  skinning.vertex_count = kVertices;
+  skinning.influences_count = kInfluences;
+  skinning.joint_affine_matrices = matrices;
+  skinning.joint_indices = make_span(joint_indices);
+  skinning.joint_indices_stride = sizeof(uint16_t) * kInfluences;
+  skinning.joint_weights = make_span(joint_weights);
+  skinning.joint_weights_stride = sizeof(float);
+  skinning.in_positions = make_span(in_positions);
+  skinning.in_positions_stride = sizeof(float) * 3;
+  skinning.in_normals = make_span(in_normals);
+  skinning.in_normals_stride = sizeof(float) * 3;
+  skinning.out_positions_stride = sizeof(float) * 3;
+  skinning.out_normals_stride = sizeof(float) * 3;
+
+  // Reference, all vertices are skinned.
+  ozz::vector<float> reference(kVertices * 6);
+  skinning.out_positions = {reference.data(), kVertices * 3u};
+  skinning.out_normals = {reference.data() + kVertices * 3, kVertices * 3u};
+  ASSERT_TRUE(skinning.Run());
+
+  for (int max_gap = 0; max_gap < 20; max_gap += 7) {
+    SkinningIndex index;
+    ASSERT_TRUE(BuildSkinningIndex(make_span(joint_indices),
+                                   sizeof(uint16_t) * kInfluences,
+                                   kInfluences, kVertices, kJoints, max_gap,
+                                   &index));
+    ozz::vector<VertexRange> scratch(index.ranges.size());
+
+    for (int joint = 0; joint < kJoints; ++joint) {
+      // Output is initialized to a value that skinning can't output.
+      ozz::vector<float> output(kVertices * 6, 1e20f);
+      IncrementalSkinningJob job;
+      job.job = skinning;
+      job.job.out_positions = {output.data(), kVertices * 3u};
+      job.job.out_normals = {output.data() + kVertices * 3, kVertices * 3u};
+      job.index = &index;
+      uint8_t changed[2] = {0, 0};
+      changed[joint / 8] = static_cast<uint8_t>(1 << (joint & 7));
+      job.changed = changed;
+      job.scratch = make_span(scratch);
+      int skinned = -1;
+      job.out_skinned_count = &skinned;
+      ASSERT_TRUE(job.Run());
+
+      // Vertices influenced by the changed joint are skinned exactly like the
+      // whole mesh, others are skinned only if they're in merged ranges.
+      int count = 0;
+      for (int i = 0; i < kVertices; ++i) {
+        const bool influenced = joint_indices[i * 2 + 0] == joint ||
+                                joint_indices[i * 2 + 1] == joint;
+        const bool skinned_vertex = output[i * 3] != 1e20f;
+        count += skinned_vertex;
+        if (influenced) {
+          EXPECT_TRUE(skinned_vertex);
+        }
+        if (max_gap == 0 && !influenced) {
+          // Vertices of the same pair are skinned together.
+          const int pair = i ^ 1;
+          const bool pair_influenced =
+              pair < kVertices && (joint_indices[pair * 2 + 0] == joint ||
+                                   joint_indices[pair * 2 + 1] == joint);
+          EXPECT_EQ(skinned_vertex, pair_influenced);
+        }
+        if (skinned_vertex) {
+          for (int k = 0; k < 3; ++k) {
+            EXPECT_EQ(output[i * 3 + k], reference[i * 3 + k]);
+            EXPECT_EQ(output[(kVertices + i) * 3 + k],
+                      reference[(kVertices + i) * 3 + k]);
+          }
+        } else {
+          for (int k = 0; k < 3; ++k) {
+            EXPECT_EQ(output[(kVertices + i) * 3 + k], 1e20f);
+          }
+        }
+      }
+      EXPECT_EQ(skinned, count);
+    }
+
+    // No changed joint, nothing is skinned.
+    {
+      ozz::vector<float> output(kVertices * 6, 1e20f);
+      IncrementalSkinningJob job;
+      job.job = skinning;
+      job.job.out_positions = {output.data(), kVertices * 3u};
+      job.job.out_normals = {output.data() + kVertices * 3, kVertices * 3u};
+      job.index = &index;
+      const uint8_t changed[2] = {0, 0};
+      job.changed = changed;
+      job.scratch = make_span(scratch);
+      int skinned = -1;
+      job.out_skinned_count = &skinned;
+      ASSERT_TRUE(job.Run());
+      EXPECT_EQ(skinned, 0);
+      for (float value : output) {
+        EXPECT_EQ(value, 1e20f);
+      }
+    }
+
+    // All joints changed, all vertices are skinned.
+    {
+      ozz::vector<float> output(kVertices * 6, 1e20f);
+      IncrementalSkinningJob job;
+      job.job = skinning;
+      job.job.out_positions = {output.data(), kVertices * 3u};
+      job.job.out_normals = {output.data() + kVertices * 3, kVertices * 3u};
+      job.index = &index;
+      const uint8_t changed[2] = {0xff, 0x0f};
+      job.changed = changed;
+      job.scratch = make_span(scratch);
+      int skinned = -1;
+      job.out_skinned_count = &skinned;
+      ASSERT_TRUE(job.Run());
+      EXPECT_EQ(skinned, kVertices);
+      for (size_t i = 0; i < output.size(); ++i) {
+        EXPECT_EQ(output[i], reference[i]);
+      }
+    }
+  }
+}
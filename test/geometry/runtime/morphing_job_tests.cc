@@ -0,0 +1,414 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/morphing_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/box.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+
+using ozz::geometry::BuildMorphTarget;
+using ozz::geometry::MorphingJob;
+using ozz::geometry::MorphTarget;
+using ozz::geometry::SkinningJob;
+
+TEST(BuildMorphTarget, MorphingJob) {
+  const float positions[12] = {0.f, 0.f,  0.f, 1.f, -2.f, 0.f,
+                               0.f, .01f, 0.f, 0.f, 0.f,  -.5f};
+  const float normals[12] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                             0.f, 0.f, 0.f, .5f, 0.f, 0.f};
+  MorphTarget target;
+
+  // Invalid arguments.
+  EXPECT_FALSE(BuildMorphTarget(positions, {}, 4, 0.f, nullptr));
+  EXPECT_FALSE(BuildMorphTarget(positions, {}, 5, 0.f, &target));
+  EXPECT_FALSE(BuildMorphTarget(positions, {normals, 9}, 4, 0.f, &target));
+  EXPECT_FALSE(BuildMorphTarget(positions, {}, -1, 0.f, &target));
+  EXPECT_FALSE(BuildMorphTarget(positions, {}, 4, -1.f, &target));
+
+  // Empty target.
+  EXPECT_TRUE(BuildMorphTarget({}, {}, 0, 0.f, &target));
+  EXPECT_TRUE(target.vertices.empty());
+  EXPECT_TRUE(target.position_deltas.empty());
+  EXPECT_TRUE(target.normal_deltas.empty());
+
+  // Positions only.
+  EXPECT_TRUE(BuildMorphTarget(positions, {}, 4, 0.f, &target));
+  ASSERT_EQ(target.vertices.size(), 3u);
+  EXPECT_EQ(target.vertices[0], 1);
+  EXPECT_EQ(target.vertices[1], 2);
+  EXPECT_EQ(target.vertices[2], 3);
+  ASSERT_EQ(target.position_deltas.size(), 9u);
+  EXPECT_TRUE(target.normal_deltas.empty());
+  EXPECT_FLOAT_EQ(target.position_scale, 2.f / 32767.f);
+  EXPECT_EQ(target.position_deltas[0], 16384);
+  EXPECT_EQ(target.position_deltas[1], -32767);
+  EXPECT_EQ(target.position_deltas[4], 164);
+  EXPECT_EQ(target.position_deltas[8], -8192);
+
+  // Threshold discards small deltas.
+  EXPECT_TRUE(BuildMorphTarget(positions, {}, 4, .1f, &target));
+  ASSERT_EQ(target.vertices.size(), 2u);
+  EXPECT_EQ(target.vertices[0], 1);
+  EXPECT_EQ(target.vertices[1], 3);
+  ASSERT_EQ(target.position_deltas.size(), 6u);
+  EXPECT_EQ(target.position_deltas[5], -8192);
+
+  // Normals.
+  EXPECT_TRUE(BuildMorphTarget(positions, normals, 4, .1f, &target));
+  ASSERT_EQ(target.vertices.size(), 2u);
+  ASSERT_EQ(target.normal_deltas.size(), 6u);
+  EXPECT_FLOAT_EQ(target.normal_scale, .5f / 32767.f);
+  EXPECT_EQ(target.normal_deltas[0], 0);
+  EXPECT_EQ(target.normal_deltas[3], 32767);
+
+  // A vertex with only normal deltas is kept.
+  const float zeros[12] = {};
+  EXPECT_TRUE(BuildMorphTarget(zeros, normals, 4, 0.f, &target));
+  ASSERT_EQ(target.vertices.size(), 1u);
+  EXPECT_EQ(target.vertices[0], 3);
+  EXPECT_EQ(target.position_scale, 0.f);
+  EXPECT_EQ(target.position_deltas[0], 0);
+}
+
+TEST(JobValidity, MorphingJob) {
+  const float in_positions[6] = {};
+  const float in_normals[6] = {};
+  float out_positions[6];
+  float out_normals[6];
+  const float deltas[6] = {1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+  MorphTarget targets[1];
+  ASSERT_TRUE(BuildMorphTarget(deltas, deltas, 2, 0.f, &targets[0]));
+  const float weights[1] = {1.f};
+
+  MorphingJob job;
+  EXPECT_TRUE(job.Validate());  // Empty job.
+  EXPECT_TRUE(job.Run());
+
+  job.vertex_count = 2;
+  EXPECT_FALSE(job.Validate());
+
+  job.in_positions = in_positions;
+  job.in_positions_stride = sizeof(float) * 3;
+  job.out_positions = out_positions;
+  job.out_positions_stride = sizeof(float) * 3;
+  EXPECT_TRUE(job.Validate());
+  EXPECT_TRUE(job.Run());
+
+  // Targets requires weights.
+  job.targets = targets;
+  EXPECT_FALSE(job.Validate());
+  job.weights = weights;
+  EXPECT_TRUE(job.Validate());
+
+  // Target vertex out of range.
+  job.vertex_count = 1;
+  EXPECT_FALSE(job.Validate());
+  job.vertex_count = 2;
+
+  // Inconsistent target deltas.
+  targets[0].normal_deltas.pop_back();
+  EXPECT_FALSE(job.Validate());
+  targets[0].normal_deltas.push_back(0);
+  targets[0].position_deltas.pop_back();
+  EXPECT_FALSE(job.Validate());
+  targets[0].position_deltas.push_back(0);
+  EXPECT_TRUE(job.Validate());
+
+  // Invalid strides.
+  job.out_positions_stride = sizeof(float) * 4;
+  EXPECT_FALSE(job.Validate());
+  job.out_positions_stride = sizeof(float) * 3;
+  job.in_positions_stride = sizeof(float) * 4;
+  EXPECT_FALSE(job.Validate());
+  job.in_positions_stride = sizeof(float) * 3;
+
+  // Normals requires output.
+  job.in_normals = in_normals;
+  job.in_normals_stride = sizeof(float) * 3;
+  EXPECT_FALSE(job.Validate());
+  job.out_normals = out_normals;
+  job.out_normals_stride = sizeof(float) * 3;
+  EXPECT_TRUE(job.Validate());
+  EXPECT_TRUE(job.Run());
+
+  // Fused skinning.
+  const ozz::math::Float4x4 matrices[1] = {ozz::math::Float4x4::identity()};
+  const uint16_t joint_indices[2] = {0, 0};
+  float skinned_positions[6];
+  float skinned_normals[6];
+  SkinningJob skinning;
+  skinning.vertex_count = 2;
+  skinning.influences_count = 1;
+  skinning.joint_matrices = matrices;
+  skinning.joint_indices = joint_indices;
+  skinning.joint_indices_stride = sizeof(uint16_t);
+  skinning.in_positions = in_positions;
+  skinning.in_positions_stride = sizeof(float) * 3;
+  skinning.out_positions = skinned_positions;
+  skinning.out_positions_stride = sizeof(float) * 3;
+  job.skinning = &skinning;
+  EXPECT_FALSE(job.Validate());  // Morphing outputs must be empty.
+  job.out_positions = {};
+  job.out_normals = {};
+  EXPECT_FALSE(job.Validate());  // Skinning requires normals.
+  skinning.in_normals = in_normals;
+  skinning.in_normals_stride = sizeof(float) * 3;
+  skinning.out_normals = skinned_normals;
+  skinning.out_normals_stride = sizeof(float) * 3;
+  EXPECT_TRUE(job.Validate());
+  EXPECT_TRUE(job.Run());
+
+  // Invalid skinning job.
+  skinning.vertex_count = 1;
+  EXPECT_FALSE(job.Validate());
+  skinning.vertex_count = 2;
+  skinning.influences_count = 0;
+  EXPECT_FALSE(job.Validate());
+  skinning.influences_count = 1;
+  EXPECT_TRUE(job.Validate());
+}
+
+namespace {
+// Builds _count morph targets of a mesh of _vertices vertices, moving
+// different and overlapping subsets of vertices.
+void BuildTargets(int _vertices, int _count,
+                  ozz::vector<MorphTarget>* _targets) {
+  _targets->resize(_count);
+  for (int i = 0; i < _count; ++i) {
+    ozz::vector<float> positions(_vertices * 3, 0.f);
+    ozz::vector<float> normals(_vertices * 3, 0.f);
+    for (int j = 0; j < _vertices; ++j) {
+      if ((j + i) % (i + 2) == 0 || (j > 50 * i && j < 50 * i + 40)) {
+        for (int k = 0; k < 3; ++k) {
+          positions[j * 3 + k] = ((j * 7 + k * 3 + i) % 13) * .1f - .6f;
+          normals[j * 3 + k] = ((j * 5 + k + i) % 7) * .05f - .15f;
+        }
+      }
+    }
+    ASSERT_TRUE(BuildMorphTarget(make_span(positions),
+                                 i == 1 ? ozz::span<const float>()
+                                        : make_span(normals),
+                                 _vertices, 0.f, &_targets->at(i)));
+  }
+}
+}  // namespace
+
+TEST(Run, MorphingJob) {
+  const int kVertices = 251;
+  ozz::vector<MorphTarget> targets;
+  BuildTargets(kVertices, 4, &targets);
+  const float weights[4] = {.5f, 1.f, 0.f, -1.2f};
+
+  // Interleaved input vertices, with a padding float.
+  ozz::vector<float> in(kVertices * 7);
+  for (int i = 0; i < kVertices * 7; ++i) {
+    in[i] = (i % 17) * .3f - 2.f;
+  }
+
+  // Computes expected results.
+  ozz::vector<float> reference(in);
+  for (size_t t = 0; t < targets.size(); ++t) {
+    const MorphTarget& target = targets[t];
+    for (size_t i = 0; i < target.vertices.size(); ++i) {
+      const int vertex = target.vertices[i];
+      for (int k = 0; k < 3; ++k) {
+        reference[vertex * 7 + k] +=
+            target.position_deltas[i * 3 + k] * target.position_scale *
+            weights[t];
+        if (!target.normal_deltas.empty()) {
+          reference[vertex * 7 + 3 + k] +=
+              target.normal_deltas[i * 3 + k] * target.normal_scale *
+              weights[t];
+        }
+      }
+    }
+  }
+
+  for (int in_place = 0; in_place < 2; ++in_place) {
+    ozz::vector<float> out(kVertices * 7, 0.f);
+    if (in_place) {
+      out = in;
+    }
+    MorphingJob job;
+    job.vertex_count = kVertices;
+    job.targets = make_span(targets);
+    job.weights = weights;
+    job.in_positions = {in_place ? out.data() : in.data(), in.size()};
+    job.in_positions_stride = sizeof(float) * 7;
+    job.in_normals = {(in_place ? out.data() : in.data()) + 3, in.size() - 3};
+    job.in_normals_stride = sizeof(float) * 7;
+    job.out_positions = {out.data(), out.size()};
+    job.out_positions_stride = sizeof(float) * 7;
+    job.out_normals = {out.data() + 3, out.size() - 3};
+    job.out_normals_stride = sizeof(float) * 7;
+    ASSERT_TRUE(job.Run());
+
+    for (int i = 0; i < kVertices; ++i) {
+      for (int k = 0; k < 6; ++k) {
+        EXPECT_NEAR(out[i * 7 + k], reference[i * 7 + k], 1e-5f);
+      }
+      // Padding isn't written.
+      EXPECT_EQ(out[i * 7 + 6], in_place ? in[i * 7 + 6] : 0.f);
+    }
+
+    // Without normals.
+    job.in_normals = {};
+    job.out_normals = {};
+    ASSERT_TRUE(job.Run());
+  }
+
+  // All weights are zero, input is copied.
+  {
+    const float zeros[4] = {};
+    ozz::vector<float> out(kVertices * 3);
+    MorphingJob job;
+    job.vertex_count = kVertices;
+    job.targets = make_span(targets);
+    job.weights = zeros;
+    job.in_positions = make_span(in);
+    job.in_positions_stride = sizeof(float) * 7;
+    job.out_positions = make_span(out);
+    job.out_positions_stride = sizeof(float) * 3;
+    ASSERT_TRUE(job.Run());
+    for (int i = 0; i < kVertices; ++i) {
+      for (int k = 0; k < 3; ++k) {
+        EXPECT_EQ(out[i * 3 + k], in[i * 7 + k]);
+      }
+    }
+  }
+}
+
+TEST(Fused, MorphingJob) {
+  const int kJoints = 4;
+  ozz::math::Float3x4 matrices[kJoints];
+  for (int i = 0; i < kJoints; ++i) {
+    matrices[i] = ozz::math::Float3x4::FromFloat4x4(
+        ozz::math::Float4x4::Translation(
+            ozz::math::simd_float4::Load(i * .5f, -1.f, i * .2f, 0.f)) *
+        ozz::math::Float4x4::FromEuler(
+            ozz::math::simd_float4::Load(i * .3f, i * -.7f, .1f, 0.f)));
+  }
+
+  const int kVertices = 251;
+  ozz::vector<MorphTarget> targets;
+  BuildTargets(kVertices, 3, &targets);
+  const float weights[3] = {.7f, 0.f, .4f};
+
+  ozz::vector<uint16_t> joint_indices(kVertices * 2);
+  ozz::vector<float> joint_weights(kVertices);
+  ozz::vector<float> in_positions(kVertices * 3);
+  ozz::vector<float> in_normals(kVertices * 3);
+  ozz::vector<float> in_tangents(kVertices * 3);
+  for (int i = 0; i < kVertices; ++i) {
+    joint_indices[i * 2 + 0] = static_cast<uint16_t>(i % kJoints);
+    joint_indices[i * 2 + 1] = static_cast<uint16_t>((i * 3 + 1) % kJoints);
+    joint_weights[i] = .2f + (i % 7) * .1f;
+    for (int k = 0; k < 3; ++k) {
+      in_positions[i * 3 + k] = i * .01f + k;
+      in_normals[i * 3 + k] = (i % 11) * .1f - k * .3f;
+      in_tangents[i * 3 + k] = k * .2f - (i % 5) * .1f;
+    }
+  }
+
+  SkinningJob skinning;
+  skinning.vertex_count = kVertices;
+  skinning.influences_count = 2;
+  skinning.joint_affine_matrices = matrices;
+  skinning.joint_indices = make_span(joint_indices);
+  skinning.joint_indices_stride = sizeof(uint16_t) * 2;
+  skinning.joint_weights = make_span(joint_weights);
+  skinning.joint_weights_stride = sizeof(float);
+  skinning.in_normals_stride = sizeof(float) * 3;
+  skinning.in_positions_stride = sizeof(float) * 3;
+  skinning.in_tangents = make_span(in_tangents);
+  skinning.in_tangents_stride = sizeof(float) * 3;
+  skinning.out_positions_stride = sizeof(float) * 3;
+  skinning.out_normals_stride = sizeof(float) * 3;
+  skinning.out_tangents_stride = sizeof(float) * 3;
+
+  // Expected results, morphing then skinning.
+  ozz::vector<float> morphed(kVertices * 6);
+  MorphingJob morphing;
+  morphing.vertex_count = kVertices;
+  morphing.targets = make_span(targets);
+  morphing.weights = weights;
+  morphing.in_positions = make_span(in_positions);
+  morphing.in_positions_stride = sizeof(float) * 3;
+  morphing.in_normals = make_span(in_normals);
+  morphing.in_normals_stride = sizeof(float) * 3;
+  morphing.out_positions = {morphed.data(), kVertices * 3u};
+  morphing.out_positions_stride = sizeof(float) * 3;
+  morphing.out_normals = {morphed.data() + kVertices * 3, kVertices * 3u};
+  morphing.out_normals_stride = sizeof(float) * 3;
+  ASSERT_TRUE(morphing.Run());
+
+  ozz::vector<float> reference(kVertices * 9);
+  ozz::math::Box reference_bounds;
+  {
+    SkinningJob job = skinning;
+    job.in_positions = {morphed.data(), kVertices * 3u};
+    job.in_normals = {morphed.data() + kVertices * 3, kVertices * 3u};
+    job.out_positions = {reference.data(), kVertices * 3u};
+    job.out_normals = {reference.data() + kVertices * 3, kVertices * 3u};
+    job.out_tangents = {reference.data() + kVertices * 6, kVertices * 3u};
+    job.out_bounds = &reference_bounds;
+    ASSERT_TRUE(job.Run());
+  }
+
+  // Fused morphing and skinning.
+  ozz::vector<float> output(kVertices * 9);
+  ozz::math::Box bounds;
+  skinning.in_positions = make_span(in_positions);
+  skinning.in_normals = make_span(in_normals);
+  skinning.out_positions = {output.data(), kVertices * 3u};
+  skinning.out_normals = {output.data() + kVertices * 3, kVertices * 3u};
+  skinning.out_tangents = {output.data() + kVertices * 6, kVertices * 3u};
+  skinning.out_bounds = &bounds;
+  morphing.out_positions = {};
+  morphing.out_normals = {};
+  morphing.skinning = &skinning;
+  ASSERT_TRUE(morphing.Run());
+
+  for (size_t i = 0; i < output.size(); ++i) {
+    EXPECT_EQ(output[i], reference[i]);
+  }
+  EXPECT_FLOAT3_EQ(bounds.min, reference_bounds.min.x, reference_bounds.min.y,
+                   reference_bounds.min.z);
+  EXPECT_FLOAT3_EQ(bounds.max, reference_bounds.max.x, reference_bounds.max.y,
+                   reference_bounds.max.z);
+
+  // Positions only, skinning normals aren't morphed.
+  morphing.in_normals = {};
+  ASSERT_TRUE(morphing.Run());
+  for (int i = 0; i < kVertices * 3; ++i) {
+    EXPECT_EQ(output[i], reference[i]);
+  }
+}
@@ -0,0 +1,237 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/parallel_skinning_job.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/box.h"
+#include "ozz/base/maths/simd_math.h"
+
+using ozz::geometry::ParallelSkinningJob;
+using ozz::geometry::SkinningJob;
+
+namespace {
+// Runs tasks in reverse order, to check that chunks are independent.
+void ReverseFor(ParallelSkinningJob::TaskFn _task, const void* _context,
+                int _count, void* _user_data) {
+  ++*static_cast<int*>(_user_data);
+  for (int i = _count - 1; i >= 0; --i) {
+    _task(_context, i);
+  }
+}
+
+// Runs tasks concurrently on 4 threads.
+void ThreadFor(ParallelSkinningJob::TaskFn _task, const void* _context,
+               int _count, void* _user_data) {
+  ++*static_cast<int*>(_user_data);
+  std::atomic_int next(0);
+  std::thread threads[4];
+  for (std::thread& thread : threads) {
+    thread = std::thread([&]() {
+      for (int i = next++; i < _count; i = next++) {
+        _task(_context, i);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+struct Vertex {
+  uint16_t indices[4];
+  float weights[3];
+  float positions[3];
+  float normals[3];
+  float tangents[3];
+};
+}  // namespace
+
+TEST(JobValidity, ParallelSkinningJob) {
+  const ozz::math::Float4x4 matrices[1] = {ozz::math::Float4x4::identity()};
+  const uint16_t joint_indices[2] = {0, 0};
+  const float in_positions[6] = {};
+  float out_positions[6];
+
+  ParallelSkinningJob job;
+  EXPECT_FALSE(job.Validate());
+  EXPECT_FALSE(job.Run());
+  EXPECT_EQ(job.num_chunks(), 0);
+
+  job.job.vertex_count = 2;
+  job.job.influences_count = 1;
+  job.job.joint_matrices = matrices;
+  job.job.joint_indices = joint_indices;
+  job.job.joint_indices_stride = sizeof(uint16_t);
+  job.job.in_positions = in_positions;
+  job.job.in_positions_stride = sizeof(float) * 3;
+  job.job.out_positions = out_positions;
+  job.job.out_positions_stride = sizeof(float) * 3;
+  EXPECT_TRUE(job.Validate());
+  EXPECT_TRUE(job.Run());
+  EXPECT_EQ(job.num_chunks(), 1);
+
+  // Invalid chunk size.
+  job.chunk_size = 0;
+  EXPECT_FALSE(job.Validate());
+  EXPECT_FALSE(job.Run());
+  job.chunk_size = -1;
+  EXPECT_FALSE(job.Validate());
+
+  // Chunk size is rounded up to an even number.
+  job.chunk_size = 1;
+  EXPECT_TRUE(job.Validate());
+  EXPECT_EQ(job.num_chunks(), 1);
+
+  // Bounds requires chunk bounds.
+  ozz::math::Box bounds;
+  ozz::math::Box chunk_bounds[1];
+  job.job.out_bounds = &bounds;
+  EXPECT_FALSE(job.Validate());
+  job.chunk_bounds = chunk_bounds;
+  EXPECT_TRUE(job.Validate());
+  EXPECT_TRUE(job.Run());
+  EXPECT_TRUE(bounds.is_valid());
+
+  // Empty job.
+  job.job.vertex_count = 0;
+  EXPECT_TRUE(job.Validate());
+  EXPECT_TRUE(job.Run());
+  EXPECT_EQ(job.num_chunks(), 0);
+}
+
+TEST(Run, ParallelSkinningJob) {
+  const int kJoints = 5;
+  ozz::math::Float4x4 matrices[kJoints];
+  ozz::math::Float3x4 affine_matrices[kJoints];
+  for (int i = 0; i < kJoints; ++i) {
+    matrices[i] = ozz::math::Float4x4::Translation(ozz::math::simd_float4::Load(
+                      i * .5f, -1.f, i * .2f, 0.f)) *
+                  ozz::math::Float4x4::FromEuler(ozz::math::simd_float4::Load(
+                      i * .3f, i * -.7f, .1f, 0.f)) *
+                  ozz::math::Float4x4::Scaling(ozz::math::simd_float4::Load(
+                      1.f, 1.f + i * .1f, 1.f - i * .05f, 0.f));
+    affine_matrices[i] = ozz::math::Float3x4::FromFloat4x4(matrices[i]);
+  }
+
+  // Odd vertex count, so the last chunk is odd.
+  const int kVertices = 1001;
+  ozz::vector<Vertex> vertices(kVertices);
+  for (int i = 0; i < kVertices; ++i) {
+    Vertex& v = vertices[i];
+    for (int j = 0; j < 4; ++j) {
+      v.indices[j] = static_cast<uint16_t>((i * 7 + j * 3) % kJoints);
+    }
+    v.weights[0] = .1f + (i % 7) * .05f;
+    v.weights[1] = .2f - (i % 3) * .05f;
+    v.weights[2] = .15f;
+    for (int k = 0; k < 3; ++k) {
+      v.positions[k] = i * .01f + k;
+      v.normals[k] = (i % 11) * .1f - k * .3f;
+      v.tangents[k] = k * .2f - (i % 5) * .1f;
+    }
+  }
+
+  for (int affine = 0; affine < 2; ++affine) {
+    for (int influences = 1; influences <= 4; ++influences) {
+      ozz::vector<float> expected(kVertices * 9);
+      SkinningJob job;
+      job.vertex_count = kVertices;
+      job.influences_count = influences;
+      if (affine) {
+        job.joint_affine_matrices = affine_matrices;
+      } else {
+        job.joint_matrices = matrices;
+      }
+      job.joint_indices = {vertices[0].indices,
+                           vertices[kVertices - 1].indices + influences};
+      job.joint_indices_stride = sizeof(Vertex);
+      job.joint_weights = {vertices[0].weights,
+                           vertices[kVertices - 1].weights + 3};
+      job.joint_weights_stride = sizeof(Vertex);
+      job.in_positions = {vertices[0].positions,
+                          vertices[kVertices - 1].positions + 3};
+      job.in_positions_stride = sizeof(Vertex);
+      job.in_normals = {vertices[0].normals,
+                        vertices[kVertices - 1].normals + 3};
+      job.in_normals_stride = sizeof(Vertex);
+      job.in_tangents = {vertices[0].tangents,
+                         vertices[kVertices - 1].tangents + 3};
+      job.in_tangents_stride = sizeof(Vertex);
+      job.out_positions = {expected.data(), expected.data() + kVertices * 3};
+      job.out_positions_stride = sizeof(float) * 3;
+      job.out_normals = {expected.data() + kVertices * 3,
+                         expected.data() + kVertices * 6};
+      job.out_normals_stride = sizeof(float) * 3;
+      job.out_tangents = {expected.data() + kVertices * 6,
+                          expected.data() + kVertices * 9};
+      job.out_tangents_stride = sizeof(float) * 3;
+      ozz::math::Box expected_bounds;
+      job.out_bounds = &expected_bounds;
+      ASSERT_TRUE(job.Run());
+
+      const int chunk_sizes[] = {1, 2, 63, 64, 1000, 4096};
+      const ParallelSkinningJob::ParallelForFn parallel_fors[] = {
+          nullptr, &ReverseFor, &ThreadFor};
+      for (int chunk_size : chunk_sizes) {
+        for (ParallelSkinningJob::ParallelForFn parallel_for : parallel_fors) {
+          ozz::vector<float> out(kVertices * 9, -1.f);
+          int calls = 0;
+          ozz::math::Box bounds;
+          ParallelSkinningJob parallel;
+          parallel.job = job;
+          parallel.job.out_positions = {out.data(), out.data() + kVertices * 3};
+          parallel.job.out_normals = {out.data() + kVertices * 3,
+                                      out.data() + kVertices * 6};
+          parallel.job.out_tangents = {out.data() + kVertices * 6,
+                                       out.data() + kVertices * 9};
+          parallel.chunk_size = chunk_size;
+          parallel.parallel_for = parallel_for;
+          parallel.user_data = &calls;
+          parallel.job.out_bounds = &bounds;
+          ozz::vector<ozz::math::Box> chunk_bounds(parallel.num_chunks());
+          parallel.chunk_bounds = make_span(chunk_bounds);
+          ASSERT_TRUE(parallel.Run());
+          EXPECT_EQ(calls, parallel_for && parallel.num_chunks() > 1);
+
+          // Results are bitwise identical.
+          EXPECT_EQ(std::memcmp(out.data(), expected.data(),
+                                sizeof(float) * out.size()),
+                    0)
+              << "affine " << affine << ", influences " << influences
+              << ", chunk size " << chunk_size;
+          EXPECT_EQ(std::memcmp(&bounds, &expected_bounds, sizeof(bounds)), 0);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,220 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/skinning_influences.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+
+using ozz::geometry::BuildLODWeights;
+using ozz::geometry::Influence;
+using ozz::geometry::SkinningJob;
+using ozz::geometry::SortInfluences;
+
+namespace {
+// Expects position _p to be (_x, _y, _z).
+void ExpectLODPosition(const float* _p, float _x, float _y, float _z) {
+  EXPECT_NEAR(_p[0], _x, 1e-5f);
+  EXPECT_NEAR(_p[1], _y, 1e-5f);
+  EXPECT_NEAR(_p[2], _z, 1e-5f);
+}
+}  // namespace
+
+TEST(SortInfluences, SkinningInfluences) {
+  // 3 vertices, 4 influences, interleaved with a padding index and weight.
+  uint16_t indices[15] = {0, 1, 2, 3, 99, 4, 5, 6, 7, 99, 8, 9, 10, 11, 99};
+  float weights[12] = {.1f, .2f, .3f, 99.f, .5f, .4f, .1f, 99.f,
+                       .25f, .25f, .25f, 99.f};
+
+  // Invalid arguments.
+  EXPECT_FALSE(SortInfluences(indices, sizeof(uint16_t) * 5, weights,
+                              sizeof(float) * 4, 0, 3));
+  EXPECT_FALSE(SortInfluences(indices, sizeof(uint16_t) * 5, weights,
+                              sizeof(float) * 4, 4, -1));
+  EXPECT_FALSE(SortInfluences(indices, sizeof(uint16_t) * 5, weights,
+                              sizeof(float) * 4, 4, 4));
+  EXPECT_FALSE(SortInfluences({indices, 13}, sizeof(uint16_t) * 5, weights,
+                              sizeof(float) * 4, 4, 3));
+  EXPECT_FALSE(SortInfluences(indices, sizeof(uint16_t) * 5, {weights, 10},
+                              sizeof(float) * 4, 4, 3));
+
+  // Single influence, nothing to sort.
+  EXPECT_TRUE(SortInfluences(indices, sizeof(uint16_t) * 5, {}, 0, 1, 3));
+  EXPECT_EQ(indices[0], 0);
+
+  EXPECT_TRUE(SortInfluences(indices, sizeof(uint16_t) * 5, weights,
+                             sizeof(float) * 4, 4, 3));
+
+  // Last weight (.4f) is restored to be sorted.
+  EXPECT_EQ(indices[0], 3);
+  EXPECT_EQ(indices[1], 2);
+  EXPECT_EQ(indices[2], 1);
+  EXPECT_EQ(indices[3], 0);
+  EXPECT_FLOAT_EQ(weights[0], .4f);
+  EXPECT_FLOAT_EQ(weights[1], .3f);
+  EXPECT_FLOAT_EQ(weights[2], .2f);
+
+  // Last weight is 0.
+  EXPECT_EQ(indices[5], 4);
+  EXPECT_EQ(indices[6], 5);
+  EXPECT_EQ(indices[7], 6);
+  EXPECT_EQ(indices[8], 7);
+  EXPECT_FLOAT_EQ(weights[4], .5f);
+  EXPECT_FLOAT_EQ(weights[5], .4f);
+  EXPECT_FLOAT_EQ(weights[6], .1f);
+
+  // Equal weights keep their order.
+  EXPECT_EQ(indices[10], 8);
+  EXPECT_EQ(indices[11], 9);
+  EXPECT_EQ(indices[12], 10);
+  EXPECT_EQ(indices[13], 11);
+
+  // Padding is untouched.
+  EXPECT_EQ(indices[4], 99);
+  EXPECT_EQ(indices[9], 99);
+  EXPECT_EQ(indices[14], 99);
+  EXPECT_EQ(weights[3], 99.f);
+  EXPECT_EQ(weights[7], 99.f);
+  EXPECT_EQ(weights[11], 99.f);
+}
+
+TEST(SortVertexInfluences, SkinningInfluences) {
+  // Empty span.
+  SortInfluences(ozz::span<Influence>());
+
+  Influence influences[5] = {{0, .1f}, {1, .3f}, {2, .1f}, {3, .5f}, {4, .0f}};
+  SortInfluences(influences);
+
+  // Equal weights keep their order.
+  EXPECT_EQ(influences[0].joint, 3);
+  EXPECT_EQ(influences[1].joint, 1);
+  EXPECT_EQ(influences[2].joint, 0);
+  EXPECT_EQ(influences[3].joint, 2);
+  EXPECT_EQ(influences[4].joint, 4);
+  EXPECT_FLOAT_EQ(influences[0].weight, .5f);
+  EXPECT_FLOAT_EQ(influences[4].weight, 0.f);
+}
+
+TEST(BuildLODWeights, SkinningInfluences) {
+  // 2 vertices, 4 sorted influences.
+  const float weights[6] = {.4f, .3f, .2f, 0.f, 0.f, 0.f};
+  float lod_weights[6];
+
+  // Invalid arguments.
+  EXPECT_FALSE(BuildLODWeights(weights, sizeof(float) * 3, 4, 1, 2,
+                               lod_weights));
+  EXPECT_FALSE(BuildLODWeights(weights, sizeof(float) * 3, 4, 5, 2,
+                               lod_weights));
+  EXPECT_FALSE(BuildLODWeights(weights, sizeof(float) * 3, 4, 3, -1,
+                               lod_weights));
+  EXPECT_FALSE(BuildLODWeights({weights, 5}, sizeof(float) * 3, 4, 3, 2,
+                               lod_weights));
+  EXPECT_FALSE(BuildLODWeights(weights, sizeof(float) * 3, 4, 3, 2,
+                               {lod_weights, 3}));
+
+  // 2 influences.
+  EXPECT_TRUE(BuildLODWeights(weights, sizeof(float) * 3, 4, 2, 2,
+                              lod_weights));
+  EXPECT_FLOAT_EQ(lod_weights[0], .4f / .7f);
+  EXPECT_FLOAT_EQ(lod_weights[1], .5f);  // All kept weights are 0.
+
+  // 3 influences.
+  EXPECT_TRUE(BuildLODWeights(weights, sizeof(float) * 3, 4, 3, 2,
+                              lod_weights));
+  EXPECT_FLOAT_EQ(lod_weights[0], .4f / .9f);
+  EXPECT_FLOAT_EQ(lod_weights[1], .3f / .9f);
+  EXPECT_FLOAT_EQ(lod_weights[2], 1.f / 3.f);
+  EXPECT_FLOAT_EQ(lod_weights[3], 1.f / 3.f);
+
+  // All influences, weights are unchanged.
+  EXPECT_TRUE(BuildLODWeights(weights, sizeof(float) * 3, 4, 4, 2,
+                              lod_weights));
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_FLOAT_EQ(lod_weights[i], weights[i]);
+  }
+}
+
+TEST(LODSkinning, SkinningInfluences) {
+  const ozz::math::Float4x4 matrices[4] = {
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(1.f, 0.f, 0.f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(0.f, 2.f, 0.f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(0.f, 0.f, 4.f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(8.f, 0.f, 0.f, 0.f))};
+
+  // Unsorted influences.
+  uint16_t indices[8] = {0, 1, 2, 3, 3, 2, 1, 0};
+  float weights[6] = {.1f, .2f, .3f, .1f, .5f, .3f};
+  ASSERT_TRUE(SortInfluences(indices, sizeof(uint16_t) * 4, weights,
+                             sizeof(float) * 3, 4, 2));
+  const float in_positions[6] = {};
+  float out_positions[6];
+
+  SkinningJob job;
+  job.vertex_count = 2;
+  job.joint_matrices = matrices;
+  job.joint_indices = indices;
+  job.joint_indices_stride = sizeof(uint16_t) * 4;
+  job.joint_weights = weights;
+  job.joint_weights_stride = sizeof(float) * 3;
+  job.in_positions = in_positions;
+  job.in_positions_stride = sizeof(float) * 3;
+  job.out_positions = out_positions;
+  job.out_positions_stride = sizeof(float) * 3;
+
+  // All influences.
+  job.influences_count = 4;
+  ASSERT_TRUE(job.Run());
+  ExpectLODPosition(out_positions, .1f + .4f * 8.f, .2f * 2.f, .3f * 4.f);
+  ExpectLODPosition(out_positions + 3, .1f + .1f * 8.f, .3f * 2.f, .5f * 4.f);
+
+  // Most influencing joint only.
+  job.influences_count = 1;
+  ASSERT_TRUE(job.Run());
+  ExpectLODPosition(out_positions, 8.f, 0.f, 0.f);
+  ExpectLODPosition(out_positions + 3, 0.f, 0.f, 4.f);
+
+  // 2 influences, dropped weights go to the second one.
+  job.influences_count = 2;
+  ASSERT_TRUE(job.Run());
+  ExpectLODPosition(out_positions, .4f * 8.f, 0.f, .6f * 4.f);
+  ExpectLODPosition(out_positions + 3, 0.f, .5f * 2.f, .5f * 4.f);
+
+  // 2 influences, renormalized weights.
+  float lod_weights[2];
+  ASSERT_TRUE(BuildLODWeights(weights, sizeof(float) * 3, 4, 2, 2,
+                              lod_weights));
+  job.joint_weights = lod_weights;
+  job.joint_weights_stride = sizeof(float);
+  ASSERT_TRUE(job.Run());
+  ExpectLODPosition(out_positions, 4.f / 7.f * 8.f, 0.f, 3.f / 7.f * 4.f);
+  ExpectLODPosition(out_positions + 3, 0.f, .375f * 2.f, .625f * 4.f);
+}
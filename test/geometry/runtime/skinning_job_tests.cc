@@ -25,11 +25,15 @@
 //                                                                            //
 //----------------------------------------------------------------------------//
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "ozz/base/containers/vector.h"
 #include "ozz/base/log.h"
+#include "ozz/base/maths/box.h"
 #include "ozz/base/maths/gtest_math_helper.h"
 #include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
 #include "ozz/geometry/runtime/skinning_job.h"
 
 using ozz::geometry::SkinningJob;
@@ -1087,6 +1091,1151 @@ TEST(JobResult, SkinningJob) {
   }
 }
 
+TEST(AffineMatrices, SkinningJob) {
+  const ozz::math::Float4x4 matrices[4] = {
+      ozz::math::Float4x4::FromAffine(
+          ozz::math::simd_float4::Load(1.f, -2.f, 3.f, 0.f),
+          ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, .70710677f),
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)),
+      ozz::math::Float4x4::Scaling(
+          ozz::math::simd_float4::Load(1.f, -2.f, 3.f, 0.f)),
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(.5f, 1.f, -2.f, 0.f))};
+  ozz::math::Float4x4 it_matrices[4];
+  ozz::math::Float3x4 affine_matrices[4];
+  ozz::math::Float3x4 affine_it_matrices[4];
+  for (int i = 0; i < 4; ++i) {
+    it_matrices[i] = Transpose(Invert(matrices[i]));
+    affine_matrices[i] = ozz::math::Float3x4::FromFloat4x4(matrices[i]);
+    affine_it_matrices[i] = ozz::math::Float3x4::FromFloat4x4(it_matrices[i]);
+  }
+  const uint16_t joint_indices[10] = {0, 1, 2, 3, 0, 3, 2, 1, 0, 3};
+  const float joint_weights[8] = {.5f, .2f, .1f, .15f, .1f, .25f, .25f, .15f};
+  const float in_positions[6] = {1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+  const float in_normals[6] = {.1f, .2f, .3f, .4f, .5f, .6f};
+  const float in_tangents[6] = {.01f, .02f, .03f, .04f, .05f, .06f};
+
+  // Compares 4x4 and affine 3x4 matrices results, for all code paths.
+  for (int influences = 1; influences <= 5; ++influences) {
+    for (int fct = 0; fct < 3; ++fct) {
+      for (int it = 0; it < 2; ++it) {
+        float out[2][3][6];
+
+        SkinningJob job;
+        job.vertex_count = 2;
+        job.influences_count = influences;
+        job.joint_indices = joint_indices;
+        job.joint_indices_stride = sizeof(uint16_t) * 5;
+        job.joint_weights = joint_weights;
+        job.joint_weights_stride = sizeof(float) * 4;
+        job.in_positions = in_positions;
+        job.in_positions_stride = sizeof(float) * 3;
+        if (fct > 0) {
+          job.in_normals = in_normals;
+          job.in_normals_stride = sizeof(float) * 3;
+        }
+        if (fct > 1) {
+          job.in_tangents = in_tangents;
+          job.in_tangents_stride = sizeof(float) * 3;
+        }
+
+        for (int affine = 0; affine < 2; ++affine) {
+          SkinningJob variant = job;
+          if (affine) {
+            variant.joint_affine_matrices = affine_matrices;
+            if (it) {
+              variant.joint_inverse_transpose_affine_matrices =
+                  affine_it_matrices;
+            }
+          } else {
+            variant.joint_matrices = matrices;
+            if (it) {
+              variant.joint_inverse_transpose_matrices = it_matrices;
+            }
+          }
+          variant.out_positions = out[affine][0];
+          variant.out_positions_stride = sizeof(float) * 3;
+          variant.out_normals = out[affine][1];
+          variant.out_normals_stride = sizeof(float) * 3;
+          variant.out_tangents = out[affine][2];
+          variant.out_tangents_stride = sizeof(float) * 3;
+          ASSERT_TRUE(variant.Run());
+        }
+
+        for (int c = 0; c <= fct; ++c) {
+          for (int i = 0; i < 6; ++i) {
+            EXPECT_NEAR(out[0][c][i], out[1][c][i], 1e-5f)
+                << "influences " << influences << ", fct " << fct << ", it "
+                << it << ", component " << c << ", index " << i;
+          }
+        }
+      }
+    }
+  }
+
+  {  // Invalid job mixing matrix types.
+    SkinningJob job;
+    job.vertex_count = 2;
+    job.influences_count = 1;
+    job.joint_matrices = matrices;
+    job.joint_affine_matrices = affine_matrices;
+    job.joint_indices = joint_indices;
+    job.joint_indices_stride = sizeof(uint16_t) * 5;
+    job.in_positions = in_positions;
+    job.in_positions_stride = sizeof(float) * 3;
+    float out_positions[6];
+    job.out_positions = out_positions;
+    job.out_positions_stride = sizeof(float) * 3;
+    EXPECT_FALSE(job.Validate());
+
+    job.joint_matrices = {};
+    EXPECT_TRUE(job.Validate());
+
+    job.joint_inverse_transpose_matrices = it_matrices;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+TEST(DualQuaternions, SkinningJob) {
+  // Rigid transformations, no scale.
+  const ozz::math::SimdFloat4 rotations[4] = {
+      ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, .70710677f),
+      ozz::math::simd_float4::w_axis(),
+      ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, .70710677f),
+      ozz::math::simd_float4::Load(.5f, .5f, -.5f, .5f)};
+  const ozz::math::SimdFloat4 translations[4] = {
+      ozz::math::simd_float4::Load(1.f, -2.f, 3.f, 0.f),
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f),
+      ozz::math::simd_float4::zero(),
+      ozz::math::simd_float4::Load(-4.f, 0.f, 2.f, 0.f)};
+  ozz::math::Float4x4 matrices[4];
+  ozz::math::SimdDualQuaternion dual_quaternions[4];
+  ozz::math::SimdDualQuaternion negated_dual_quaternions[4];
+  for (int i = 0; i < 4; ++i) {
+    matrices[i] = ozz::math::Float4x4::FromAffine(
+        translations[i], rotations[i], ozz::math::simd_float4::one());
+    const ozz::math::SimdQuaternion rotation = {rotations[i]};
+    dual_quaternions[i] =
+        ozz::math::SimdDualQuaternion::FromAffine(translations[i], rotation);
+    negated_dual_quaternions[i].real = -dual_quaternions[i].real;
+    negated_dual_quaternions[i].dual = -dual_quaternions[i].dual;
+  }
+  const uint16_t joint_indices[10] = {0, 1, 2, 3, 0, 3, 2, 1, 0, 3};
+  const float joint_weights[8] = {.5f, .2f, .1f, .15f, .1f, .25f, .25f, .15f};
+  const float in_positions[6] = {1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+  const float in_normals[6] = {.1f, .2f, .3f, .4f, .5f, .6f};
+  const float in_tangents[6] = {.01f, .02f, .03f, .04f, .05f, .06f};
+
+  for (int influences = 1; influences <= 5; ++influences) {
+    for (int fct = 0; fct < 3; ++fct) {
+      float out[3][3][6];
+
+      SkinningJob job;
+      job.vertex_count = 2;
+      job.influences_count = influences;
+      job.joint_indices = joint_indices;
+      job.joint_indices_stride = sizeof(uint16_t) * 5;
+      job.joint_weights = joint_weights;
+      job.joint_weights_stride = sizeof(float) * 4;
+      job.in_positions = in_positions;
+      job.in_positions_stride = sizeof(float) * 3;
+      if (fct > 0) {
+        job.in_normals = in_normals;
+        job.in_normals_stride = sizeof(float) * 3;
+      }
+      if (fct > 1) {
+        job.in_tangents = in_tangents;
+        job.in_tangents_stride = sizeof(float) * 3;
+      }
+
+      // Runs linear blend skinning, dual quaternion skinning and dual
+      // quaternion skinning with antipodal dual quaternions.
+      for (int variant_id = 0; variant_id < 3; ++variant_id) {
+        SkinningJob variant = job;
+        if (variant_id == 0) {
+          variant.joint_matrices = matrices;
+        } else if (variant_id == 1) {
+          variant.joint_dual_quaternions = dual_quaternions;
+        } else {
+          variant.joint_dual_quaternions = negated_dual_quaternions;
+        }
+        variant.out_positions = out[variant_id][0];
+        variant.out_positions_stride = sizeof(float) * 3;
+        variant.out_normals = out[variant_id][1];
+        variant.out_normals_stride = sizeof(float) * 3;
+        variant.out_tangents = out[variant_id][2];
+        variant.out_tangents_stride = sizeof(float) * 3;
+        ASSERT_TRUE(variant.Run());
+      }
+
+      for (int c = 0; c <= fct; ++c) {
+        for (int i = 0; i < 6; ++i) {
+          // Linear blend and dual quaternion skinning only match for rigid
+          // single influence.
+          if (influences == 1) {
+            EXPECT_NEAR(out[0][c][i], out[1][c][i], 1e-5f)
+                << "influences " << influences << ", fct " << fct
+                << ", component " << c << ", index " << i;
+          }
+          EXPECT_NEAR(out[1][c][i], out[2][c][i], 1e-5f)
+              << "influences " << influences << ", fct " << fct
+              << ", component " << c << ", index " << i;
+        }
+      }
+    }
+  }
+
+  {  // Antipodal dual quaternions of the same transformation are blended to
+     // the same transformation.
+    ozz::math::SimdDualQuaternion antipodals[4] = {
+        dual_quaternions[0], negated_dual_quaternions[0], dual_quaternions[0],
+        negated_dual_quaternions[0]};
+    for (int influences = 1; influences <= 5; ++influences) {
+      float out_positions[6];
+      SkinningJob job;
+      job.vertex_count = 2;
+      job.influences_count = influences;
+      job.joint_dual_quaternions = antipodals;
+      job.joint_indices = joint_indices;
+      job.joint_indices_stride = sizeof(uint16_t) * 5;
+      job.joint_weights = joint_weights;
+      job.joint_weights_stride = sizeof(float) * 4;
+      job.in_positions = in_positions;
+      job.in_positions_stride = sizeof(float) * 3;
+      job.out_positions = out_positions;
+      job.out_positions_stride = sizeof(float) * 3;
+      ASSERT_TRUE(job.Run());
+      EXPECT_NEAR(out_positions[0], 4.f, 1e-5f);
+      EXPECT_NEAR(out_positions[1], 0.f, 1e-5f);
+      EXPECT_NEAR(out_positions[2], 2.f, 1e-5f);
+      EXPECT_NEAR(out_positions[3], 7.f, 1e-5f);
+      EXPECT_NEAR(out_positions[4], 3.f, 1e-5f);
+      EXPECT_NEAR(out_positions[5], -1.f, 1e-5f);
+    }
+  }
+
+  {  // Dual quaternion skinning preserves distance to the twisting joint.
+    const ozz::math::SimdDualQuaternion twisted[2] = {
+        ozz::math::SimdDualQuaternion::identity(), dual_quaternions[2]};
+    const uint16_t twist_indices[2] = {0, 1};
+    const float twist_weights[1] = {.5f};
+    const float twist_position[3] = {0.f, 1.f, 0.f};
+    float out_position[3];
+    SkinningJob job;
+    job.vertex_count = 1;
+    job.influences_count = 2;
+    job.joint_dual_quaternions = twisted;
+    job.joint_indices = twist_indices;
+    job.joint_indices_stride = sizeof(uint16_t) * 2;
+    job.joint_weights = twist_weights;
+    job.joint_weights_stride = sizeof(float) * 1;
+    job.in_positions = twist_position;
+    job.in_positions_stride = sizeof(float) * 3;
+    job.out_positions = out_position;
+    job.out_positions_stride = sizeof(float) * 3;
+    ASSERT_TRUE(job.Run());
+    EXPECT_NEAR(out_position[0], 0.f, 1e-5f);
+    EXPECT_NEAR(out_position[1], .70710677f, 1e-5f);
+    EXPECT_NEAR(out_position[2], .70710677f, 1e-5f);
+  }
+
+  {  // Invalid jobs mixing matrix types.
+    SkinningJob job;
+    job.vertex_count = 2;
+    job.influences_count = 1;
+    job.joint_matrices = matrices;
+    job.joint_dual_quaternions = dual_quaternions;
+    job.joint_indices = joint_indices;
+    job.joint_indices_stride = sizeof(uint16_t) * 5;
+    job.in_positions = in_positions;
+    job.in_positions_stride = sizeof(float) * 3;
+    float out_positions[6];
+    job.out_positions = out_positions;
+    job.out_positions_stride = sizeof(float) * 3;
+    EXPECT_FALSE(job.Validate());
+
+    job.joint_matrices = {};
+    EXPECT_TRUE(job.Validate());
+
+    job.joint_inverse_transpose_matrices = matrices;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+TEST(CompressedJobValidity, SkinningJob) {
+  const ozz::math::Float4x4 matrices[2] = {ozz::math::Float4x4::identity(),
+                                           ozz::math::Float4x4::identity()};
+  const uint8_t joint_indices[8] = {};
+  const uint8_t joint_weights[6] = {};
+  const uint16_t in_positions[6] = {};
+  const int16_t in_normals[4] = {};
+  const int16_t in_tangents[4] = {};
+  float out_positions[6];
+  uint16_t out_half_positions[6];
+  int16_t out_normals[4];
+  int16_t out_tangents[4];
+
+  SkinningJob valid;
+  valid.vertex_count = 2;
+  valid.influences_count = 4;
+  valid.joint_matrices = matrices;
+  valid.joint_compact_indices = joint_indices;
+  valid.joint_indices_stride = sizeof(uint8_t) * 4;
+  valid.joint_compact_weights = joint_weights;
+  valid.joint_weights_stride = sizeof(uint8_t) * 3;
+  valid.in_half_positions = in_positions;
+  valid.in_positions_stride = sizeof(uint16_t) * 3;
+  valid.in_octahedral_normals = in_normals;
+  valid.in_normals_stride = sizeof(int16_t) * 2;
+  valid.in_octahedral_tangents = in_tangents;
+  valid.in_tangents_stride = sizeof(int16_t) * 2;
+  valid.out_half_positions = out_half_positions;
+  valid.out_positions_stride = sizeof(uint16_t) * 3;
+  valid.out_octahedral_normals = out_normals;
+  valid.out_normals_stride = sizeof(int16_t) * 2;
+  valid.out_octahedral_tangents = out_tangents;
+  valid.out_tangents_stride = sizeof(int16_t) * 2;
+  EXPECT_TRUE(valid.Validate());
+  EXPECT_TRUE(valid.Run());
+
+  {  // Indices provided in two formats.
+    SkinningJob job = valid;
+    const uint16_t indices[8] = {};
+    job.joint_indices = indices;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Weights provided in two formats.
+    SkinningJob job = valid;
+    const float weights[6] = {};
+    job.joint_weights = weights;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Positions provided in two formats.
+    SkinningJob job = valid;
+    const int16_t positions[6] = {};
+    job.in_snorm16_positions = positions;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Output positions in two formats.
+    SkinningJob job = valid;
+    job.out_positions = out_positions;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // No output positions.
+    SkinningJob job = valid;
+    job.out_half_positions = {};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Float output positions.
+    SkinningJob job = valid;
+    job.out_half_positions = {};
+    job.out_positions = out_positions;
+    job.out_positions_stride = sizeof(float) * 3;
+    EXPECT_TRUE(job.Validate());
+  }
+  {  // Compressed indices too small.
+    SkinningJob job = valid;
+    job.joint_compact_indices = {joint_indices, 7};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Compressed positions too small.
+    SkinningJob job = valid;
+    job.in_half_positions = {in_positions, 5};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Compressed output positions too small.
+    SkinningJob job = valid;
+    job.out_half_positions = {out_half_positions, 5};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // No output normals.
+    SkinningJob job = valid;
+    job.out_octahedral_normals = {};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Compressed normals too small.
+    SkinningJob job = valid;
+    job.in_octahedral_normals = {in_normals, 3};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Tangents without normals.
+    SkinningJob job = valid;
+    job.in_octahedral_normals = {};
+    job.out_octahedral_normals = {};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // No output tangents.
+    SkinningJob job = valid;
+    job.out_octahedral_tangents = {};
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Too many influences for compact indices.
+    SkinningJob job = valid;
+    job.vertex_count = 1;
+    job.influences_count = 257;
+    ozz::vector<uint8_t> indices(257);
+    ozz::vector<uint8_t> weights(256);
+    job.joint_compact_indices = ozz::make_span(indices);
+    job.joint_compact_weights = ozz::make_span(weights);
+    EXPECT_FALSE(job.Validate());
+    job.influences_count = 256;
+    EXPECT_TRUE(job.Validate());
+  }
+}
+
+namespace {
+// Reference octahedral encoding of unit vector _v.
+void EncodeOctahedral(const float* _v, int16_t* _out) {
+  const float l1 = std::abs(_v[0]) + std::abs(_v[1]) + std::abs(_v[2]);
+  float x = _v[0] / l1;
+  float y = _v[1] / l1;
+  if (_v[2] < 0.f) {
+    const float fx = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+    const float fy = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+    x = fx;
+    y = fy;
+  }
+  _out[0] = static_cast<int16_t>(std::floor(x * 32767.f + .5f));
+  _out[1] = static_cast<int16_t>(std::floor(y * 32767.f + .5f));
+}
+
+// Reference octahedral decoding to unit vector _out.
+void DecodeOctahedral(const int16_t* _v, float* _out) {
+  float x = _v[0] / 32767.f;
+  float y = _v[1] / 32767.f;
+  const float z = 1.f - std::abs(x) - std::abs(y);
+  if (z < 0.f) {
+    const float fx = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+    const float fy = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+    x = fx;
+    y = fy;
+  }
+  const float len = std::sqrt(x * x + y * y + z * z);
+  _out[0] = x / len;
+  _out[1] = y / len;
+  _out[2] = z / len;
+}
+
+struct FloatVertex {
+  uint16_t indices[5];
+  float weights[4];
+  float positions[3];
+  float normals[3];
+  float tangents[3];
+};
+
+struct CompressedVertex {
+  uint8_t indices[5];
+  uint8_t weights[4];
+  uint16_t half_positions[3];
+  int16_t snorm16_positions[3];
+  int16_t normals[2];
+  int16_t tangents[2];
+};
+}  // namespace
+
+TEST(CompressedResult, SkinningJob) {
+  // Rigid transformations, so unit normals remain normalized.
+  ozz::math::Float4x4 matrices[3];
+  matrices[0] = ozz::math::Float4x4::FromAffine(
+      ozz::math::simd_float4::Load(1.f, -2.f, 3.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, .70710677f),
+      ozz::math::simd_float4::one());
+  matrices[1] = ozz::math::Float4x4::FromAffine(
+      ozz::math::simd_float4::Load(-1.f, .5f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(.5f, .5f, -.5f, .5f),
+      ozz::math::simd_float4::one());
+  matrices[2] = ozz::math::Float4x4::identity();
+
+  // More vertices than a decoding chunk.
+  const int kVertices = 37;
+  FloatVertex in[kVertices];
+  CompressedVertex compressed[kVertices];
+  const ozz::math::Float3 scale(2.5f, 2.5f, 1.f);
+  const ozz::math::Float3 offset(.5f, 0.f, -.5f);
+  for (int i = 0; i < kVertices; ++i) {
+    FloatVertex& v = in[i];
+    CompressedVertex& c = compressed[i];
+    for (int j = 0; j < 5; ++j) {
+      c.indices[j] = static_cast<uint8_t>((i + j) % 3);
+      v.indices[j] = c.indices[j];
+    }
+    // Weights are quantized, so they can be compared exactly.
+    for (int j = 0; j < 4; ++j) {
+      c.weights[j] = static_cast<uint8_t>(10 + (i * 17 + j * 31) % 50);
+      v.weights[j] = c.weights[j] / 255.f;
+    }
+
+    // Positions and vectors are compressed from float values.
+    const float p[3] = {std::sin(i * .3f) * 2.f, std::cos(i * .7f) * 2.5f,
+                        i * .02f - .5f};
+    int16_t snorm16[3];
+    snorm16[0] = static_cast<int16_t>(
+        std::floor((p[0] - offset.x) / scale.x * 32767.f + .5f));
+    snorm16[1] = static_cast<int16_t>(
+        std::floor((p[1] - offset.y) / scale.y * 32767.f + .5f));
+    snorm16[2] = static_cast<int16_t>(
+        std::floor((p[2] - offset.z) / scale.z * 32767.f + .5f));
+    for (int k = 0; k < 3; ++k) {
+      v.positions[k] = p[k];
+      c.half_positions[k] = ozz::math::FloatToHalf(p[k]);
+      c.snorm16_positions[k] = snorm16[k];
+    }
+    const ozz::math::Float3 n =
+        Normalize(ozz::math::Float3(std::cos(i * 1.3f), std::sin(i * .9f),
+                                    std::cos(i * 2.1f) - .2f));
+    const ozz::math::Float3 t = Normalize(
+        ozz::math::Float3(-std::sin(i * .4f), .3f, std::cos(i * 1.1f)));
+    v.normals[0] = n.x;
+    v.normals[1] = n.y;
+    v.normals[2] = n.z;
+    v.tangents[0] = t.x;
+    v.tangents[1] = t.y;
+    v.tangents[2] = t.z;
+    EncodeOctahedral(v.normals, c.normals);
+    EncodeOctahedral(v.tangents, c.tangents);
+  }
+
+  for (int influences = 1; influences <= 5; ++influences) {
+    for (int fct = 0; fct < 3; ++fct) {
+      // Reference, with float streams.
+      float expected[kVertices][3][3];
+      SkinningJob job;
+      job.vertex_count = kVertices;
+      job.influences_count = influences;
+      job.joint_matrices = matrices;
+      job.joint_indices = {in[0].indices, in[kVertices - 1].indices + 5};
+      job.joint_indices_stride = sizeof(FloatVertex);
+      job.joint_weights = {in[0].weights, in[kVertices - 1].weights + 4};
+      job.joint_weights_stride = sizeof(FloatVertex);
+      job.in_positions = {in[0].positions, in[kVertices - 1].positions + 3};
+      job.in_positions_stride = sizeof(FloatVertex);
+      job.out_positions = {expected[0][0], expected[kVertices - 1][0] + 3};
+      job.out_positions_stride = sizeof(expected[0]);
+      if (fct > 0) {
+        job.in_normals = {in[0].normals, in[kVertices - 1].normals + 3};
+        job.in_normals_stride = sizeof(FloatVertex);
+        job.out_normals = {expected[0][1], expected[kVertices - 1][1] + 3};
+        job.out_normals_stride = sizeof(expected[0]);
+      }
+      if (fct > 1) {
+        job.in_tangents = {in[0].tangents, in[kVertices - 1].tangents + 3};
+        job.in_tangents_stride = sizeof(FloatVertex);
+        job.out_tangents = {expected[0][2], expected[kVertices - 1][2] + 3};
+        job.out_tangents_stride = sizeof(expected[0]);
+      }
+      ASSERT_TRUE(job.Run());
+
+      // Compressed inputs, float outputs. Half and snorm16 positions are
+      // tested.
+      for (int snorm = 0; snorm < 2; ++snorm) {
+        float out[kVertices][3][3];
+        SkinningJob cjob = job;
+        cjob.joint_indices = {};
+        cjob.joint_compact_indices = {compressed[0].indices,
+                                      compressed[kVertices - 1].indices + 5};
+        cjob.joint_indices_stride = sizeof(CompressedVertex);
+        cjob.joint_weights = {};
+        cjob.joint_compact_weights = {compressed[0].weights,
+                                      compressed[kVertices - 1].weights + 4};
+        cjob.joint_weights_stride = sizeof(CompressedVertex);
+        cjob.in_positions = {};
+        if (snorm) {
+          cjob.in_snorm16_positions = {
+              compressed[0].snorm16_positions,
+              compressed[kVertices - 1].snorm16_positions + 3};
+          cjob.in_positions_scale = scale;
+          cjob.in_positions_offset = offset;
+        } else {
+          cjob.in_half_positions = {
+              compressed[0].half_positions,
+              compressed[kVertices - 1].half_positions + 3};
+        }
+        cjob.in_positions_stride = sizeof(CompressedVertex);
+        cjob.out_positions = {out[0][0], out[kVertices - 1][0] + 3};
+        if (fct > 0) {
+          cjob.in_normals = {};
+          cjob.in_octahedral_normals = {compressed[0].normals,
+                                        compressed[kVertices - 1].normals + 2};
+          cjob.in_normals_stride = sizeof(CompressedVertex);
+          cjob.out_normals = {out[0][1], out[kVertices - 1][1] + 3};
+        }
+        if (fct > 1) {
+          cjob.in_tangents = {};
+          cjob.in_octahedral_tangents = {
+              compressed[0].tangents, compressed[kVertices - 1].tangents + 2};
+          cjob.in_tangents_stride = sizeof(CompressedVertex);
+          cjob.out_tangents = {out[0][2], out[kVertices - 1][2] + 3};
+        }
+        ASSERT_TRUE(cjob.Run());
+
+        for (int i = 0; i < kVertices; ++i) {
+          for (int s = 0; s < fct + 1; ++s) {
+            for (int k = 0; k < 3; ++k) {
+              EXPECT_NEAR(out[i][s][k], expected[i][s][k], 5e-3f);
+            }
+          }
+        }
+      }
+
+      // Float inputs, compressed outputs.
+      {
+        CompressedVertex out[kVertices];
+        SkinningJob cjob = job;
+        cjob.out_positions = {};
+        cjob.out_half_positions = {out[0].half_positions,
+                                   out[kVertices - 1].half_positions + 3};
+        cjob.out_positions_stride = sizeof(CompressedVertex);
+        if (fct > 0) {
+          cjob.out_normals = {};
+          cjob.out_octahedral_normals = {out[0].normals,
+                                         out[kVertices - 1].normals + 2};
+          cjob.out_normals_stride = sizeof(CompressedVertex);
+        }
+        if (fct > 1) {
+          cjob.out_tangents = {};
+          cjob.out_octahedral_tangents = {out[0].tangents,
+                                          out[kVertices - 1].tangents + 2};
+          cjob.out_tangents_stride = sizeof(CompressedVertex);
+        }
+        ASSERT_TRUE(cjob.Run());
+
+        for (int i = 0; i < kVertices; ++i) {
+          for (int k = 0; k < 3; ++k) {
+            EXPECT_NEAR(ozz::math::HalfToFloat(out[i].half_positions[k]),
+                        expected[i][0][k], 5e-3f);
+          }
+          if (fct > 0) {
+            // Octahedral encoding normalizes vectors.
+            float normal[3];
+            DecodeOctahedral(out[i].normals, normal);
+            const ozz::math::Float3 e =
+                Normalize(ozz::math::Float3(expected[i][1][0],
+                                            expected[i][1][1],
+                                            expected[i][1][2]));
+            EXPECT_NEAR(normal[0], e.x, 1e-3f);
+            EXPECT_NEAR(normal[1], e.y, 1e-3f);
+            EXPECT_NEAR(normal[2], e.z, 1e-3f);
+          }
+          if (fct > 1) {
+            // Octahedral encoding normalizes vectors.
+            float tangent[3];
+            DecodeOctahedral(out[i].tangents, tangent);
+            const ozz::math::Float3 e =
+                Normalize(ozz::math::Float3(expected[i][2][0],
+                                            expected[i][2][1],
+                                            expected[i][2][2]));
+            EXPECT_NEAR(tangent[0], e.x, 1e-3f);
+            EXPECT_NEAR(tangent[1], e.y, 1e-3f);
+            EXPECT_NEAR(tangent[2], e.z, 1e-3f);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(CompressedManyInfluences, SkinningJob) {
+  ozz::math::Float4x4 matrices[3];
+  matrices[0] = ozz::math::Float4x4::Translation(
+      ozz::math::simd_float4::Load(1.f, -2.f, 3.f, 0.f));
+  matrices[1] = ozz::math::Float4x4::Scaling(
+      ozz::math::simd_float4::Load(2.f, 2.f, 2.f, 0.f));
+  matrices[2] = ozz::math::Float4x4::identity();
+
+  // More influences than compact indices and weights support, with a
+  // compressed positions stream that doesn't bound chunk size.
+  const int kInfluences = 300;
+  const int kVertices = 5;
+  ozz::vector<uint16_t> indices(kVertices * kInfluences);
+  ozz::vector<float> weights(kVertices * (kInfluences - 1));
+  float positions[kVertices * 3];
+  uint16_t half_positions[kVertices * 3];
+  for (int i = 0; i < kVertices; ++i) {
+    for (int j = 0; j < kInfluences; ++j) {
+      indices[i * kInfluences + j] = static_cast<uint16_t>((i + j) % 3);
+    }
+    for (int j = 0; j < kInfluences - 1; ++j) {
+      weights[i * (kInfluences - 1) + j] = 1.f / kInfluences;
+    }
+    for (int k = 0; k < 3; ++k) {
+      const float p = static_cast<float>(i - k);
+      positions[i * 3 + k] = p;
+      half_positions[i * 3 + k] = ozz::math::FloatToHalf(p);
+    }
+  }
+
+  float expected[kVertices * 3 + 1];
+  float result[kVertices * 3 + 1];
+  SkinningJob job;
+  job.vertex_count = kVertices;
+  job.influences_count = kInfluences;
+  job.joint_matrices = matrices;
+  job.joint_indices = make_span(indices);
+  job.joint_indices_stride = sizeof(uint16_t) * kInfluences;
+  job.joint_weights = make_span(weights);
+  job.joint_weights_stride = sizeof(float) * (kInfluences - 1);
+  job.in_positions = positions;
+  job.in_positions_stride = sizeof(float) * 3;
+  job.out_positions = {expected, kVertices * 3};
+  job.out_positions_stride = sizeof(float) * 3;
+  ASSERT_TRUE(job.Run());
+
+  job.in_positions = {};
+  job.in_half_positions = half_positions;
+  job.in_positions_stride = sizeof(uint16_t) * 3;
+  job.out_positions = {result, kVertices * 3};
+  EXPECT_TRUE(job.Validate());
+  ASSERT_TRUE(job.Run());
+  for (int i = 0; i < kVertices * 3; ++i) {
+    EXPECT_FLOAT_EQ(result[i], expected[i]);
+  }
+}
+
+TEST(Range, SkinningJob) {
+  const ozz::math::Float4x4 matrices[1] = {
+      ozz::math::Float4x4::Scaling(ozz::math::simd_float4::Load1(2.f))};
+  const uint16_t joint_indices[4] = {0, 0, 0, 0};
+  const float in_positions[12] = {1.f, 2.f, 3.f, 4.f,  5.f,  6.f,
+                                  7.f, 8.f, 9.f, 10.f, 11.f, 12.f};
+  float out_positions[12] = {};
+
+  SkinningJob job;
+  job.vertex_count = 4;
+  job.influences_count = 1;
+  job.joint_matrices = matrices;
+  job.joint_indices = joint_indices;
+  job.joint_indices_stride = sizeof(uint16_t);
+  job.in_positions = in_positions;
+  job.in_positions_stride = sizeof(float) * 3;
+  job.out_positions = out_positions;
+  job.out_positions_stride = sizeof(float) * 3;
+
+  const SkinningJob range = job.Range(1, 2);
+  EXPECT_EQ(range.vertex_count, 2);
+  EXPECT_EQ(range.in_positions.begin(), in_positions + 3);
+  EXPECT_EQ(range.out_positions.begin(), out_positions + 3);
+  EXPECT_EQ(range.joint_indices.begin(), joint_indices + 1);
+  EXPECT_TRUE(range.joint_weights.empty());
+  EXPECT_TRUE(range.in_normals.empty());
+  EXPECT_TRUE(range.Run());
+
+  const float expected[12] = {0.f, 0.f,  0.f,  8.f, 10.f, 12.f,
+                              14.f, 16.f, 18.f, 0.f, 0.f,  0.f};
+  for (int i = 0; i < 12; ++i) {
+    EXPECT_FLOAT_EQ(out_positions[i], expected[i]);
+  }
+
+  // Empty range.
+  EXPECT_EQ(job.Range(4, 0).vertex_count, 0);
+}
+
+struct WideVertexIn {
+  float pos[3];
+  float normal[3];
+  float tangent[3];
+  uint16_t indices[5];
+  float weights[4];
+};
+
+TEST(WideResult, SkinningJob) {
+  const int joint_count = 6;
+  ozz::math::Float4x4 matrices[joint_count];
+  ozz::math::Float4x4 it_matrices[joint_count];
+  ozz::math::Float3x4 affine_matrices[joint_count];
+  ozz::math::Float3x4 affine_it_matrices[joint_count];
+  for (int i = 0; i < joint_count; ++i) {
+    const float f = static_cast<float>(i);
+    matrices[i] = ozz::math::Float4x4::FromAffine(
+        ozz::math::simd_float4::Load(f, -2.f * f, 1.f, 0.f),
+        ozz::math::NormalizeEst4(
+            ozz::math::simd_float4::Load(.1f * f, .7f, -.2f, 1.f + f)),
+        ozz::math::simd_float4::Load(1.f + f, 2.f, .5f + f, 0.f));
+    it_matrices[i] = Transpose(Invert(matrices[i]));
+    affine_matrices[i] = ozz::math::Float3x4::FromFloat4x4(matrices[i]);
+    affine_it_matrices[i] = ozz::math::Float3x4::FromFloat4x4(it_matrices[i]);
+  }
+
+  // Number of vertices isn't a multiple of 8 nor 4, to test all code paths.
+  const int vertex_count = 19;
+  WideVertexIn in[vertex_count];
+  for (int i = 0; i < vertex_count; ++i) {
+    const float f = static_cast<float>(i);
+    for (int j = 0; j < 3; ++j) {
+      in[i].pos[j] = f - 3.f * j;
+      in[i].normal[j] = .1f * f * j;
+      in[i].tangent[j] = .2f * j - .1f * f;
+    }
+    for (int j = 0; j < 5; ++j) {
+      in[i].indices[j] = static_cast<uint16_t>((i + j * 7) % joint_count);
+    }
+    for (int j = 0; j < 4; ++j) {
+      in[i].weights[j] = .05f * ((i + j) % 5);
+    }
+  }
+
+  // Compares the skinning of all vertices at once, with vertex by vertex
+  // skinning, for all code paths.
+  for (int influences = 1; influences <= 5; ++influences) {
+    for (int fct = 0; fct < 3; ++fct) {
+      for (int it = 0; it < 2; ++it) {
+        for (int affine = 0; affine < 2; ++affine) {
+          float out[2][vertex_count][3][3];
+
+          for (int single = 0; single < 2; ++single) {
+            const int count = single ? 1 : vertex_count;
+            for (int v = 0; v < vertex_count; v += count) {
+              SkinningJob job;
+              job.vertex_count = count;
+              job.influences_count = influences;
+              if (affine) {
+                job.joint_affine_matrices = affine_matrices;
+                if (it) {
+                  job.joint_inverse_transpose_affine_matrices =
+                      affine_it_matrices;
+                }
+              } else {
+                job.joint_matrices = matrices;
+                if (it) {
+                  job.joint_inverse_transpose_matrices = it_matrices;
+                }
+              }
+              job.joint_indices = {in[v].indices,
+                                   in[vertex_count - 1].indices + 5};
+              job.joint_indices_stride = sizeof(WideVertexIn);
+              job.joint_weights = {in[v].weights, in[vertex_count - 1].weights +
+                                                      4};
+              job.joint_weights_stride = sizeof(WideVertexIn);
+              job.in_positions = {in[v].pos, in[vertex_count - 1].pos + 3};
+              job.in_positions_stride = sizeof(WideVertexIn);
+              job.out_positions = {out[single][v][0],
+                                   out[single][vertex_count - 1][0] + 3};
+              job.out_positions_stride = sizeof(out[0][0]);
+              if (fct > 0) {
+                job.in_normals = {in[v].normal,
+                                  in[vertex_count - 1].normal + 3};
+                job.in_normals_stride = sizeof(WideVertexIn);
+                job.out_normals = {out[single][v][1],
+                                   out[single][vertex_count - 1][1] + 3};
+                job.out_normals_stride = sizeof(out[0][0]);
+              }
+              if (fct > 1) {
+                job.in_tangents = {in[v].tangent,
+                                   in[vertex_count - 1].tangent + 3};
+                job.in_tangents_stride = sizeof(WideVertexIn);
+                job.out_tangents = {out[single][v][2],
+                                    out[single][vertex_count - 1][2] + 3};
+                job.out_tangents_stride = sizeof(out[0][0]);
+              }
+              ASSERT_TRUE(job.Run());
+            }
+          }
+
+          for (int v = 0; v < vertex_count; ++v) {
+            for (int c = 0; c <= fct; ++c) {
+              for (int i = 0; i < 3; ++i) {
+                EXPECT_NEAR(out[0][v][c][i], out[1][v][c][i], 1e-4f)
+                    << "influences " << influences << ", fct " << fct
+                    << ", it " << it << ", affine " << affine << ", vertex "
+                    << v << ", component " << c << ", index " << i;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(Bounds, SkinningJob) {
+  const int joint_count = 4;
+  ozz::math::Float4x4 matrices[joint_count];
+  ozz::math::Float3x4 affine_matrices[joint_count];
+  for (int i = 0; i < joint_count; ++i) {
+    const float f = static_cast<float>(i);
+    matrices[i] = ozz::math::Float4x4::FromAffine(
+        ozz::math::simd_float4::Load(f, -2.f * f, 1.f, 0.f),
+        ozz::math::NormalizeEst4(
+            ozz::math::simd_float4::Load(.1f * f, .7f, -.2f, 1.f + f)),
+        ozz::math::simd_float4::Load(1.f + f, 2.f, .5f + f, 0.f));
+    affine_matrices[i] = ozz::math::Float3x4::FromFloat4x4(matrices[i]);
+  }
+
+  // Odd number of vertices, to test all code paths.
+  const int vertex_count = 19;
+  WideVertexIn in[vertex_count];
+  for (int i = 0; i < vertex_count; ++i) {
+    const float f = static_cast<float>(i);
+    for (int j = 0; j < 3; ++j) {
+      in[i].pos[j] = (i & 1 ? f : -f) - 3.f * j;
+      in[i].normal[j] = .1f * f * j;
+      in[i].tangent[j] = .2f * j - .1f * f;
+    }
+    for (int j = 0; j < 5; ++j) {
+      in[i].indices[j] = static_cast<uint16_t>((i + j * 3) % joint_count);
+    }
+    for (int j = 0; j < 4; ++j) {
+      in[i].weights[j] = .05f * ((i + j) % 5);
+    }
+  }
+
+  for (int influences = 1; influences <= 5; ++influences) {
+    for (int fct = 0; fct < 3; ++fct) {
+      for (int affine = 0; affine < 2; ++affine) {
+        float out[vertex_count][3][3];
+        ozz::math::Box bounds;
+
+        SkinningJob job;
+        job.vertex_count = vertex_count;
+        job.influences_count = influences;
+        if (affine) {
+          job.joint_affine_matrices = affine_matrices;
+        } else {
+          job.joint_matrices = matrices;
+        }
+        job.joint_indices = {in[0].indices, in[vertex_count - 1].indices + 5};
+        job.joint_indices_stride = sizeof(WideVertexIn);
+        job.joint_weights = {in[0].weights, in[vertex_count - 1].weights + 4};
+        job.joint_weights_stride = sizeof(WideVertexIn);
+        job.in_positions = {in[0].pos, in[vertex_count - 1].pos + 3};
+        job.in_positions_stride = sizeof(WideVertexIn);
+        job.out_positions = {out[0][0], out[vertex_count - 1][0] + 3};
+        job.out_positions_stride = sizeof(out[0]);
+        if (fct > 0) {
+          job.in_normals = {in[0].normal, in[vertex_count - 1].normal + 3};
+          job.in_normals_stride = sizeof(WideVertexIn);
+          job.out_normals = {out[0][1], out[vertex_count - 1][1] + 3};
+          job.out_normals_stride = sizeof(out[0]);
+        }
+        if (fct > 1) {
+          job.in_tangents = {in[0].tangent, in[vertex_count - 1].tangent + 3};
+          job.in_tangents_stride = sizeof(WideVertexIn);
+          job.out_tangents = {out[0][2], out[vertex_count - 1][2] + 3};
+          job.out_tangents_stride = sizeof(out[0]);
+        }
+        job.out_bounds = &bounds;
+        ASSERT_TRUE(job.Run());
+
+        // Bounds exactly match output positions.
+        const ozz::math::Box reference(
+            reinterpret_cast<const ozz::math::Float3*>(out[0][0]),
+            sizeof(out[0]), vertex_count);
+        EXPECT_FLOAT3_EQ(bounds.min, reference.min.x, reference.min.y,
+                         reference.min.z);
+        EXPECT_FLOAT3_EQ(bounds.max, reference.max.x, reference.max.y,
+                         reference.max.z);
+
+        // Bounds of compressed outputs are computed before encoding.
+        uint16_t half_positions[vertex_count][3];
+        ozz::math::Box half_bounds;
+        job.out_positions = {};
+        job.out_half_positions = {half_positions[0],
+                                  half_positions[vertex_count - 1] + 3};
+        job.out_positions_stride = sizeof(half_positions[0]);
+        job.out_normals = {};
+        job.out_tangents = {};
+        job.in_normals = {};
+        job.in_tangents = {};
+        job.out_bounds = &half_bounds;
+        ASSERT_TRUE(job.Run());
+        EXPECT_FLOAT3_EQ(half_bounds.min, reference.min.x, reference.min.y,
+                         reference.min.z);
+        EXPECT_FLOAT3_EQ(half_bounds.max, reference.max.x, reference.max.y,
+                         reference.max.z);
+      }
+    }
+  }
+
+  {  // No vertex.
+    const uint16_t joint_indices[1] = {0};
+    const float in_positions[3] = {0.f, 0.f, 0.f};
+    float out_positions[3];
+    ozz::math::Box bounds(ozz::math::Float3::zero());
+
+    SkinningJob job;
+    job.vertex_count = 0;
+    job.influences_count = 1;
+    job.joint_matrices = matrices;
+    job.joint_indices = joint_indices;
+    job.joint_indices_stride = sizeof(uint16_t);
+    job.in_positions = in_positions;
+    job.in_positions_stride = sizeof(float) * 3;
+    job.out_positions = out_positions;
+    job.out_positions_stride = sizeof(float) * 3;
+    job.out_bounds = &bounds;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FALSE(bounds.is_valid());
+  }
+}
+
+TEST(PreviousPositions, SkinningJob) {
+  // Two palettes of rigid transformations, so they can also be expressed as
+  // dual quaternions.
+  const int joint_count = 4;
+  ozz::math::Float4x4 matrices[2][joint_count];
+  ozz::math::Float3x4 affine_matrices[2][joint_count];
+  ozz::math::SimdDualQuaternion dual_quaternions[2][joint_count];
+  for (int p = 0; p < 2; ++p) {
+    for (int i = 0; i < joint_count; ++i) {
+      const float f = static_cast<float>(i + p * joint_count);
+      const ozz::math::SimdFloat4 translation =
+          ozz::math::simd_float4::Load(f, -2.f * f, 1.f, 0.f);
+      const ozz::math::SimdQuaternion rotation = {ozz::math::Normalize4(
+          ozz::math::simd_float4::Load(.1f * f, .7f, -.2f, 1.f + f))};
+      matrices[p][i] = ozz::math::Float4x4::FromAffine(
+          translation, rotation.xyzw, ozz::math::simd_float4::one());
+      affine_matrices[p][i] =
+          ozz::math::Float3x4::FromFloat4x4(matrices[p][i]);
+      dual_quaternions[p][i] =
+          ozz::math::SimdDualQuaternion::FromAffine(translation, rotation);
+    }
+  }
+
+  // Odd number of vertices, to test all code paths.
+  const int vertex_count = 19;
+  WideVertexIn in[vertex_count];
+  for (int i = 0; i < vertex_count; ++i) {
+    const float f = static_cast<float>(i);
+    for (int j = 0; j < 3; ++j) {
+      in[i].pos[j] = f - 3.f * j;
+      in[i].normal[j] = .1f * f * j;
+      in[i].tangent[j] = .2f * j - .1f * f;
+    }
+    for (int j = 0; j < 5; ++j) {
+      in[i].indices[j] = static_cast<uint16_t>((i + j * 3) % joint_count);
+    }
+    for (int j = 0; j < 4; ++j) {
+      in[i].weights[j] = .05f * ((i + j) % 5);
+    }
+  }
+
+  for (int type = 0; type < 3; ++type) {
+    for (int influences = 1; influences <= 5; ++influences) {
+      for (int fct = 0; fct < 3; ++fct) {
+        // out[0] and out[1] are current and previous positions of the dual
+        // palette job, out[2] and out[3] of 2 single palette jobs.
+        float out[4][vertex_count * 3];
+        float out_vectors[2][vertex_count * 3];
+
+        SkinningJob job;
+        job.vertex_count = vertex_count;
+        job.influences_count = influences;
+        job.joint_indices = {in[0].indices, in[vertex_count - 1].indices + 5};
+        job.joint_indices_stride = sizeof(WideVertexIn);
+        job.joint_weights = {in[0].weights, in[vertex_count - 1].weights + 4};
+        job.joint_weights_stride = sizeof(WideVertexIn);
+        job.in_positions = {in[0].pos, in[vertex_count - 1].pos + 3};
+        job.in_positions_stride = sizeof(WideVertexIn);
+        job.out_positions_stride = sizeof(float) * 3;
+        if (fct > 0) {
+          job.in_normals = {in[0].normal, in[vertex_count - 1].normal + 3};
+          job.in_normals_stride = sizeof(WideVertexIn);
+          job.out_normals = out_vectors[0];
+          job.out_normals_stride = sizeof(float) * 3;
+        }
+        if (fct > 1) {
+          job.in_tangents = {in[0].tangent, in[vertex_count - 1].tangent + 3};
+          job.in_tangents_stride = sizeof(WideVertexIn);
+          job.out_tangents = out_vectors[1];
+          job.out_tangents_stride = sizeof(float) * 3;
+        }
+
+        for (int p = 0; p < 2; ++p) {
+          SkinningJob single = job;
+          if (type == 0) {
+            single.joint_matrices = matrices[p];
+          } else if (type == 1) {
+            single.joint_affine_matrices = affine_matrices[p];
+          } else {
+            single.joint_dual_quaternions = dual_quaternions[p];
+          }
+          single.out_positions = out[2 + p];
+          ASSERT_TRUE(single.Run());
+        }
+
+        SkinningJob dual = job;
+        if (type == 0) {
+          dual.joint_matrices = matrices[0];
+          dual.joint_previous_matrices = matrices[1];
+        } else if (type == 1) {
+          dual.joint_affine_matrices = affine_matrices[0];
+          dual.joint_previous_affine_matrices = affine_matrices[1];
+        } else {
+          dual.joint_dual_quaternions = dual_quaternions[0];
+          dual.joint_previous_dual_quaternions = dual_quaternions[1];
+        }
+        dual.out_positions = out[0];
+        dual.out_previous_positions = out[1];
+        dual.out_previous_positions_stride = sizeof(float) * 3;
+        ASSERT_TRUE(dual.Run());
+
+        for (int v = 0; v < vertex_count; ++v) {
+          for (int i = 0; i < 3; ++i) {
+            EXPECT_FLOAT_EQ(out[0][v * 3 + i], out[2][v * 3 + i])
+                << "type " << type << ", influences " << influences
+                << ", fct " << fct << ", vertex " << v;
+            EXPECT_FLOAT_EQ(out[1][v * 3 + i], out[3][v * 3 + i])
+                << "type " << type << ", influences " << influences
+                << ", fct " << fct << ", vertex " << v;
+          }
+        }
+      }
+    }
+  }
+
+  {  // Validity.
+    const uint16_t joint_indices[1] = {0};
+    const float in_positions[3] = {1.f, 2.f, 3.f};
+    float out_positions[3];
+    float out_previous_positions[3];
+
+    SkinningJob job;
+    job.vertex_count = 1;
+    job.influences_count = 1;
+    job.joint_matrices = matrices[0];
+    job.joint_indices = joint_indices;
+    job.joint_indices_stride = sizeof(uint16_t);
+    job.in_positions = in_positions;
+    job.in_positions_stride = sizeof(float) * 3;
+    job.out_positions = out_positions;
+    job.out_positions_stride = sizeof(float) * 3;
+    EXPECT_TRUE(job.Validate());
+
+    // Previous palette without output.
+    job.joint_previous_matrices = matrices[1];
+    EXPECT_FALSE(job.Validate());
+
+    // Output too small.
+    job.out_previous_positions = {out_previous_positions, 2};
+    job.out_previous_positions_stride = sizeof(float) * 3;
+    EXPECT_FALSE(job.Validate());
+
+    job.out_previous_positions = out_previous_positions;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+    const ozz::math::SimdFloat4 expected = ozz::math::TransformPoint(
+        matrices[1][0], ozz::math::simd_float4::Load3PtrU(in_positions));
+    EXPECT_FLOAT_EQ(out_previous_positions[0], ozz::math::GetX(expected));
+    EXPECT_FLOAT_EQ(out_previous_positions[1], ozz::math::GetY(expected));
+    EXPECT_FLOAT_EQ(out_previous_positions[2], ozz::math::GetZ(expected));
+
+    // Palette types mismatch.
+    job.joint_previous_matrices = {};
+    job.joint_previous_affine_matrices = affine_matrices[1];
+    EXPECT_FALSE(job.Validate());
+    job.joint_previous_matrices = matrices[1];
+    EXPECT_FALSE(job.Validate());
+
+    // Output without previous palette.
+    job.joint_previous_matrices = {};
+    job.joint_previous_affine_matrices = {};
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
 struct BenchVertexIn {
   float pos[3];
   float normals[3];
@@ -1101,6 +2250,210 @@ struct BenchVertexOut {
   float tangents[3];
 };
 
+namespace {
+// Encodes normalized quaternion _q to a QTangent, with w of the sign of
+// _handedness.
+void EncodeQTangent(ozz::math::SimdFloat4 _q, float _handedness,
+                    int16_t* _out) {
+  float q[4];
+  ozz::math::StorePtrU(_q, q);
+  const float sign = (q[3] < 0.f) != (_handedness < 0.f) ? -1.f : 1.f;
+  for (int i = 0; i < 4; ++i) {
+    _out[i] = static_cast<int16_t>(std::floor(q[i] * sign * 32767.f + .5f));
+  }
+}
+
+// Decodes QTangent _qt to its normal, tangent and handedness.
+void DecodeQTangent(const int16_t* _qt, float* _normal, float* _tangent,
+                    float* _handedness) {
+  const ozz::math::SimdQuaternion q = {ozz::math::Normalize4(
+      ozz::math::simd_float4::Load(_qt[0], _qt[1], _qt[2], _qt[3]))};
+  ozz::math::Store3PtrU(
+      TransformVector(q, ozz::math::simd_float4::z_axis()), _normal);
+  ozz::math::Store3PtrU(
+      TransformVector(q, ozz::math::simd_float4::x_axis()), _tangent);
+  *_handedness = _qt[3] < 0 ? -1.f : 1.f;
+}
+}  // namespace
+
+TEST(QTangents, SkinningJob) {
+  // Rigid transformations, no scale.
+  ozz::math::SimdQuaternion rotations[4] = {
+      {ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, .70710677f)},
+      {ozz::math::simd_float4::w_axis()},
+      {ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, .70710677f)},
+      {ozz::math::simd_float4::Load(-.5f, -.5f, .5f, -.5f)}};
+  const ozz::math::SimdFloat4 translations[4] = {
+      ozz::math::simd_float4::Load(1.f, -2.f, 3.f, 0.f),
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f),
+      ozz::math::simd_float4::zero(),
+      ozz::math::simd_float4::Load(-4.f, 0.f, 2.f, 0.f)};
+  ozz::math::Float4x4 matrices[4];
+  ozz::math::SimdDualQuaternion dual_quaternions[4];
+  for (int i = 0; i < 4; ++i) {
+    matrices[i] = ozz::math::Float4x4::FromAffine(
+        translations[i], rotations[i].xyzw, ozz::math::simd_float4::one());
+    dual_quaternions[i] =
+        ozz::math::SimdDualQuaternion::FromAffine(translations[i],
+                                                  rotations[i]);
+  }
+  const uint16_t joint_indices[10] = {0, 1, 2, 3, 0, 3, 2, 1, 0, 3};
+  const float joint_weights[8] = {.5f, .2f, .1f, .15f, .1f, .25f, .25f, .15f};
+  const float in_positions[6] = {1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+
+  // Tangent frames, the second one being mirrored.
+  int16_t in_qtangents[8];
+  EncodeQTangent(ozz::math::SimdQuaternion::FromAxisAngle(
+                     ozz::math::simd_float4::Load(.26726124f, .53452248f,
+                                                  .80178373f, 0.f),
+                     ozz::math::simd_float4::Load1(.7f))
+                     .xyzw,
+                 1.f, in_qtangents);
+  EncodeQTangent(ozz::math::SimdQuaternion::FromAxisAngle(
+                     ozz::math::simd_float4::y_axis(),
+                     ozz::math::simd_float4::Load1(-2.f))
+                     .xyzw,
+                 -1.f, in_qtangents + 4);
+  float in_normals[6];
+  float in_tangents[6];
+  float in_handedness[2];
+  for (int i = 0; i < 2; ++i) {
+    DecodeQTangent(in_qtangents + i * 4, in_normals + i * 3,
+                   in_tangents + i * 3, &in_handedness[i]);
+  }
+
+  SkinningJob base;
+  base.vertex_count = 2;
+  base.joint_indices = joint_indices;
+  base.joint_indices_stride = sizeof(uint16_t) * 5;
+  base.joint_weights = joint_weights;
+  base.joint_weights_stride = sizeof(float) * 4;
+  base.in_positions = in_positions;
+  base.in_positions_stride = sizeof(float) * 3;
+  base.out_positions_stride = sizeof(float) * 3;
+  base.in_qtangents_stride = sizeof(int16_t) * 4;
+  base.out_qtangents_stride = sizeof(int16_t) * 4;
+
+  {  // Validity.
+    float out_positions[6];
+    int16_t out_qtangents[8];
+    SkinningJob job = base;
+    job.influences_count = 2;
+    job.joint_matrices = matrices;
+    job.out_positions = out_positions;
+    job.in_qtangents = in_qtangents;
+    EXPECT_FALSE(job.Validate());  // No output.
+    job.out_qtangents = {out_qtangents, 7};
+    EXPECT_FALSE(job.Validate());  // Too small.
+    job.out_qtangents = out_qtangents;
+    EXPECT_FALSE(job.Validate());  // No rotations.
+    job.joint_rotations = rotations;
+    EXPECT_TRUE(job.Validate());
+
+    // Not with normals.
+    float out_normals[6];
+    job.in_normals = in_normals;
+    job.in_normals_stride = sizeof(float) * 3;
+    job.out_normals = out_normals;
+    job.out_normals_stride = sizeof(float) * 3;
+    EXPECT_FALSE(job.Validate());
+    job.in_normals = {};
+    job.out_normals = {};
+
+    // Dual quaternions don't need rotations.
+    job.joint_matrices = {};
+    job.joint_dual_quaternions = dual_quaternions;
+    EXPECT_FALSE(job.Validate());
+    job.joint_rotations = {};
+    EXPECT_TRUE(job.Validate());
+
+    // Rotations and output require QTangents.
+    job.in_qtangents = {};
+    EXPECT_FALSE(job.Validate());
+    job.out_qtangents = {};
+    EXPECT_TRUE(job.Validate());
+    job.joint_rotations = rotations;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  for (int influences = 1; influences <= 5; ++influences) {
+    // Reference, dual quaternion skinning of float normals and tangents.
+    float expected_positions[6];
+    float expected_normals[6];
+    float expected_tangents[6];
+    SkinningJob job = base;
+    job.influences_count = influences;
+    job.joint_dual_quaternions = dual_quaternions;
+    job.in_normals = in_normals;
+    job.in_normals_stride = sizeof(float) * 3;
+    job.in_tangents = in_tangents;
+    job.in_tangents_stride = sizeof(float) * 3;
+    job.out_positions = expected_positions;
+    job.out_normals = expected_normals;
+    job.out_normals_stride = sizeof(float) * 3;
+    job.out_tangents = expected_tangents;
+    job.out_tangents_stride = sizeof(float) * 3;
+    ASSERT_TRUE(job.Run());
+
+    // QTangents, skinned with dual quaternions or matrices and rotations.
+    float out_positions[2][6];
+    int16_t out_qtangents[2][8];
+    for (int variant = 0; variant < 2; ++variant) {
+      SkinningJob qjob = base;
+      qjob.influences_count = influences;
+      if (variant == 0) {
+        qjob.joint_dual_quaternions = dual_quaternions;
+      } else {
+        qjob.joint_matrices = matrices;
+        qjob.joint_rotations = rotations;
+      }
+      qjob.in_qtangents = in_qtangents;
+      qjob.out_positions = out_positions[variant];
+      qjob.out_qtangents = out_qtangents[variant];
+      ASSERT_TRUE(qjob.Run());
+    }
+
+    for (int i = 0; i < 2; ++i) {
+      float normal[3], tangent[3], handedness;
+      DecodeQTangent(out_qtangents[0] + i * 4, normal, tangent, &handedness);
+      EXPECT_EQ(handedness, in_handedness[i]);
+      for (int k = 0; k < 3; ++k) {
+        EXPECT_NEAR(normal[k], expected_normals[i * 3 + k], 2e-4f)
+            << "influences " << influences;
+        EXPECT_NEAR(tangent[k], expected_tangents[i * 3 + k], 2e-4f)
+            << "influences " << influences;
+        EXPECT_EQ(out_positions[0][i * 3 + k], expected_positions[i * 3 + k]);
+      }
+    }
+
+    // Rotations palette gives the same QTangents as dual quaternions.
+    for (int i = 0; i < 8; ++i) {
+      EXPECT_EQ(out_qtangents[0][i], out_qtangents[1][i]);
+    }
+  }
+
+  {  // w is biased so that handedness isn't lost.
+    const uint16_t identity_indices[1] = {1};
+    const int16_t mirrored[4] = {32767, 0, 0, -1};
+    float out_positions[3];
+    int16_t out_qtangents[4];
+    SkinningJob job = base;
+    job.vertex_count = 1;
+    job.influences_count = 1;
+    job.joint_indices = identity_indices;
+    job.joint_indices_stride = sizeof(uint16_t);
+    job.joint_dual_quaternions = dual_quaternions;
+    job.in_qtangents = mirrored;
+    job.out_positions = out_positions;
+    job.out_qtangents = out_qtangents;
+    ASSERT_TRUE(job.Run());
+    EXPECT_EQ(out_qtangents[0], 32767);
+    EXPECT_EQ(out_qtangents[1], 0);
+    EXPECT_EQ(out_qtangents[2], 0);
+    EXPECT_EQ(out_qtangents[3], -1);
+  }
+}
+
 TEST(Benchmark, SkinningJob) {
   const int vertex_count = 10000;
   const int joint_count = 100;
@@ -0,0 +1,378 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/geometry/runtime/skinning_palette_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+
+using ozz::geometry::SkinningPaletteJob;
+
+TEST(JobValidity, SkinningPaletteJob) {
+  ozz::math::Float4x4 models[3];
+  ozz::math::Float4x4 inv_binds[2];
+  ozz::math::Float4x4 output[2];
+  ozz::math::Float4x4 it_output[2];
+  ozz::math::Float3x4 affine_output[2];
+  ozz::math::Float3x4 affine_it_output[2];
+  const uint16_t remaps[2] = {2, 0};
+  const uint16_t invalid_remaps[2] = {3, 0};
+
+  {  // Default is invalid.
+    SkinningPaletteJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Valid empty palette.
+    SkinningPaletteJob job;
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Valid.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Valid, with inverse transpose.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    job.inverse_transpose_output = it_output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Valid, affine with inverse transpose.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.inverse_bind_poses = inv_binds;
+    job.affine_output = affine_output;
+    job.affine_inverse_transpose_output = affine_it_output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Invalid, both outputs.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    job.affine_output = affine_output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Invalid, mismatching inverse transpose type.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    job.affine_inverse_transpose_output = affine_it_output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Invalid, mismatching inverse transpose type.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.inverse_bind_poses = inv_binds;
+    job.affine_output = affine_output;
+    job.inverse_transpose_output = it_output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Invalid, output too small.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.inverse_bind_poses = inv_binds;
+    job.output = {output, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Invalid, inverse transpose output too small.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    job.inverse_transpose_output = {it_output, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Invalid, model matrices too small.
+    SkinningPaletteJob job;
+    job.model_matrices = {models, 1};
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Valid, with remaps.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.joint_remaps = remaps;
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+  {  // Invalid, remaps too small.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.joint_remaps = {remaps, 1};
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+  {  // Invalid, remaps out of model matrices range.
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.joint_remaps = invalid_remaps;
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+}
+
+TEST(Run, SkinningPaletteJob) {
+  const ozz::math::Float4x4 models[3] = {
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f)),
+      ozz::math::Float4x4::Scaling(
+          ozz::math::simd_float4::Load(2.f, 4.f, 8.f, 0.f)),
+      ozz::math::Float4x4::identity()};
+  const ozz::math::Float4x4 inv_binds[3] = {
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(-1.f, 0.f, 0.f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(0.f, -1.f, 0.f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(0.f, 0.f, -1.f, 0.f))};
+  const uint16_t remaps[3] = {2, 1, 0};
+
+  {  // Without remaps.
+    ozz::math::Float4x4 output[3];
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    ASSERT_TRUE(job.Run());
+
+    EXPECT_FLOAT4x4_EQ(output[0], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                       0.f, 1.f, 0.f, 0.f, 2.f, 3.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(output[1], 2.f, 0.f, 0.f, 0.f, 0.f, 4.f, 0.f, 0.f, 0.f,
+                       0.f, 8.f, 0.f, 0.f, -4.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(output[2], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                       0.f, 1.f, 0.f, 0.f, 0.f, -1.f, 1.f);
+  }
+
+  {  // With remaps and inverse transpose.
+    ozz::math::Float4x4 output[3];
+    ozz::math::Float4x4 it_output[3];
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.joint_remaps = remaps;
+    job.inverse_bind_poses = inv_binds;
+    job.output = output;
+    job.inverse_transpose_output = it_output;
+    ASSERT_TRUE(job.Run());
+
+    EXPECT_FLOAT4x4_EQ(output[0], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                       0.f, 1.f, 0.f, -1.f, 0.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(output[1], 2.f, 0.f, 0.f, 0.f, 0.f, 4.f, 0.f, 0.f, 0.f,
+                       0.f, 8.f, 0.f, 0.f, -4.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(output[2], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                       0.f, 1.f, 0.f, 1.f, 2.f, 2.f, 1.f);
+
+    EXPECT_FLOAT4x4_EQ(it_output[0], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+                       0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(it_output[1], .5f, 0.f, 0.f, 0.f, 0.f, .25f, 0.f, 0.f,
+                       0.f, 0.f, .125f, 0.f, 0.f, 0.f, 0.f, 1.f);
+    EXPECT_FLOAT4x4_EQ(it_output[2], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+                       0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f);
+  }
+
+  {  // Affine, with remaps and inverse transpose.
+    ozz::math::Float3x4 output[3];
+    ozz::math::Float3x4 it_output[3];
+    SkinningPaletteJob job;
+    job.model_matrices = models;
+    job.joint_remaps = remaps;
+    job.inverse_bind_poses = inv_binds;
+    job.affine_output = output;
+    job.affine_inverse_transpose_output = it_output;
+    ASSERT_TRUE(job.Run());
+
+    EXPECT_FLOAT3x4_EQ(output[0], 1.f, 0.f, 0.f, -1.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                       0.f, 1.f, 0.f);
+    EXPECT_FLOAT3x4_EQ(output[1], 2.f, 0.f, 0.f, 0.f, 0.f, 4.f, 0.f, -4.f, 0.f,
+                       0.f, 8.f, 0.f);
+    EXPECT_FLOAT3x4_EQ(output[2], 1.f, 0.f, 0.f, 1.f, 0.f, 1.f, 0.f, 2.f, 0.f,
+                       0.f, 1.f, 2.f);
+
+    EXPECT_FLOAT3x4_EQ(it_output[1], .5f, 0.f, 0.f, 0.f, 0.f, .25f, 0.f, 0.f,
+                       0.f, 0.f, .125f, 0.f);
+  }
+}
+
+TEST(InverseTranspose, SkinningPaletteJob) {
+  // Rotated, non-uniformly scaled and translated matrix.
+  const ozz::math::Float4x4 models[1] = {
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(4.f, -5.f, 6.f, 0.f)) *
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(.3f, -.7f, 1.1f, 0.f)) *
+      ozz::math::Float4x4::Scaling(
+          ozz::math::simd_float4::Load(3.f, .5f, 2.f, 0.f))};
+  const ozz::math::Float4x4 inv_binds[1] = {ozz::math::Float4x4::FromEuler(
+      ozz::math::simd_float4::Load(-.2f, .9f, .4f, 0.f))};
+
+  ozz::math::Float4x4 output[1];
+  ozz::math::Float4x4 it_output[1];
+  SkinningPaletteJob job;
+  job.model_matrices = models;
+  job.inverse_bind_poses = inv_binds;
+  job.output = output;
+  job.inverse_transpose_output = it_output;
+  ASSERT_TRUE(job.Run());
+
+  // Compares with the upper 3x3 part of the generic inverse transpose.
+  const ozz::math::Float4x4 expected =
+      ozz::math::Transpose(ozz::math::Invert(models[0] * inv_binds[0]));
+  for (int i = 0; i < 4; ++i) {
+    float values[4];
+    ozz::math::StorePtrU(expected.cols[i], values);
+    values[3] = i == 3 ? 1.f : 0.f;
+    if (i == 3) {
+      values[0] = values[1] = values[2] = 0.f;
+    }
+    EXPECT_SIMDFLOAT_EQ(it_output[0].cols[i], values[0], values[1], values[2],
+                        values[3]);
+  }
+}
+
+TEST(DualQuaternions, SkinningPaletteJob) {
+  const ozz::math::Float4x4 models[2] = {
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(4.f, -5.f, 6.f, 0.f)) *
+          ozz::math::Float4x4::FromEuler(
+              ozz::math::simd_float4::Load(.3f, -.7f, 1.1f, 0.f)),
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(2.f, .1f, -1.f, 0.f))};
+  const ozz::math::Float4x4 inv_binds[2] = {
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(-.2f, .9f, .4f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(-1.f, 2.f, 0.f, 0.f))};
+  const uint16_t remaps[2] = {1, 0};
+
+  ozz::math::Float4x4 output[2];
+  ozz::math::SimdDualQuaternion dq_output[2];
+  SkinningPaletteJob job;
+  job.model_matrices = models;
+  job.joint_remaps = remaps;
+  job.inverse_bind_poses = inv_binds;
+  job.output = output;
+  ASSERT_TRUE(job.Run());
+
+  job.output = {};
+  job.dual_quaternion_output = dq_output;
+  ASSERT_TRUE(job.Run());
+
+  // Dual quaternions and matrices transform points and vectors the same way.
+  const ozz::math::SimdFloat4 point =
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 1.f);
+  for (int i = 0; i < 2; ++i) {
+    float expected[2][4];
+    ozz::math::StorePtrU(TransformPoint(output[i], point), expected[0]);
+    ozz::math::StorePtrU(TransformVector(output[i], point), expected[1]);
+    EXPECT_SIMDFLOAT3_EQ(TransformPoint(dq_output[i], point), expected[0][0],
+                         expected[0][1], expected[0][2]);
+    EXPECT_SIMDFLOAT3_EQ(TransformVector(dq_output[i], point), expected[1][0],
+                         expected[1][1], expected[1][2]);
+  }
+
+  // Dual quaternions have no inverse transpose.
+  ozz::math::Float4x4 it_output[2];
+  job.inverse_transpose_output = it_output;
+  EXPECT_FALSE(job.Validate());
+  job.inverse_transpose_output = {};
+
+  // Only one output type.
+  job.output = output;
+  EXPECT_FALSE(job.Validate());
+}
+
+TEST(Rotations, SkinningPaletteJob) {
+  const ozz::math::Float4x4 models[2] = {
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(4.f, -5.f, 6.f, 0.f)) *
+          ozz::math::Float4x4::FromEuler(
+              ozz::math::simd_float4::Load(.3f, -.7f, 1.1f, 0.f)),
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(2.f, .1f, -1.f, 0.f)) *
+          ozz::math::Float4x4::Scaling(
+              ozz::math::simd_float4::Load(2.f, 2.f, 2.f, 0.f))};
+  const ozz::math::Float4x4 inv_binds[2] = {
+      ozz::math::Float4x4::FromEuler(
+          ozz::math::simd_float4::Load(-.2f, .9f, .4f, 0.f)),
+      ozz::math::Float4x4::Translation(
+          ozz::math::simd_float4::Load(-1.f, 2.f, 0.f, 0.f))};
+
+  ozz::math::Float3x4 output[2];
+  ozz::math::SimdDualQuaternion dq_output[2];
+  ozz::math::SimdQuaternion rotations[2];
+  SkinningPaletteJob job;
+  job.model_matrices = models;
+  job.inverse_bind_poses = inv_binds;
+  job.affine_output = output;
+  job.rotation_output = rotations;
+  ASSERT_TRUE(job.Run());
+
+  // Too small.
+  job.rotation_output = {rotations, 1};
+  EXPECT_FALSE(job.Validate());
+
+  // Computes dual quaternions to compare rotations with their real part.
+  job.affine_output = {};
+  job.dual_quaternion_output = dq_output;
+  job.rotation_output = {};
+  ASSERT_TRUE(job.Run());
+
+  // Rotations are dual quaternions real part, even with scale.
+  for (int i = 0; i < 2; ++i) {
+    float expected_rotation[4];
+    ozz::math::StorePtrU(dq_output[i].real.xyzw, expected_rotation);
+    EXPECT_SIMDQUATERNION_EQ(rotations[i], expected_rotation[0],
+                             expected_rotation[1], expected_rotation[2],
+                             expected_rotation[3]);
+  }
+}